@@ -15,13 +15,35 @@
  ******************************************************************************/
 
 #include "version/version.hpp"
+#include "tracing/tracing.hpp"
+#include "shard/shard.coordinator.hpp"
 #include "mmbot.application.hpp"
 
+namespace
+{
+    std::unique_ptr<antara::mmbot::price_service_platform>
+    create_price_service(std::optional<std::size_t> shard_worker)
+    {
+        using namespace antara::mmbot;
+        if (!shard_worker.has_value()) {
+            return std::make_unique<price_service_platform>();
+        }
+        const auto &cfg = get_mmbot_config();
+        auto price_service = std::make_unique<price_service_platform>(
+                std::make_unique<shard::price_subscriber>(cfg.shard.price_socket_path));
+        price_service->set_pair_filter(
+                [ring = shard::make_ring(cfg), worker = shard_worker.value()](const antara::pair &pair) {
+                    return ring.owns(worker, pair);
+                });
+        return price_service;
+    }
+}
+
 namespace antara::mmbot
 {
     int application::run()
     {
-        this->price_service_.enable_price_service_thread();
+        this->price_service_->enable_price_service_thread();
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
         VLOG_SCOPE_F(loguru::Verbosity_INFO, "launching antara-mmbot version: %s", version());
         try {
@@ -34,13 +56,46 @@ namespace antara::mmbot
         return 0;
     }
 
-    application::application() noexcept
+    application::application(std::optional<std::size_t> shard_worker) noexcept :
+            price_service_(create_price_service(shard_worker)),
+            config_subscription_(subscribe_mmbot_config([](const config &previous, const config &current) {
+                if (previous.tracing_enabled != current.tracing_enabled) {
+                    tracing::set_enabled(current.tracing_enabled);
+                }
+            }))
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        tracing::set_enabled(get_mmbot_config().tracing_enabled);
+        if (const auto &tick_store_path = get_mmbot_config().tick_store_path; tick_store_path.has_value()) {
+            try {
+                recorder_ = std::make_unique<tickstore::tick_recorder>(tick_store_path.value());
+                recorder_->attach(*price_service_);
+                recorder_->attach(mm2_client_);
+            }
+            catch (const std::exception &e) {
+                VLOG_F(loguru::Verbosity_ERROR, "tick recording disabled: %s", e.what());
+            }
+        }
+        //! the coordinator publishes the bus of a sharded bot, the workers have the same prices.
+        if (const auto &price_bus_path = get_mmbot_config().price_bus_path;
+                price_bus_path.has_value() && !shard_worker.has_value()) {
+            try {
+                price_bus_ = std::make_unique<price_bus_writer>(price_bus_path.value(),
+                                                                get_mmbot_config().price_bus_capacity);
+                price_service_->add_price_observer([bus = price_bus_.get()](const antara::pair &pair, st_price price) {
+                    bus->publish(pair, price);
+                });
+            }
+            catch (const std::exception &e) {
+                VLOG_F(loguru::Verbosity_ERROR, "price bus disabled: %s", e.what());
+            }
+        }
     }
 
     application::~application() noexcept
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        config_watcher_.stop();
+        unsubscribe_mmbot_config(config_subscription_);
     }
 }
\ No newline at end of file
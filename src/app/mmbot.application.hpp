@@ -16,19 +16,29 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <config/config.watcher.hpp>
 #include <http/http.server.hpp>
+#include <price/price.bus.hpp>
+#include <tickstore/tick.recorder.hpp>
 
 namespace antara::mmbot
 {
     class application
     {
     public:
-        application() noexcept;
+        //! a shard worker takes its prices from the coordinator and fetches only the pairs the ring gives it.
+        explicit application(std::optional<std::size_t> shard_worker = std::nullopt) noexcept;
         ~application() noexcept;
         int run();
     private:
-        price_service_platform price_service_;
+        std::unique_ptr<tickstore::tick_recorder> recorder_;
+        std::unique_ptr<price_bus_writer> price_bus_;
+        std::unique_ptr<price_service_platform> price_service_;
         mm2_client mm2_client_;
-        antara::mmbot::http_server server_{price_service_, mm2_client_};
+        antara::mmbot::http_server server_{*price_service_, mm2_client_};
+        std::size_t config_subscription_;
+        config_watcher config_watcher_{std::filesystem::current_path() / "assets", "mmbot_config.json"};
     };
 }
\ No newline at end of file
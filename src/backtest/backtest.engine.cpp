@@ -0,0 +1,286 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <cex/cex.simulated.hpp>
+#include <dex/dex.simulated.hpp>
+#include <order_manager/order.manager.hpp>
+#include <utils/antara.algorithm.hpp>
+#include "backtest.engine.hpp"
+
+namespace
+{
+    std::optional<absl::uint128> parse_integer(const std::string &str)
+    {
+        if (str.empty()) {
+            return std::nullopt;
+        }
+        absl::uint128 value = 0;
+        for (char cur_char : str) {
+            if (cur_char < '0' || cur_char > '9') {
+                return std::nullopt;
+            }
+            value *= 10;
+            value += static_cast<absl::uint128>(cur_char - '0');
+        }
+        return value;
+    }
+
+    std::optional<antara::pair> parse_pair(const std::string &str)
+    {
+        auto pos = str.find('/');
+        if (pos == std::string::npos || pos == 0 || pos + 1 == str.size()) {
+            return std::nullopt;
+        }
+        return antara::pair::of(str.substr(pos + 1), str.substr(0, pos));
+    }
+
+    antara::side side_from_string(const std::string &side)
+    {
+        if (side == "buy") {
+            return antara::side::buy;
+        }
+        if (side == "sell") {
+            return antara::side::sell;
+        }
+        return antara::side::both;
+    }
+}
+
+namespace antara::mmbot::backtest
+{
+    std::optional<market_tick> parse_tick_line(const std::string &line)
+    {
+        std::istringstream ss(line);
+        long long timestamp = 0;
+        std::string pair_str, price_str;
+        if (!(ss >> timestamp >> pair_str >> price_str)) {
+            return std::nullopt;
+        }
+        auto pair = parse_pair(pair_str);
+        auto price = parse_integer(price_str);
+        if (!pair.has_value() || !price.has_value()) {
+            return std::nullopt;
+        }
+        market_tick tick{std::chrono::microseconds{timestamp}, pair.value(), st_price{price.value()}};
+        std::string bid_str, ask_str;
+        double bid_quantity = 0.0, ask_quantity = 0.0;
+        if (ss >> bid_str >> bid_quantity >> ask_str >> ask_quantity) {
+            auto bid = parse_integer(bid_str);
+            auto ask = parse_integer(ask_str);
+            if (bid.has_value() && ask.has_value()) {
+                tick.book = book_top{st_price{bid.value()}, st_quantity{bid_quantity},
+                                     st_price{ask.value()}, st_quantity{ask_quantity}};
+            }
+        }
+        return tick;
+    }
+
+    std::vector<market_tick> load_ticks(const std::filesystem::path &path)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        if (tickstore::is_tick_store(path)) {
+            return load_ticks(tickstore::tick_store_reader(path));
+        }
+        std::ifstream ifs(path);
+        DCHECK_F(ifs.is_open(), "Failed to open: [%s]", path.string().c_str());
+        std::vector<market_tick> ticks;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+            if (auto tick = parse_tick_line(line); tick.has_value()) {
+                ticks.push_back(std::move(tick.value()));
+            } else {
+                VLOG_F(loguru::Verbosity_WARNING, "skipping malformed tick: %s", line.c_str());
+            }
+        }
+        return ticks;
+    }
+
+    std::vector<market_tick> load_ticks(const tickstore::tick_store_reader &reader)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        std::vector<market_tick> ticks;
+        ticks.reserve(reader.nb_ticks());
+        reader.for_each([&reader, &ticks](const tickstore::tick_block_view &block, std::size_t row) {
+            market_tick tick{block.timestamp(row), reader.pair_of(block.pair(row)), block.price(row)};
+            if (block.has_book(row)) {
+                auto book = block.book(row);
+                if (book.nb_bids() > 0 && book.nb_asks() > 0) {
+                    auto bid = book.bid(0);
+                    auto ask = book.ask(0);
+                    tick.book = book_top{bid.price, bid.quantity, ask.price, ask.quantity};
+                }
+            }
+            ticks.push_back(std::move(tick));
+        });
+        return ticks;
+    }
+
+    backtest_report run_backtest(const std::vector<market_tick> &ticks, const backtest_parameters &parameters)
+    {
+        simulation::matching_engine engine(parameters.latency, parameters.fill, parameters.seed);
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex);
+        replay_price_service ps;
+        strategy_manager<replay_price_service> sm(ps, om);
+        for (auto &&strat : parameters.strategies) {
+            sm.add_strategy(strat);
+        }
+
+        backtest_report report;
+        if (ticks.empty()) {
+            return report;
+        }
+
+        const auto origin = ticks.front().timestamp;
+        std::unordered_map<antara::pair, simulation::sim_time_point> last_refresh;
+        std::unordered_map<antara::pair, st_price> last_prices;
+        for (auto &&tick : ticks) {
+            auto elapsed = std::chrono::duration_cast<simulation::sim_duration>(tick.timestamp - origin);
+            if (elapsed > engine.now()) {
+                engine.advance(elapsed - engine.now());
+            }
+
+            //! The market moves first and trades against the quotes that are still resting, then we requote.
+            if (tick.book.has_value()) {
+                const auto &book = tick.book.value();
+                engine.take(tick.pair, antara::side::buy, book.best_bid, book.bid_quantity);
+                engine.take(tick.pair, antara::side::sell, book.best_ask, book.ask_quantity);
+            } else {
+                engine.take(tick.pair, antara::side::buy, tick.price, parameters.taker_quantity_per_tick);
+                engine.take(tick.pair, antara::side::sell, tick.price, parameters.taker_quantity_per_tick);
+            }
+            om.poll();
+
+            ps.update(tick.pair, tick.price);
+            sm.on_price_tick(tick.pair, tick.price, volatility_estimator::clock::time_point{engine.now()});
+            last_prices.insert_or_assign(tick.pair, tick.price);
+            if (sm.get_strategies().count(tick.pair) > 0) {
+                auto refresh_it = last_refresh.find(tick.pair);
+                if (refresh_it == last_refresh.end() ||
+                    engine.now() - refresh_it->second >= parameters.refresh_interval) {
+                    sm.refresh_orders(tick.pair);
+                    last_refresh.insert_or_assign(tick.pair, engine.now());
+                }
+            }
+            ++report.nb_ticks;
+        }
+
+        for (auto &&ex : engine.get_executions()) {
+            auto &current = report.pairs[ex.pair];
+            const double quantity = ex.quantity.value();
+            const double notional = static_cast<double>(ex.price.value()) * quantity;
+            if (ex.side == antara::side::buy) {
+                current.inventory += quantity;
+                current.cash -= notional;
+            } else {
+                current.inventory -= quantity;
+                current.cash += notional;
+            }
+            current.traded_quantity += quantity;
+            ++current.nb_executions;
+        }
+
+        for (auto &&[pair, current] : report.pairs) {
+            current.pnl = current.cash + current.inventory * static_cast<double>(last_prices.at(pair).value());
+            report.pnl += current.pnl;
+        }
+
+        const auto &stats = engine.get_stats();
+        report.nb_orders_placed = stats.nb_orders_placed;
+        report.nb_orders_filled = stats.nb_orders_filled;
+        report.nb_executions = stats.nb_executions;
+        if (stats.nb_orders_placed > 0) {
+            report.fill_rate = static_cast<double>(stats.nb_orders_filled) / static_cast<double>(stats.nb_orders_placed);
+        }
+        return report;
+    }
+
+    std::vector<backtest_report>
+    run_backtests(const std::vector<market_tick> &ticks, const std::vector<backtest_parameters> &parameter_sets)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        std::vector<backtest_report> reports(parameter_sets.size());
+        std::vector<std::size_t> indexes(parameter_sets.size());
+        std::iota(indexes.begin(), indexes.end(), 0u);
+        antara::par_for_each(indexes.begin(), indexes.end(), [&ticks, &parameter_sets, &reports](std::size_t idx) {
+            reports[idx] = run_backtest(ticks, parameter_sets[idx]);
+        });
+        return reports;
+    }
+
+    void from_json(const nlohmann::json &j, backtest_parameters &parameters)
+    {
+        for (auto &&current_strat : j.at("strategies")) {
+            market_making_strategy strat{
+                    antara::pair::of(current_strat.at("quote").get<std::string>(),
+                                     current_strat.at("base").get<std::string>()),
+                    st_spread{current_strat.at("spread").get<double>()},
+                    st_quantity{current_strat.at("quantity").get<double>()},
+                    side_from_string(current_strat.value("side", "both"))};
+            if (current_strat.value("spread_mode", "fixed") == "volatility") {
+                strat.mode = spread_mode::volatility;
+            }
+            strat.volatility_multiplier = current_strat.value("volatility_multiplier", strat.volatility_multiplier);
+            if (current_strat.count("min_spread") > 0) {
+                strat.min_spread = st_spread{current_strat.at("min_spread").get<double>()};
+            }
+            if (current_strat.count("max_spread") > 0) {
+                strat.max_spread = st_spread{current_strat.at("max_spread").get<double>()};
+            }
+            strat.reprice_threshold_ticks = current_strat.value("reprice_threshold_ticks", std::size_t{0});
+            parameters.strategies.push_back(strat);
+        }
+        if (j.find("latency") != j.end()) {
+            const auto &latency = j.at("latency");
+            parameters.latency.place_latency = simulation::sim_duration{latency.value("place_us", 0ll)};
+            parameters.latency.cancel_latency = simulation::sim_duration{latency.value("cancel_us", 0ll)};
+            parameters.latency.jitter = simulation::sim_duration{latency.value("jitter_us", 0ll)};
+        }
+        if (j.find("fill") != j.end()) {
+            parameters.fill.fill_probability = j.at("fill").value("probability", 1.0);
+            parameters.fill.max_fill_ratio = j.at("fill").value("max_ratio", 1.0);
+        }
+        parameters.taker_quantity_per_tick = st_quantity{j.value("taker_quantity_per_tick", 1.0)};
+        parameters.refresh_interval = std::chrono::microseconds{j.value("refresh_interval_us", 0ll)};
+        parameters.seed = j.value("seed", std::uint64_t{42});
+    }
+
+    void to_json(nlohmann::json &j, const backtest_report &report)
+    {
+        j["nb_ticks"] = report.nb_ticks;
+        j["nb_orders_placed"] = report.nb_orders_placed;
+        j["nb_orders_filled"] = report.nb_orders_filled;
+        j["nb_executions"] = report.nb_executions;
+        j["fill_rate"] = report.fill_rate;
+        j["pnl"] = report.pnl;
+        j["pairs"] = nlohmann::json::object();
+        for (auto &&[pair, current] : report.pairs) {
+            j["pairs"][pair.base.symbol.value() + "/" + pair.quote.symbol.value()] = {
+                    {"inventory",       current.inventory},
+                    {"cash",            current.cash},
+                    {"pnl",             current.pnl},
+                    {"traded_quantity", current.traded_quantity},
+                    {"nb_executions",   current.nb_executions}};
+        }
+    }
+}
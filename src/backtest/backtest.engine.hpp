@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+#include <simulation/matching.engine.hpp>
+#include <strategy_manager/strategy.manager.hpp>
+#include <tickstore/tick.store.hpp>
+#include "replay.price.service.hpp"
+
+namespace antara::mmbot::backtest
+{
+    struct book_top
+    {
+        st_price best_bid;
+        st_quantity bid_quantity;
+        st_price best_ask;
+        st_quantity ask_quantity;
+    };
+
+    struct market_tick
+    {
+        std::chrono::microseconds timestamp;
+        antara::pair pair;
+        st_price price;
+        std::optional<book_top> book{std::nullopt};
+    };
+
+    struct backtest_parameters
+    {
+        std::vector<market_making_strategy> strategies;
+        simulation::latency_model latency{};
+        simulation::fill_model fill{};
+        st_quantity taker_quantity_per_tick{1.0};
+        std::chrono::microseconds refresh_interval{0};
+        std::uint64_t seed{42};
+    };
+
+    struct pair_report
+    {
+        double inventory{0.0};
+        double cash{0.0};
+        double pnl{0.0};
+        double traded_quantity{0.0};
+        std::size_t nb_executions{0};
+    };
+
+    struct backtest_report
+    {
+        std::size_t nb_ticks{0};
+        std::size_t nb_orders_placed{0};
+        std::size_t nb_orders_filled{0};
+        std::size_t nb_executions{0};
+        double fill_rate{0.0};
+        double pnl{0.0};
+        std::unordered_map<antara::pair, pair_report> pairs;
+    };
+
+    /**
+     * @brief Parse one recorded tick, the format is `<timestamp_us> <BASE/QUOTE> <price>` optionally followed by
+     *        `<best_bid> <bid_quantity> <best_ask> <ask_quantity>`. Prices are the integer representation used by st_price.
+     */
+    std::optional<market_tick> parse_tick_line(const std::string &line);
+
+    //! Load a text file of ticks or a binary tick store, the format is detected from the file header.
+    std::vector<market_tick> load_ticks(const std::filesystem::path &path);
+
+    //! Replay ticks straight from a mapped tick store, books are reduced to their top level.
+    std::vector<market_tick> load_ticks(const tickstore::tick_store_reader &reader);
+
+    backtest_report run_backtest(const std::vector<market_tick> &ticks, const backtest_parameters &parameters);
+
+    std::vector<backtest_report>
+    run_backtests(const std::vector<market_tick> &ticks, const std::vector<backtest_parameters> &parameter_sets);
+
+    void from_json(const nlohmann::json &j, backtest_parameters &parameters);
+
+    void to_json(nlohmann::json &j, const backtest_report &report);
+}
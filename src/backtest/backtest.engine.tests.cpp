@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+#include "backtest.engine.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("recorded ticks can be parsed")
+    {
+        auto tick = backtest::parse_tick_line("1000 KMD/BTC 12345");
+        REQUIRE(tick.has_value());
+        CHECK_EQ(std::chrono::microseconds{1000}, tick.value().timestamp);
+        CHECK_EQ(antara::pair::of("BTC", "KMD"), tick.value().pair);
+        CHECK_EQ(st_price{12345}, tick.value().price);
+        CHECK_FALSE(tick.value().book.has_value());
+
+        tick = backtest::parse_tick_line("1000 KMD/BTC 12345 12300 5.5 12400 4");
+        REQUIRE(tick.has_value());
+        REQUIRE(tick.value().book.has_value());
+        CHECK_EQ(st_price{12300}, tick.value().book.value().best_bid);
+        CHECK_EQ(st_quantity{4}, tick.value().book.value().ask_quantity);
+
+        CHECK_FALSE(backtest::parse_tick_line("1000 KMDBTC 12345").has_value());
+        CHECK_FALSE(backtest::parse_tick_line("1000 KMD/BTC 12.5").has_value());
+    }
+
+    TEST_CASE ("a backtest replays ticks through the strategy and reports pnl and inventory")
+    {
+        auto pair = antara::pair::of("B", "A");
+        std::vector<backtest::market_tick> ticks{
+                {std::chrono::microseconds{0}, pair, st_price{100}},
+                {std::chrono::microseconds{10}, pair, st_price{120}},
+                {std::chrono::microseconds{20}, pair, st_price{100}}};
+
+        backtest::backtest_parameters parameters;
+        parameters.strategies.push_back(market_making_strategy{pair, st_spread{0.1}, st_quantity{10}, antara::side::both});
+
+        auto report = backtest::run_backtest(ticks, parameters);
+        CHECK_EQ(3, report.nb_ticks);
+        CHECK_EQ(6, report.nb_orders_placed);
+        CHECK_EQ(2, report.nb_executions);
+        CHECK_EQ(0, report.nb_orders_filled);
+        REQUIRE_EQ(1, report.pairs.size());
+        CHECK_EQ(doctest::Approx(0.0), report.pairs.at(pair).inventory);
+        CHECK_EQ(doctest::Approx(2.0), report.pairs.at(pair).pnl);
+        CHECK_EQ(doctest::Approx(2.0), report.pnl);
+    }
+
+    TEST_CASE ("several parameter sets can be backtested at once")
+    {
+        auto pair = antara::pair::of("B", "A");
+        std::vector<backtest::market_tick> ticks{
+                {std::chrono::microseconds{0}, pair, st_price{100}},
+                {std::chrono::microseconds{10}, pair, st_price{120}}};
+
+        auto parameters = R"({
+  "strategies": [{"base": "A", "quote": "B", "spread": 0.1, "quantity": 10, "side": "sell"}],
+  "taker_quantity_per_tick": 2
+})"_json.get<backtest::backtest_parameters>();
+        auto wide = parameters;
+        wide.strategies.front().spread = st_spread{0.5};
+
+        auto reports = backtest::run_backtests(ticks, {parameters, wide});
+        REQUIRE_EQ(2, reports.size());
+        CHECK_EQ(1, reports[0].nb_executions);
+        CHECK_EQ(doctest::Approx(-2.0), reports[0].pairs.at(pair).inventory);
+        CHECK_EQ(0, reports[1].nb_executions);
+    }
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include "backtest/backtest.engine.hpp"
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <ticks_file> <parameter_sets.json>\n";
+        return 1;
+    }
+    loguru::set_thread_name("backtest thread");
+    using namespace antara::mmbot;
+    auto ticks = backtest::load_ticks(argv[1]);
+    std::ifstream ifs(argv[2]);
+    if (!ifs.is_open()) {
+        std::cerr << "cannot open: " << argv[2] << "\n";
+        return 1;
+    }
+    nlohmann::json parameters_json;
+    ifs >> parameters_json;
+    auto parameter_sets = parameters_json.get<std::vector<backtest::backtest_parameters>>();
+    auto reports = backtest::run_backtests(ticks, parameter_sets);
+    nlohmann::json reports_json = reports;
+    std::cout << reports_json.dump(4) << std::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <unordered_map>
+#include <price/exceptions.price.platform.hpp>
+#include <utils/mmbot_strong_types.hpp>
+
+namespace antara::mmbot
+{
+    //! Price service fed by recorded ticks, satisfies the PS requirements of strategy_manager.
+    class replay_price_service
+    {
+    public:
+        st_price get_price(antara::pair currency_pair) const
+        {
+            auto it = prices_.find(currency_pair);
+            if (it == prices_.end()) {
+                throw errors::pair_not_available();
+            }
+            return it->second;
+        }
+
+        void update(const antara::pair &currency_pair, st_price price)
+        {
+            prices_.insert_or_assign(currency_pair, price);
+        }
+
+    private:
+        std::unordered_map<antara::pair, st_price> prices_;
+    };
+}
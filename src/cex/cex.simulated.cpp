@@ -0,0 +1,44 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "cex.simulated.hpp"
+
+namespace antara::mmbot
+{
+    void simulated_cex::place_order(const orders::order_level &ol)
+    {
+        placed_orders_.push_back(ol);
+    }
+
+    void simulated_cex::mirror(const orders::execution &ex)
+    {
+        auto hedge = ex;
+        hedge.id = "hedge-" + ex.id;
+        hedge.side = ex.side == antara::side::buy ? antara::side::sell : antara::side::buy;
+        hedge.maker = false;
+        mirrored_executions_.push_back(std::move(hedge));
+    }
+
+    const std::vector<orders::order_level> &simulated_cex::get_placed_orders() const noexcept
+    {
+        return placed_orders_;
+    }
+
+    const std::vector<orders::execution> &simulated_cex::get_mirrored_executions() const noexcept
+    {
+        return mirrored_executions_;
+    }
+}
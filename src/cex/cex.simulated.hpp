@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "cex.hpp"
+
+namespace antara::mmbot
+{
+    //! Records hedges instead of sending them, the mirrored execution is the opposite side of the dex fill.
+    class simulated_cex : public abstract_cex
+    {
+    public:
+        void place_order(const orders::order_level &ol) override;
+        void mirror(const orders::execution &ex) override;
+
+        [[nodiscard]] const std::vector<orders::order_level> &get_placed_orders() const noexcept;
+        [[nodiscard]] const std::vector<orders::execution> &get_mirrored_executions() const noexcept;
+
+    private:
+        std::vector<orders::order_level> placed_orders_;
+        std::vector<orders::execution> mirrored_executions_;
+    };
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include "config/coin.scale.table.hpp"
+
+namespace
+{
+    constexpr std::size_t nb_pow10 = 39;
+}
+
+namespace antara::mmbot
+{
+    coin_id coin_scale_table::add(const std::string &symbol, std::size_t nb_decimals, bool is_mm2_compatible,
+                                  bool is_electrum_compatible)
+    {
+        if (nb_decimals >= nb_pow10) {
+            throw std::invalid_argument(symbol + " has too many decimals for a 128 bits price");
+        }
+        coin_scale scale{nb_decimals, antara::pow10_u128(nb_decimals), is_mm2_compatible, is_electrum_compatible};
+        if (auto it = ids_.find(symbol); it != ids_.end()) {
+            scales_[it->second] = scale;
+            return it->second;
+        }
+        auto id = static_cast<coin_id>(scales_.size());
+        scales_.push_back(scale);
+        ids_.emplace(symbol, id);
+        return id;
+    }
+
+    coin_id coin_scale_table::get_id(const std::string &symbol) const noexcept
+    {
+        auto it = ids_.find(symbol);
+        return it == ids_.end() ? invalid_coin_id : it->second;
+    }
+
+    coin_id coin_scale_table::at(const std::string &symbol) const
+    {
+        auto id = get_id(symbol);
+        if (id == invalid_coin_id) {
+            throw std::out_of_range("unknown coin: " + symbol);
+        }
+        return id;
+    }
+}
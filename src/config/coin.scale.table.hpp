@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <absl/numeric/int128.h>
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot
+{
+    using coin_id = std::uint32_t;
+
+    struct coin_scale
+    {
+        std::size_t nb_decimals;
+        absl::uint128 scale;
+        bool is_mm2_compatible;
+        bool is_electrum_compatible;
+    };
+
+    /**
+     * @brief Dense per coin table of the decimals and of their power of ten, built once from the coins registry
+     *        so the price conversions don't hash the symbol and walk the registry on every call.
+     *        Symbols are interned to a coin_id, resolve it once and index the table with it on the hot paths.
+     */
+    class coin_scale_table
+    {
+    public:
+        static constexpr coin_id invalid_coin_id = static_cast<coin_id>(-1);
+
+        template<typename Registry>
+        void build(const Registry &registry)
+        {
+            scales_.clear();
+            ids_.clear();
+            scales_.reserve(registry.size());
+            ids_.reserve(registry.size());
+            for (auto &&[symbol, infos] : registry) {
+                add(symbol, infos.nb_decimals, infos.is_mm2_compatible, infos.is_electrum_compatible);
+            }
+        }
+
+        coin_id add(const std::string &symbol, std::size_t nb_decimals, bool is_mm2_compatible = false,
+                    bool is_electrum_compatible = false);
+
+        //! invalid_coin_id if the symbol is unknown.
+        [[nodiscard]] coin_id get_id(const std::string &symbol) const noexcept;
+
+        //! throws std::out_of_range if the symbol is unknown, like the registry does.
+        [[nodiscard]] coin_id at(const std::string &symbol) const;
+
+        [[nodiscard]] const coin_scale &operator[](coin_id id) const noexcept
+        {
+            return scales_[id];
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return scales_.size();
+        }
+
+    private:
+        std::vector<coin_scale> scales_;
+        std::unordered_map<std::string, coin_id> ids_;
+    };
+}
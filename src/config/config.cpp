@@ -14,11 +14,85 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include "utils/antara.algorithm.hpp"
+#include "utils/antara.atomic.snapshot.hpp"
+#include "utils/antara.mapped.file.hpp"
 #include "config.hpp"
 
+namespace
+{
+    nlohmann::json parse_mapped_json(const std::filesystem::path &path)
+    {
+        antara::mapped_file file(path);
+        DCHECK_F(file.is_open(), "Failed to open: [%s]", path.string().c_str());
+        const auto *begin = reinterpret_cast<const char *>(file.data());
+        return nlohmann::json::parse(begin, begin + file.size());
+    }
+
+    antara::atomic_snapshot<antara::mmbot::config> &config_versions()
+    {
+        static antara::atomic_snapshot<antara::mmbot::config> versions;
+        return versions;
+    }
+
+    struct config_listeners
+    {
+        std::mutex mutex;
+        std::size_t next_subscription{0};
+        std::map<std::size_t, antara::mmbot::config_listener> listeners;
+    };
+
+    config_listeners &get_config_listeners()
+    {
+        static config_listeners listeners;
+        return listeners;
+    }
+
+    //! these are read once when the process starts, a reload changing them is only applied after a restart.
+    void warn_about_restart_only_changes(const antara::mmbot::config &current, const antara::mmbot::config &reloaded)
+    {
+        auto warn_if = [](bool changed, const char *field) {
+            if (changed) {
+                VLOG_F(loguru::Verbosity_WARNING, "config reload: %s changed, it is only applied after a restart",
+                       field);
+            }
+        };
+        warn_if(current.http_thread_pool_size != reloaded.http_thread_pool_size, "http_thread_pool_size");
+        warn_if(current.mm2_rpc_thread_pool_size != reloaded.mm2_rpc_thread_pool_size, "mm2_rpc_thread_pool_size");
+        warn_if(current.price_cache_ttl_ms != reloaded.price_cache_ttl_ms, "price_cache_ttl_ms");
+        warn_if(current.config_watch_interval_ms != reloaded.config_watch_interval_ms, "config_watch_interval_ms");
+        warn_if(current.coins_to_activate != reloaded.coins_to_activate, "coins_to_activate");
+        warn_if(current.tick_store_path != reloaded.tick_store_path, "tick_store_path");
+        warn_if(current.price_bus_path != reloaded.price_bus_path, "price_bus_path");
+        warn_if(current.price_bus_capacity != reloaded.price_bus_capacity, "price_bus_capacity");
+        warn_if(current.shard != reloaded.shard, "shard");
+    }
+
+    void publish_mmbot_config(antara::mmbot::config cfg)
+    {
+        auto &listeners = get_config_listeners();
+        std::scoped_lock lock(listeners.mutex);
+        //! held, a listener may take longer than the grace period of the replaced version.
+        const auto previous = config_versions().load();
+        auto version = config_versions().publish(std::move(cfg));
+        VLOG_F(loguru::Verbosity_INFO, "config version %llu published", static_cast<unsigned long long>(version));
+        const auto current = config_versions().load();
+        for (auto &&[subscription, listener] : listeners.listeners) {
+            try {
+                listener(*previous, *current);
+            }
+            catch (const std::exception &error) {
+                VLOG_F(loguru::Verbosity_ERROR, "config listener %zu failed: %s", subscription, error.what());
+            }
+        }
+    }
+}
+
 namespace antara::mmbot
 {
-    static config mmbot_cfg;
 
     void from_json(const nlohmann::json &j, cex_config &cfg)
     {
@@ -35,11 +109,66 @@ namespace antara::mmbot
         }
     }
 
+    void from_json(const nlohmann::json &j, shard_config &cfg)
+    {
+        if (j.count("nb_workers") > 0) {
+            j.at("nb_workers").get_to(cfg.nb_workers);
+        }
+        if (j.count("virtual_nodes") > 0) {
+            j.at("virtual_nodes").get_to(cfg.virtual_nodes);
+        }
+        if (j.count("price_socket_path") > 0) {
+            j.at("price_socket_path").get_to(cfg.price_socket_path);
+        }
+        if (j.count("mm2_endpoints") > 0) {
+            j.at("mm2_endpoints").get_to(cfg.mm2_endpoints);
+        }
+    }
+
     void from_json(const nlohmann::json &j, config &cfg)
     {
         j.at("cex_infos_registry").get_to(cfg.cex_registry);
         j.at("price_infos_registry").get_to(cfg.price_registry);
         j.at("http_port").get_to(cfg.http_port);
+        if (j.count("tick_store_path") > 0) {
+            cfg.tick_store_path = j.at("tick_store_path").get<std::string>();
+        }
+        if (j.count("price_cache_ttl_ms") > 0) {
+            j.at("price_cache_ttl_ms").get_to(cfg.price_cache_ttl_ms);
+        }
+        if (j.count("http_thread_pool_size") > 0) {
+            j.at("http_thread_pool_size").get_to(cfg.http_thread_pool_size);
+        }
+        if (j.count("mm2_rpc_thread_pool_size") > 0) {
+            j.at("mm2_rpc_thread_pool_size").get_to(cfg.mm2_rpc_thread_pool_size);
+        }
+        if (j.count("tracing_enabled") > 0) {
+            j.at("tracing_enabled").get_to(cfg.tracing_enabled);
+        }
+        if (j.count("log_payload_sample_rate") > 0) {
+            j.at("log_payload_sample_rate").get_to(cfg.log_payload_sample_rate);
+        }
+        if (j.count("mm2_endpoint") > 0) {
+            cfg.mm2_endpoint = j.at("mm2_endpoint").get<std::string>();
+        }
+        if (j.count("coins_to_activate") > 0) {
+            j.at("coins_to_activate").get_to(cfg.coins_to_activate);
+        }
+        if (j.count("price_poll_interval_ms") > 0) {
+            j.at("price_poll_interval_ms").get_to(cfg.price_poll_interval_ms);
+        }
+        if (j.count("config_watch_interval_ms") > 0) {
+            j.at("config_watch_interval_ms").get_to(cfg.config_watch_interval_ms);
+        }
+        if (j.count("shard") > 0) {
+            j.at("shard").get_to(cfg.shard);
+        }
+        if (j.count("price_bus_path") > 0) {
+            cfg.price_bus_path = j.at("price_bus_path").get<std::string>();
+        }
+        if (j.count("price_bus_capacity") > 0) {
+            j.at("price_bus_capacity").get_to(cfg.price_bus_capacity);
+        }
     }
 
     void to_json(nlohmann::json &j, const cex_config &cfg)
@@ -57,6 +186,14 @@ namespace antara::mmbot
         }
     }
 
+    void to_json(nlohmann::json &j, const shard_config &cfg)
+    {
+        j["nb_workers"] = cfg.nb_workers;
+        j["virtual_nodes"] = cfg.virtual_nodes;
+        j["price_socket_path"] = cfg.price_socket_path;
+        j["mm2_endpoints"] = cfg.mm2_endpoints;
+    }
+
     void to_json(nlohmann::json &j, const config &cfg)
     {
         j["cex_infos_registry"] = nlohmann::json::object();
@@ -68,20 +205,39 @@ namespace antara::mmbot
             j["price_infos"][key] = value;
         }
         j["http_port"] = cfg.http_port;
+        if (cfg.tick_store_path.has_value()) {
+            j["tick_store_path"] = cfg.tick_store_path.value();
+        }
+        j["price_cache_ttl_ms"] = cfg.price_cache_ttl_ms;
+        j["http_thread_pool_size"] = cfg.http_thread_pool_size;
+        j["mm2_rpc_thread_pool_size"] = cfg.mm2_rpc_thread_pool_size;
+        j["tracing_enabled"] = cfg.tracing_enabled;
+        j["log_payload_sample_rate"] = cfg.log_payload_sample_rate;
+        if (cfg.mm2_endpoint.has_value()) {
+            j["mm2_endpoint"] = cfg.mm2_endpoint.value();
+        }
+        j["coins_to_activate"] = cfg.coins_to_activate;
+        j["price_poll_interval_ms"] = cfg.price_poll_interval_ms;
+        j["config_watch_interval_ms"] = cfg.config_watch_interval_ms;
+        j["shard"] = cfg.shard;
+        if (cfg.price_bus_path.has_value()) {
+            j["price_bus_path"] = cfg.price_bus_path.value();
+        }
+        j["price_bus_capacity"] = cfg.price_bus_capacity;
     }
 
     void load_mmbot_config(std::filesystem::path &&config_path, std::string filename) noexcept
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        mmbot_cfg = load_configuration<mmbot::config>(std::forward<std::filesystem::path>(config_path),
-                                                      std::move(filename));
-        fill_with_coins_cfg(config_path, mmbot_cfg);
+        auto cfg = load_configuration<mmbot::config>(std::forward<std::filesystem::path>(config_path),
+                                                     std::move(filename));
+        fill_with_coins_cfg(config_path, cfg);
         auto full_path = config_path / "MM2.json";
         std::ifstream ifs(full_path);
         DCHECK_F(ifs.is_open(), "Failed to open: [%s]", full_path.string().c_str());
         nlohmann::json coins_json_data;
         ifs >> coins_json_data;
-        coins_json_data.at("rpc_password").get_to(mmbot_cfg.mm2_rpc_password);
+        coins_json_data.at("rpc_password").get_to(cfg.mm2_rpc_password);
         ifs.close();
         if (auto force_passphrase = std::getenv("FORCE_MM2_PASSPHRASE"); force_passphrase != nullptr) {
             VLOG_F(loguru::Verbosity_INFO, "passphrase detected through environment, setuping...");
@@ -91,16 +247,49 @@ namespace antara::mmbot
             ofs << coins_json_data;
             ofs.close();
         }
+        publish_mmbot_config(std::move(cfg));
+    }
+
+    bool reload_mmbot_config(const std::filesystem::path &config_path, const std::string &filename) noexcept
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        static std::mutex reload_mutex;
+        std::scoped_lock lock(reload_mutex);
+        try {
+            config cfg = parse_mapped_json(config_path / filename);
+            fill_with_coins_cfg(config_path, cfg);
+            //! mm2 keeps running across reloads, so does its rpc password. The http server and the mm2 endpoint are
+            //! bound once, and a shard worker has its own port and mm2 instead of the ones of the file.
+            const auto &current = get_mmbot_config();
+            warn_about_restart_only_changes(current, cfg);
+            cfg.mm2_rpc_password = current.mm2_rpc_password;
+            cfg.http_port = current.http_port;
+            cfg.mm2_endpoint = current.mm2_endpoint;
+            publish_mmbot_config(std::move(cfg));
+            return true;
+        }
+        catch (const std::exception &error) {
+            VLOG_F(loguru::Verbosity_ERROR, "config reload failed, keeping version %llu: %s",
+                   static_cast<unsigned long long>(get_mmbot_config_version()), error.what());
+            return false;
+        }
     }
 
     void fill_with_coins_cfg(const std::filesystem::path &config_path, config &cfg)
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        auto full_path = config_path / "coins.json";
-        std::ifstream ifs(full_path);
-        DCHECK_F(ifs.is_open(), "Failed to open: [%s]", full_path.string().c_str());
-        nlohmann::json coins_json_data;
-        ifs >> coins_json_data;
+        auto coins_json_data = parse_mapped_json(config_path / "coins.json");
+
+        //! one directory listing instead of an exists() per coin.
+        std::unordered_set<std::string> electrum_files;
+        std::error_code ec;
+        for (auto &&entry : std::filesystem::directory_iterator(config_path / "electrums", ec)) {
+            electrum_files.emplace(entry.path().filename().string());
+        }
+
+        std::vector<std::pair<std::string, additional_coin_info>> coins;
+        coins.reserve(coins_json_data.size());
+        std::vector<std::size_t> electrum_coins;
         for (auto &&current_element: coins_json_data) {
             additional_coin_info additional_infos{8u, false, false, {}};
             auto current_coin = current_element["coin"].get<std::string>();
@@ -112,30 +301,31 @@ namespace antara::mmbot
                 additional_infos.nb_decimals = current_element["decimals"].get<int>();
             }
             additional_infos.is_mm2_compatible = current_element.find("mm2") != current_element.end();
-            auto current_path = std::filesystem::current_path() / "assets/electrums" / current_coin;
-            if (additional_infos.is_mm2_compatible &&
-                std::filesystem::exists(current_path)) {
+            if (additional_infos.is_mm2_compatible && electrum_files.count(current_coin) > 0) {
                 additional_infos.is_electrum_compatible = true;
+                electrum_coins.push_back(coins.size());
             }
-            if (additional_infos.is_electrum_compatible) {
-                extract_from_electrum_file(config_path, current_coin, additional_infos);
-            }
-            cfg.registry_additional_coin_infos.emplace(current_coin,
-                                                       additional_infos);
+            coins.emplace_back(std::move(current_coin), std::move(additional_infos));
+        }
+
+        par_for_each(electrum_coins.begin(), electrum_coins.end(), [&config_path, &coins](std::size_t idx) {
+            extract_from_electrum_file(config_path, coins[idx].first, coins[idx].second);
+        });
+
+        cfg.registry_additional_coin_infos.reserve(coins.size() + 2);
+        for (auto &&[current_coin, additional_infos] : coins) {
+            cfg.registry_additional_coin_infos.emplace(std::move(current_coin), std::move(additional_infos));
         }
         cfg.registry_additional_coin_infos.emplace("EUR", additional_coin_info{2u, false, false, {}});
         cfg.registry_additional_coin_infos.emplace("USD", additional_coin_info{2u, false, false, {}});
+        cfg.coin_scales.build(cfg.registry_additional_coin_infos);
     }
 
     void extract_from_electrum_file(const std::filesystem::path &path, const std::string &coin,
                                     additional_coin_info &additional_info)
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        auto full_path = path / "electrums" / coin;
-        std::ifstream ifs(full_path);
-        DCHECK_F(ifs.is_open(), "Failed to open: [%s]", full_path.string().c_str());
-        nlohmann::json electrum_json_data;
-        ifs >> electrum_json_data;
+        auto electrum_json_data = parse_mapped_json(path / "electrums" / coin);
         for (auto &&current_element: electrum_json_data) {
             electrum_server srv;
             current_element.at("url").get_to(srv.url);
@@ -162,19 +352,57 @@ namespace antara::mmbot
 
     const mmbot::config &get_mmbot_config() noexcept
     {
-        return mmbot_cfg;
+        return config_versions().get();
+    }
+
+    std::shared_ptr<const mmbot::config> get_mmbot_config_snapshot()
+    {
+        return config_versions().load();
+    }
+
+    std::uint64_t get_mmbot_config_version() noexcept
+    {
+        return config_versions().version();
+    }
+
+    void set_mmbot_config(config &cfg)
+    {
+        publish_mmbot_config(cfg);
     }
 
-    void set_mmbot_config(config &cfg) noexcept
+    std::size_t subscribe_mmbot_config(config_listener listener)
     {
-        mmbot_cfg = cfg;
+        auto &listeners = get_config_listeners();
+        std::scoped_lock lock(listeners.mutex);
+        auto subscription = listeners.next_subscription++;
+        listeners.listeners.emplace(subscription, std::move(listener));
+        return subscription;
+    }
+
+    void unsubscribe_mmbot_config(std::size_t subscription) noexcept
+    {
+        auto &listeners = get_config_listeners();
+        std::scoped_lock lock(listeners.mutex);
+        listeners.listeners.erase(subscription);
     }
 
     bool config::operator==(const config &rhs) const
     {
         return cex_registry == rhs.cex_registry &&
                price_registry == rhs.price_registry &&
-               http_port == rhs.http_port && mm2_rpc_password == rhs.mm2_rpc_password;
+               http_port == rhs.http_port && mm2_rpc_password == rhs.mm2_rpc_password &&
+               tick_store_path == rhs.tick_store_path && price_cache_ttl_ms == rhs.price_cache_ttl_ms &&
+               http_thread_pool_size == rhs.http_thread_pool_size &&
+               mm2_rpc_thread_pool_size == rhs.mm2_rpc_thread_pool_size &&
+               tracing_enabled == rhs.tracing_enabled &&
+               log_payload_sample_rate == rhs.log_payload_sample_rate &&
+               mm2_endpoint == rhs.mm2_endpoint &&
+               coins_to_activate == rhs.coins_to_activate &&
+               price_poll_interval_ms == rhs.price_poll_interval_ms &&
+               config_watch_interval_ms == rhs.config_watch_interval_ms &&
+               shard == rhs.shard &&
+               price_bus_path == rhs.price_bus_path &&
+               price_bus_capacity == rhs.price_bus_capacity;
     }
 
     bool config::operator!=(const config &rhs) const
@@ -182,6 +410,17 @@ namespace antara::mmbot
         return !(rhs == *this);
     }
 
+    bool shard_config::operator==(const shard_config &rhs) const
+    {
+        return nb_workers == rhs.nb_workers && virtual_nodes == rhs.virtual_nodes &&
+               price_socket_path == rhs.price_socket_path && mm2_endpoints == rhs.mm2_endpoints;
+    }
+
+    bool shard_config::operator!=(const shard_config &rhs) const
+    {
+        return !(rhs == *this);
+    }
+
     bool price_config::operator==(const price_config &rhs) const
     {
 #ifdef _MSC_VER
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -26,6 +29,7 @@
 #include <loguru.hpp>
 #include "utils/pretty_function.hpp"
 #include "utils/mmbot_strong_types.hpp"
+#include "config/coin.scale.table.hpp"
 
 namespace antara::mmbot
 {
@@ -67,6 +71,26 @@ namespace antara::mmbot
         std::vector<electrum_server> servers_electrum;
     };
 
+    //! sharding mode: a coordinator process spreads the pairs over `nb_workers` bot processes, 0 disables it.
+    struct shard_config
+    {
+        bool operator==(const shard_config &rhs) const;
+
+        bool operator!=(const shard_config &rhs) const;
+
+        std::size_t nb_workers{0};
+        //! points per worker on the hash ring, more points spread the pairs more evenly.
+        std::size_t virtual_nodes{64};
+        //! unix socket on which the coordinator publishes its prices to the workers.
+        std::string price_socket_path{"mmbot.prices.sock"};
+        //! mm2 of each worker by index, a worker without one launches its own mm2.
+        std::vector<std::string> mm2_endpoints{};
+    };
+
+    void to_json(nlohmann::json &j, const shard_config &cfg);
+
+    void from_json(const nlohmann::json &j, shard_config &cfg);
+
     struct config
     {
         bool operator==(const config &rhs) const;
@@ -82,6 +106,23 @@ namespace antara::mmbot
         st_http_port http_port;
         additional_coin_infos_registry registry_additional_coin_infos;
         std::string mm2_rpc_password{""};
+        std::optional<std::string> tick_store_path{std::nullopt};
+        std::size_t price_cache_ttl_ms{5000};
+        std::size_t http_thread_pool_size{1};
+        std::size_t mm2_rpc_thread_pool_size{8};
+        bool tracing_enabled{false};
+        std::size_t log_payload_sample_rate{0};
+        std::optional<std::string> mm2_endpoint{std::nullopt};
+        std::vector<std::string> coins_to_activate{"RICK", "MORTY"};
+        std::size_t price_poll_interval_ms{30000};
+        std::size_t config_watch_interval_ms{1000};
+        //! the worker of index i listens on http_port + 1 + i.
+        shard_config shard{};
+        //! shared memory segment publishing the prices to the local processes, e.g. /dev/shm/mmbot.prices.
+        std::optional<std::string> price_bus_path{std::nullopt};
+        std::size_t price_bus_capacity{1024};
+        //! derived from registry_additional_coin_infos when the coins are loaded, indexed by coin_id.
+        coin_scale_table coin_scales{};
     };
 
     void from_json(const nlohmann::json &j, cex_config &cfg);
@@ -172,6 +213,25 @@ namespace antara::mmbot
 
     void extract_from_electrum_file(const std::filesystem::path &path, const std::string &coin,
                                     additional_coin_info &additional_info);
+
+    //! lock free, a reference taken before a reload keeps reading the version it was taken from for a minute.
     const mmbot::config& get_mmbot_config() noexcept;
-    void set_mmbot_config(config& cfg) noexcept;
+
+    //! the current version held as long as needed, for the readers using it longer than a minute.
+    std::shared_ptr<const mmbot::config> get_mmbot_config_snapshot();
+
+    std::uint64_t get_mmbot_config_version() noexcept;
+
+    //! publish `cfg` as the new version of the configuration and notify the listeners.
+    void set_mmbot_config(config& cfg);
+
+    //! load again config_path / filename with the coins, the current version is kept if anything fails.
+    bool reload_mmbot_config(const std::filesystem::path &config_path, const std::string &filename) noexcept;
+
+    //! called on the publishing thread after every new version, a listener must not (un)subscribe.
+    using config_listener = std::function<void(const config &previous, const config &current)>;
+
+    std::size_t subscribe_mmbot_config(config_listener listener);
+
+    void unsubscribe_mmbot_config(std::size_t subscription) noexcept;
 }
\ No newline at end of file
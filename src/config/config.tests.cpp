@@ -61,6 +61,16 @@ namespace antara::mmbot::tests
         CHECK_EQ("https://api.coinpaprika.com/v1", cfg.price_registry["coinpaprika"].price_endpoint.value());
         CHECK_THROWS(cfg.price_registry.at("nonexistent").price_endpoint.value());
         CHECK_THROWS(cfg.cex_registry.at("nonexistent").cex_endpoint.value());
+        CHECK_EQ(0, cfg.shard.nb_workers);
+
+        json_mmbot_cfg["shard"] = {{"nb_workers", 3}, {"mm2_endpoints", {"http://127.0.0.1:7790"}}};
+        CHECK_NOTHROW(from_json(json_mmbot_cfg, cfg));
+        CHECK_EQ(3, cfg.shard.nb_workers);
+        CHECK_EQ(64, cfg.shard.virtual_nodes);
+        CHECK_EQ("mmbot.prices.sock", cfg.shard.price_socket_path);
+        CHECK_EQ(std::vector<std::string>{"http://127.0.0.1:7790"}, cfg.shard.mm2_endpoints);
+        nlohmann::json round_trip = cfg;
+        CHECK_EQ(cfg.shard, round_trip.at("shard").get<shard_config>());
     }
 
     SCENARIO ("loading configuration")
@@ -143,4 +153,20 @@ namespace antara::mmbot::tests
             }
         }
     }
-}
\ No newline at end of file
+
+    TEST_CASE("coin scale table is built from the coins registry")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        const auto &cfg = get_mmbot_config();
+        CHECK_EQ(cfg.registry_additional_coin_infos.size(), cfg.coin_scales.size());
+        const auto &eth = cfg.coin_scales[cfg.coin_scales.at("ETH")];
+        CHECK_EQ(18u, eth.nb_decimals);
+        CHECK_EQ(absl::uint128(1000000000000000000ull), eth.scale);
+        CHECK_FALSE(eth.is_electrum_compatible);
+        const auto &btc = cfg.coin_scales[cfg.coin_scales.at("BTC")];
+        CHECK_EQ(100000000u, btc.scale);
+        CHECK(btc.is_electrum_compatible);
+        CHECK_EQ(coin_scale_table::invalid_coin_id, cfg.coin_scales.get_id("NOT_A_COIN"));
+        CHECK_THROWS_AS(static_cast<void>(cfg.coin_scales.at("NOT_A_COIN")), std::out_of_range);
+    }
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <loguru.hpp>
+#include "utils/pretty_function.hpp"
+#include "config/config.hpp"
+#include "config/config.watcher.hpp"
+
+namespace antara::mmbot
+{
+    config_watcher::config_watcher(std::filesystem::path config_path, std::string filename) :
+            config_watcher(std::move(config_path), std::move(filename),
+                           std::chrono::milliseconds{get_mmbot_config().config_watch_interval_ms})
+    {
+    }
+
+    config_watcher::config_watcher(std::filesystem::path config_path, std::string filename,
+                                   std::chrono::milliseconds poll_interval) :
+            config_path_(std::move(config_path)), filename_(std::move(filename)), poll_interval_(poll_interval)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        if (poll_interval_.count() == 0) {
+            DVLOG_F(loguru::Verbosity_INFO, "config watching disabled");
+            return;
+        }
+        //! taken before the thread starts so a change right after the construction is not missed.
+        thread_ = std::thread([this, last_seen = last_write_time()]() { watch(last_seen); });
+    }
+
+    config_watcher::~config_watcher() noexcept
+    {
+        stop();
+    }
+
+    void config_watcher::stop() noexcept
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    std::size_t config_watcher::nb_reloads() const noexcept
+    {
+        return nb_reloads_.load();
+    }
+
+    std::filesystem::file_time_type config_watcher::last_write_time() const noexcept
+    {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(config_path_ / filename_, ec);
+        return ec ? std::filesystem::file_time_type::min() : time;
+    }
+
+    void config_watcher::watch(std::filesystem::file_time_type last_seen)
+    {
+        loguru::set_thread_name("config watcher");
+        std::unique_lock lock(mutex_);
+        while (!cv_.wait_for(lock, poll_interval_, [this]() { return stopped_; })) {
+            auto current = last_write_time();
+            if (current == last_seen || current == std::filesystem::file_time_type::min()) {
+                continue;
+            }
+            last_seen = current;
+            DVLOG_F(loguru::Verbosity_INFO, "%s changed, reloading", (config_path_ / filename_).string().c_str());
+            lock.unlock();
+            if (reload_mmbot_config(config_path_, filename_)) {
+                ++nb_reloads_;
+            }
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace antara::mmbot
+{
+    /**
+     * @brief Polls the modification time of a configuration file and reloads it when it changes. Polling keeps
+     *        it portable, the interval comes from config_watch_interval_ms unless given.
+     */
+    class config_watcher
+    {
+    public:
+        config_watcher(std::filesystem::path config_path, std::string filename);
+
+        config_watcher(std::filesystem::path config_path, std::string filename,
+                       std::chrono::milliseconds poll_interval);
+
+        ~config_watcher() noexcept;
+
+        config_watcher(const config_watcher &) = delete;
+
+        config_watcher &operator=(const config_watcher &) = delete;
+
+        void stop() noexcept;
+
+        [[nodiscard]] std::size_t nb_reloads() const noexcept;
+
+    private:
+        void watch(std::filesystem::file_time_type last_seen);
+
+        std::filesystem::file_time_type last_write_time() const noexcept;
+
+        std::filesystem::path config_path_;
+        std::string filename_;
+        std::chrono::milliseconds poll_interval_;
+        std::atomic_size_t nb_reloads_{0};
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopped_{false};
+        std::thread thread_;
+    };
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fstream>
+#include <thread>
+#include <doctest/doctest.h>
+#include "config/config.hpp"
+#include "config/config.watcher.hpp"
+
+namespace
+{
+    std::filesystem::path make_watched_assets()
+    {
+        auto assets = std::filesystem::current_path() / "assets";
+        auto watched = std::filesystem::current_path() / "watched_assets";
+        std::filesystem::remove_all(watched);
+        std::filesystem::create_directories(watched);
+        std::filesystem::copy(assets / "coins.json", watched / "coins.json");
+        std::filesystem::copy(assets / "electrums", watched / "electrums", std::filesystem::copy_options::recursive);
+        std::filesystem::copy(assets / "mmbot_config.json", watched / "mmbot_config.json");
+        return watched;
+    }
+
+    void rewrite_config(const std::filesystem::path &path, const nlohmann::json &config_json)
+    {
+        auto previous_write_time = std::filesystem::last_write_time(path);
+        {
+            std::ofstream ofs(path, std::ios::trunc);
+            ofs << config_json;
+        }
+        //! some filesystems only have a one second resolution.
+        std::filesystem::last_write_time(path, previous_write_time + std::chrono::seconds{2});
+    }
+}
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("config reload publishes a new version and notifies the listeners")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        auto watched = make_watched_assets();
+        const auto &before = get_mmbot_config();
+        const auto version = get_mmbot_config_version();
+
+        std::size_t nb_notified = 0;
+        std::size_t previous_interval = 0;
+        auto subscription = subscribe_mmbot_config([&](const config &previous, const config &current) {
+            ++nb_notified;
+            previous_interval = previous.price_poll_interval_ms;
+            CHECK_EQ(1234, current.price_poll_interval_ms);
+        });
+        nlohmann::json config_json = before;
+        config_json["price_poll_interval_ms"] = 1234;
+        config_json["http_port"] = before.http_port + 1;
+        rewrite_config(watched / "mmbot_config.json", config_json);
+        CHECK(reload_mmbot_config(watched, "mmbot_config.json"));
+        unsubscribe_mmbot_config(subscription);
+
+        CHECK_EQ(version + 1, get_mmbot_config_version());
+        CHECK_EQ(1, nb_notified);
+        CHECK_EQ(before.price_poll_interval_ms, previous_interval);
+        CHECK_EQ(1234, get_mmbot_config().price_poll_interval_ms);
+        CHECK_EQ(before.mm2_rpc_password, get_mmbot_config().mm2_rpc_password);
+        CHECK_EQ(before.http_port, get_mmbot_config().http_port);
+        CHECK_FALSE(get_mmbot_config().registry_additional_coin_infos.empty());
+        CHECK_NE(1234, before.price_poll_interval_ms);
+
+        {
+            std::ofstream ofs(watched / "mmbot_config.json", std::ios::trunc);
+            ofs << "{ not json";
+        }
+        CHECK_FALSE(reload_mmbot_config(watched, "mmbot_config.json"));
+        CHECK_EQ(version + 1, get_mmbot_config_version());
+        std::filesystem::remove_all(watched);
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+
+    TEST_CASE ("config watcher reloads a modified configuration")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        auto watched = make_watched_assets();
+        config_watcher watcher(watched, "mmbot_config.json", std::chrono::milliseconds{5});
+        nlohmann::json config_json = get_mmbot_config();
+        config_json["price_poll_interval_ms"] = 4321;
+        rewrite_config(watched / "mmbot_config.json", config_json);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (watcher.nb_reloads() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+        watcher.stop();
+        CHECK_EQ(1, watcher.nb_reloads());
+        CHECK_EQ(4321, get_mmbot_config().price_poll_interval_ms);
+        std::filesystem::remove_all(watched);
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+}
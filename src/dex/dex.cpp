@@ -21,16 +21,42 @@
 
 namespace antara::mmbot
 {
+    std::vector<orders::order>
+    abstract_dex::place(const antara::pair &pair, const std::vector<orders::order_level> &levels)
+    {
+        std::vector<orders::order> placed;
+        placed.reserve(levels.size());
+        for (auto &&ol : levels) {
+            placed.push_back(place(pair, ol));
+        }
+        return placed;
+    }
+
     orders::order &dex::place([[maybe_unused]] const orders::order_level &o)
     {
         throw mmbot::errors::not_implemented(pretty_function);
     }
 
+    orders::order &dex::place([[maybe_unused]] const antara::pair &pair, [[maybe_unused]] const orders::order_level &o)
+    {
+        throw mmbot::errors::not_implemented(pretty_function);
+    }
+
     bool dex::cancel([[maybe_unused]] st_order_id id)
     {
         throw mmbot::errors::not_implemented(pretty_function);
     }
 
+    cancel_result dex::cancel_all([[maybe_unused]] const antara::pair &pair)
+    {
+        throw mmbot::errors::not_implemented(pretty_function);
+    }
+
+    cancel_result dex::cancel_all([[maybe_unused]] const std::unordered_set<st_order_id> &ids)
+    {
+        throw mmbot::errors::not_implemented(pretty_function);
+    }
+
     std::vector<orders::order> dex::get_live_orders()
     {
         throw mmbot::errors::not_implemented(pretty_function);
@@ -25,13 +25,26 @@
 
 namespace antara::mmbot
 {
+    struct cancel_result
+    {
+        std::unordered_set<st_order_id> cancelled;
+        //! in a swap, they can't be cancelled and finish as filled.
+        std::unordered_set<st_order_id> currently_matching;
+    };
+
     class abstract_dex
     {
     public:
         virtual ~abstract_dex() = default;
 
         virtual orders::order &place(const orders::order_level &ol) = 0;
+        virtual orders::order &place(const antara::pair &pair, const orders::order_level &ol) = 0;
+        //! the dex sends the levels together when it can, one place per level by default.
+        virtual std::vector<orders::order> place(const antara::pair &pair, const std::vector<orders::order_level> &levels);
         virtual bool cancel(st_order_id id) = 0;
+        //! one request for all the orders of `pair`, including the ones we don't know about.
+        virtual cancel_result cancel_all(const antara::pair &pair) = 0;
+        virtual cancel_result cancel_all(const std::unordered_set<st_order_id> &ids) = 0;
 
         virtual std::vector<orders::order> get_live_orders() = 0;
         virtual orders::order get_order_status(const st_order_id &id) = 0;
@@ -45,8 +58,13 @@ namespace antara::mmbot
     class dex : public abstract_dex
     {
     public:
+        using abstract_dex::place;
+
         orders::order &place(const orders::order_level &ol) override;
+        orders::order &place(const antara::pair &pair, const orders::order_level &ol) override;
         bool cancel(st_order_id id) override;
+        cancel_result cancel_all(const antara::pair &pair) override;
+        cancel_result cancel_all(const std::unordered_set<st_order_id> &ids) override;
 
         std::vector<orders::order> get_live_orders() override;
         orders::order get_order_status(const st_order_id &id) override;
@@ -0,0 +1,557 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <future>
+#include <optional>
+#include <iterator>
+#include <stdexcept>
+#include <loguru.hpp>
+
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
+#include "utils/antara.utils.hpp"
+#include "utils/exceptions.hpp"
+#include "utils/pretty_function.hpp"
+#include "dex.mm2.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot;
+
+    constexpr std::size_t known_swaps_capacity = 10000;
+
+    std::size_t nb_decimals(const config &cfg, const st_symbol &symbol)
+    {
+        return cfg.coin_scales[cfg.coin_scales.at(symbol.value())].nb_decimals;
+    }
+
+    std::string format_amount(double amount)
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.8f", amount);
+        return buffer;
+    }
+
+    //! quote per base as a decimal string.
+    std::string price_as_string(const config &cfg, const antara::pair &pair, const st_price &price)
+    {
+        return get_price_as_string_decimal(cfg, pair.base.symbol, pair.quote.symbol, price);
+    }
+
+    //! quote per base in the decimals of quote to base per quote in the decimals of base.
+    st_price invert(const config &cfg, const antara::pair &pair, const st_price &price, rounding mode)
+    {
+        if (price.value() == 0) {
+            throw std::invalid_argument("an mm2 order can't be placed at a price of 0");
+        }
+        const auto numerator = pow10_u128(nb_decimals(cfg, pair.quote.symbol) + nb_decimals(cfg, pair.base.symbol));
+        return st_price{antara::details::divide_rounded<absl::uint128>(numerator, price.value(), mode)};
+    }
+
+    //! the volume of the inverted order, in quote.
+    std::string quote_volume(const config &cfg, const antara::pair &pair, const orders::order_level &ol)
+    {
+        return format_amount(ol.quantity.value() * std::stod(price_as_string(cfg, pair, ol.price)));
+    }
+
+    //! mm2 makers sell their base: an ask is a setprice on base/rel, a bid sells quote on the inverted pair
+    //! at a price rounded up, so it never pays more than its price.
+    mm2::setprice_request make_setprice(const config &cfg, const antara::pair &pair, const orders::order_level &ol)
+    {
+        if (ol.side == side::both) {
+            throw std::invalid_argument("an mm2 order is a bid or an ask");
+        }
+        if (ol.side == side::sell) {
+            return mm2::setprice_request{pair.base, pair.quote, price_as_string(cfg, pair, ol.price),
+                                         format_amount(ol.quantity.value()), std::nullopt, false};
+        }
+        const antara::pair inverted{pair.base, pair.quote};
+        return mm2::setprice_request{pair.quote, pair.base,
+                                     price_as_string(cfg, inverted, invert(cfg, pair, ol.price, rounding::up)),
+                                     quote_volume(cfg, pair, ol), std::nullopt, false};
+    }
+
+    //! a taker buys base with rel: buying is a buy on base/rel, selling a buy of quote on the inverted pair.
+    mm2::buy_request make_buy(const config &cfg, const antara::pair &pair, const orders::order_level &ol)
+    {
+        if (ol.side == side::both) {
+            throw std::invalid_argument("an mm2 order is a bid or an ask");
+        }
+        if (ol.side == side::buy) {
+            return mm2::buy_request{pair.base, pair.quote, price_as_string(cfg, pair, ol.price),
+                                    format_amount(ol.quantity.value())};
+        }
+        const antara::pair inverted{pair.base, pair.quote};
+        return mm2::buy_request{pair.quote, pair.base,
+                                price_as_string(cfg, inverted, invert(cfg, pair, ol.price, rounding::down)),
+                                quote_volume(cfg, pair, ol)};
+    }
+
+    //! the quantity of an order is in base, whichever side of the mm2 pair it is on.
+    orders::execution to_execution(const orders::order &o, const mm2::swap_contents &swap)
+    {
+        const auto &amount = swap.my_coin == o.pair.base ? swap.my_amount : swap.other_amount;
+        return o.create_execution(st_execution_id{swap.uuid}, st_quantity{std::stod(amount)}, swap.type == "Maker");
+    }
+
+    //! a taker swap has the uuid of its order.
+    const std::string &order_uuid_of(const mm2::swap_contents &swap)
+    {
+        return swap.my_order_uuid.empty() ? swap.uuid : swap.my_order_uuid;
+    }
+
+    metrics::counter &rejected(const char *method)
+    {
+        return metrics::get_counter("mmbot_mm2_dex_rejected_total", metrics::label("method", method));
+    }
+}
+
+namespace antara::mmbot
+{
+    mm2_dex::mm2_dex(mm2_client &client, mm2_dex_options options) :
+            client_(client), options_(options), archive_(options.archive_capacity)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+    }
+
+    void mm2_dex::attach(mm2_swap_feed &feed)
+    {
+        {
+            std::scoped_lock lock(feed_mutex_);
+            for (auto &&[id, shadow] : orders_) {
+                feed_orders_.insert_or_assign(id, shadow.order);
+            }
+        }
+        attached_ = true;
+        feed.add_listener([this](const mm2::swap_contents &swap) { on_swap(swap); });
+    }
+
+    void mm2_dex::add_execution_listener(execution_listener listener)
+    {
+        execution_listeners_.push_back(std::move(listener));
+    }
+
+    void mm2_dex::on_swap(const mm2::swap_contents &swap)
+    {
+        std::optional<orders::execution> ex;
+        {
+            std::scoped_lock lock(feed_mutex_);
+            feed_swaps_.push_back(swap);
+            if (auto it = feed_orders_.find(order_uuid_of(swap)); it != feed_orders_.end() && swap.finished &&
+                                                                  !swap.failed) {
+                ex = to_execution(it->second, swap);
+            }
+        }
+        if (ex.has_value()) {
+            for (auto &&listener : execution_listeners_) {
+                listener(ex.value());
+            }
+        }
+    }
+
+    orders::order &mm2_dex::place([[maybe_unused]] const orders::order_level &ol)
+    {
+        throw mmbot::errors::not_implemented(std::string(pretty_function) + ": an mm2 order requires a pair");
+    }
+
+    orders::order &mm2_dex::place(const antara::pair &pair, const orders::order_level &ol)
+    {
+        MMBOT_TRACE_FUNCTION();
+        auto answer = client_.rpc_setprice(make_setprice(get_mmbot_config(), pair, ol));
+        if (answer.rpc_result_code != 200) {
+            rejected("setprice").inc();
+            throw std::runtime_error("mm2 refused the order: " + answer.result);
+        }
+        return add_order(answer.result_setprice.uuid, pair, ol);
+    }
+
+    std::vector<orders::order>
+    mm2_dex::place(const antara::pair &pair, const std::vector<orders::order_level> &levels)
+    {
+        MMBOT_TRACE_FUNCTION();
+        //! held across the rpc, the answers are scaled with the same version as the requests.
+        const auto cfg_snapshot = get_mmbot_config_snapshot();
+        const auto &cfg = *cfg_snapshot;
+        std::vector<mm2::setprice_request> requests;
+        requests.reserve(levels.size());
+        for (auto &&ol : levels) {
+            requests.push_back(make_setprice(cfg, pair, ol));
+        }
+        auto answers = client_.rpc_batch<mm2::setprice_answer>("setprice", std::move(requests));
+        std::vector<orders::order> placed;
+        placed.reserve(levels.size());
+        for (std::size_t idx = 0; idx < answers.size(); ++idx) {
+            if (answers[idx].rpc_result_code != 200) {
+                rejected("setprice").inc();
+                VLOG_F(loguru::Verbosity_WARNING, "mm2 refused the order %zu of the batch: %s", idx,
+                       answers[idx].result.c_str());
+                continue;
+            }
+            placed.push_back(add_order(answers[idx].result_setprice.uuid, pair, levels[idx]));
+        }
+        return placed;
+    }
+
+    orders::order &mm2_dex::take(const antara::pair &pair, const orders::order_level &ol)
+    {
+        MMBOT_TRACE_FUNCTION();
+        auto answer = client_.rpc_buy(make_buy(get_mmbot_config(), pair, ol));
+        if (answer.rpc_result_code != 200 || !answer.result_buy.has_value()) {
+            rejected("buy").inc();
+            throw std::runtime_error("mm2 refused the order: " + answer.result);
+        }
+        return add_order(answer.result_buy.value().uuid, pair, ol);
+    }
+
+    bool mm2_dex::cancel(st_order_id id)
+    {
+        MMBOT_TRACE_FUNCTION();
+        auto answer = client_.rpc_cancel_order(mm2::cancel_order_request{id});
+        if (answer.rpc_result_code != 200) {
+            VLOG_F(loguru::Verbosity_WARNING, "mm2 didn't cancel %s: %s", id.c_str(), answer.result.c_str());
+            return false;
+        }
+        mark_cancelled({id});
+        return true;
+    }
+
+    cancel_result mm2_dex::cancel_all(const antara::pair &pair)
+    {
+        MMBOT_TRACE_FUNCTION();
+        std::vector<mm2::cancel_all_orders_request> requests{
+                {"Pair", mm2::cancel_all_orders_data{pair.base, pair.quote}},
+                {"Pair", mm2::cancel_all_orders_data{pair.quote, pair.base}}};
+        auto answers = client_.rpc_batch<mm2::cancel_all_orders_answer>("cancel_all_orders", std::move(requests));
+        cancel_result result;
+        for (auto &&answer : answers) {
+            if (answer.rpc_result_code != 200) {
+                VLOG_F(loguru::Verbosity_WARNING, "mm2 cancel_all_orders failed: %s", answer.result.c_str());
+                continue;
+            }
+            mark_cancelled(answer.cancelled);
+            result.cancelled.insert(answer.cancelled.begin(), answer.cancelled.end());
+            result.currently_matching.insert(answer.currently_matching.begin(), answer.currently_matching.end());
+        }
+        return result;
+    }
+
+    cancel_result mm2_dex::cancel_all(const std::unordered_set<st_order_id> &ids)
+    {
+        MMBOT_TRACE_FUNCTION();
+        std::vector<st_order_id> uuids(ids.begin(), ids.end());
+        std::vector<mm2::cancel_order_request> requests;
+        requests.reserve(uuids.size());
+        for (auto &&uuid : uuids) {
+            requests.push_back(mm2::cancel_order_request{uuid});
+        }
+        auto answers = client_.rpc_batch<mm2::cancel_order_answer>("cancel_order", std::move(requests));
+        std::vector<std::string> cancelled;
+        std::vector<std::string> refused;
+        for (std::size_t idx = 0; idx < answers.size(); ++idx) {
+            (answers[idx].rpc_result_code == 200 ? cancelled : refused).push_back(uuids[idx]);
+        }
+        mark_cancelled(cancelled);
+        cancel_result result;
+        result.cancelled.insert(cancelled.begin(), cancelled.end());
+        if (!refused.empty()) {
+            //! mm2 refuses to cancel the orders in a swap, the sync tells which ones are.
+            sync();
+            for (auto &&uuid : refused) {
+                if (auto it = orders_.find(uuid); it != orders_.end() && !it->second.running_swaps.empty()) {
+                    result.currently_matching.insert(uuid);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<orders::order> mm2_dex::get_live_orders()
+    {
+        sync_if_stale();
+        std::vector<orders::order> live;
+        live.reserve(orders_.size());
+        for (auto &&[id, shadow] : orders_) {
+            live.push_back(shadow.order);
+        }
+        return live;
+    }
+
+    orders::order mm2_dex::get_order_status(const st_order_id &id)
+    {
+        sync_if_stale();
+        if (auto it = orders_.find(id); it != orders_.end()) {
+            return it->second.order;
+        }
+        if (auto archived = archive_.find(id); archived != nullptr) {
+            return *archived;
+        }
+        throw std::out_of_range("unknown mm2 order: " + id);
+    }
+
+    std::vector<orders::execution> mm2_dex::get_executions()
+    {
+        sync_if_stale();
+        std::vector<orders::execution> result;
+        for (auto &&[id, shadow] : orders_) {
+            result.insert(result.end(), shadow.executions.begin(), shadow.executions.end());
+        }
+        return result;
+    }
+
+    std::vector<orders::execution> mm2_dex::get_executions(const st_order_id &id)
+    {
+        sync_if_stale();
+        if (auto it = orders_.find(id); it != orders_.end()) {
+            return it->second.executions;
+        }
+        return {};
+    }
+
+    std::vector<orders::execution> mm2_dex::get_executions(const std::unordered_set<st_order_id> &ids)
+    {
+        sync_if_stale();
+        std::vector<orders::execution> result;
+        for (auto &&id : ids) {
+            if (auto it = orders_.find(id); it != orders_.end()) {
+                result.insert(result.end(), it->second.executions.begin(), it->second.executions.end());
+            }
+        }
+        return result;
+    }
+
+    std::vector<orders::execution> mm2_dex::get_recent_executions()
+    {
+        sync_if_stale();
+        std::vector<orders::execution> recent;
+        recent.swap(recent_executions_);
+        return recent;
+    }
+
+    mm2::orderbook_answer mm2_dex::get_orderbook(const antara::pair &pair)
+    {
+        return client_.rpc_orderbook(mm2::orderbook_request{pair});
+    }
+
+    void mm2_dex::sync_if_stale()
+    {
+        if (std::chrono::steady_clock::now() - last_sync_ >= options_.sync_interval) {
+            sync();
+        }
+    }
+
+    void mm2_dex::sync()
+    {
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = metrics::get_histogram("mmbot_mm2_dex_sync_latency_us");
+        metrics::scoped_timer timer(latency);
+        std::vector<mm2::swap_contents> swaps;
+        auto my_orders = attached_ ? client_.rpc_my_orders() : read_orders_and_swaps(swaps);
+        if (attached_) {
+            std::scoped_lock lock(feed_mutex_);
+            swaps.swap(feed_swaps_);
+        }
+        apply_swaps(swaps);
+        if (my_orders.rpc_result_code == 200) {
+            apply_orders(my_orders);
+        } else {
+            VLOG_F(loguru::Verbosity_WARNING, "mm2 my_orders failed: %s", my_orders.result.c_str());
+        }
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+
+    mm2::my_orders_answer mm2_dex::read_orders_and_swaps(std::vector<mm2::swap_contents> &swaps)
+    {
+        const auto page_size = options_.swaps_page_size;
+
+        //! the first page of swaps is fetched on a worker while my_orders is answered.
+        std::promise<mm2::my_recent_swaps_answer> first_page;
+        auto first_page_answer = first_page.get_future();
+        client_.async_call([this, page_size]() {
+            return client_.rpc_my_recent_swaps(mm2::my_recent_swaps_request{page_size});
+        }, [&first_page](auto &&answer) { first_page.set_value(std::forward<decltype(answer)>(answer)); });
+        auto my_orders = client_.rpc_my_orders();
+        auto page = first_page_answer.get();
+
+        std::unordered_set<std::string> running;
+        for (auto &&[id, shadow] : orders_) {
+            running.insert(shadow.running_swaps.begin(), shadow.running_swaps.end());
+        }
+        //! newest first, page until the already applied swaps and the running ones are reached.
+        std::vector<mm2::swap_contents> newest_first;
+        for (std::size_t nb_pages = 1; page.rpc_result_code == 200; ++nb_pages) {
+            bool reached_known = false;
+            for (auto &&swap : page.swaps) {
+                reached_known = reached_known || is_known_swap(swap.uuid);
+                running.erase(swap.uuid);
+            }
+            const bool full_page = !page.swaps.empty() && page.swaps.size() == page_size;
+            std::move(page.swaps.begin(), page.swaps.end(), std::back_inserter(newest_first));
+            if (!full_page || (reached_known && running.empty()) || nb_pages == options_.max_swaps_pages) {
+                break;
+            }
+            page = client_.rpc_my_recent_swaps(mm2::my_recent_swaps_request{page_size, newest_first.back().uuid});
+        }
+        if (page.rpc_result_code != 200) {
+            VLOG_F(loguru::Verbosity_WARNING, "mm2 my_recent_swaps failed: %s", page.result.c_str());
+        }
+        swaps.assign(std::make_move_iterator(newest_first.rbegin()), std::make_move_iterator(newest_first.rend()));
+        return my_orders;
+    }
+
+    void mm2_dex::apply_swaps(const std::vector<mm2::swap_contents> &swaps)
+    {
+        for (auto &&swap : swaps) {
+            if (is_known_swap(swap.uuid)) {
+                continue;
+            }
+            auto order_uuid = order_uuid_of(swap);
+            if (swap.my_order_uuid.empty()) {
+                if (auto it = order_of_swap_.find(swap.uuid); it != order_of_swap_.end()) {
+                    order_uuid = it->second;
+                }
+            }
+            auto it = orders_.find(order_uuid);
+            if (it == orders_.end()) {
+                continue;
+            }
+            auto &shadow = it->second;
+            if (!swap.finished && !swap.failed) {
+                shadow.running_swaps.insert(swap.uuid);
+                continue;
+            }
+            shadow.running_swaps.erase(swap.uuid);
+            order_of_swap_.erase(swap.uuid);
+            remember_swap(swap.uuid);
+            if (swap.failed) {
+                metrics::get_counter("mmbot_mm2_dex_failed_swaps_total").inc();
+                VLOG_F(loguru::Verbosity_WARNING, "swap %s of the order %s failed", swap.uuid.c_str(),
+                       order_uuid.c_str());
+                continue;
+            }
+            auto &o = shadow.order;
+            auto ex = to_execution(o, swap);
+            o.execute(ex);
+            o.add_execution_id(ex.id);
+            shadow.executions.push_back(ex);
+            recent_executions_.push_back(std::move(ex));
+        }
+    }
+
+    void mm2_dex::apply_orders(const mm2::my_orders_answer &answer)
+    {
+        const auto &cfg = get_mmbot_config();
+        std::unordered_set<std::string> present;
+        for (auto &&maker : answer.maker_orders) {
+            present.insert(maker.uuid);
+            auto it = orders_.find(maker.uuid);
+            if (it == orders_.end() && archive_.find(maker.uuid) == nullptr) {
+                //! placed by someone else on this mm2, it is an ask of base/rel.
+                const antara::pair pair{maker.rel, maker.base};
+                auto &o = add_order(maker.uuid, pair, orders::order_level{
+                        generate_st_price_from_api_price(cfg, maker.rel.symbol, maker.price),
+                        st_quantity{std::stod(maker.max_base_vol)}, side::sell});
+                it = orders_.find(o.id);
+            }
+            for (auto &&swap : maker.started_swaps) {
+                order_of_swap_.emplace(swap, maker.uuid);
+                if (it != orders_.end() && !is_known_swap(swap)) {
+                    it->second.running_swaps.insert(swap);
+                }
+            }
+        }
+        for (auto &&taker : answer.taker_orders) {
+            present.insert(taker.uuid);
+        }
+        for (auto it = orders_.begin(); it != orders_.end();) {
+            auto &shadow = it->second;
+            auto &o = shadow.order;
+            if (present.count(o.id) > 0) {
+                shadow.missing = false;
+            } else if (!shadow.running_swaps.empty()) {
+                //! matched, the swaps tell how it ends.
+            } else if (!shadow.executions.empty()) {
+                o.change_status(orders::order_status_change{o.id, orders::order_status::filled});
+            } else if (shadow.missing) {
+                //! missing twice: the swaps of the previous sync were read after its end, it was cancelled.
+                o.change_status(orders::order_status_change{o.id, orders::order_status::cancelled});
+            } else {
+                //! the swaps may have been read before it left my_orders, decided at the next sync.
+                shadow.missing = true;
+            }
+            it = orders::is_terminal(o.status) ? archive_order(it) : std::next(it);
+        }
+    }
+
+    orders::order &mm2_dex::add_order(st_order_id uuid, const antara::pair &pair, const orders::order_level &ol)
+    {
+        auto o = orders::order_builder(uuid, pair).price(ol.price).quantity(ol.quantity).side(ol.side).status(
+                orders::order_status::live).build();
+        if (attached_) {
+            std::scoped_lock lock(feed_mutex_);
+            feed_orders_.insert_or_assign(uuid, o);
+        }
+        auto it = orders_.insert_or_assign(std::move(uuid), shadow_order{std::move(o), {}, {}, false}).first;
+        return it->second.order;
+    }
+
+    mm2_dex::shadow_index::iterator mm2_dex::archive_order(shadow_index::iterator it)
+    {
+        for (auto &&swap : it->second.running_swaps) {
+            order_of_swap_.erase(swap);
+        }
+        if (attached_) {
+            std::scoped_lock lock(feed_mutex_);
+            feed_orders_.erase(it->first);
+        }
+        archive_.push(std::move(it->second.order));
+        return orders_.erase(it);
+    }
+
+    void mm2_dex::mark_cancelled(const std::vector<std::string> &uuids)
+    {
+        for (auto &&uuid : uuids) {
+            auto it = orders_.find(uuid);
+            if (it == orders_.end()) {
+                continue;
+            }
+            auto &o = it->second.order;
+            if (!o.change_status(orders::order_status_change{uuid, orders::order_status::cancelled})) {
+                VLOG_F(loguru::Verbosity_WARNING, "order %s: cancelled while %s", uuid.c_str(),
+                       orders::to_string(o.status));
+            }
+            archive_order(it);
+        }
+    }
+
+    bool mm2_dex::is_known_swap(const std::string &uuid) const
+    {
+        return known_swaps_.count(uuid) > 0;
+    }
+
+    void mm2_dex::remember_swap(const std::string &uuid)
+    {
+        if (!known_swaps_.insert(uuid).second) {
+            return;
+        }
+        known_swaps_order_.push_back(uuid);
+        if (known_swaps_order_.size() > known_swaps_capacity) {
+            known_swaps_.erase(known_swaps_order_.front());
+            known_swaps_order_.pop_front();
+        }
+    }
+}
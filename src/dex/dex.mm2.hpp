@@ -0,0 +1,157 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "mm2/mm2.client.hpp"
+#include "mm2/mm2.swap.feed.hpp"
+#include "orders/order.archive.hpp"
+#include "dex.hpp"
+
+namespace antara::mmbot
+{
+    struct mm2_dex_options
+    {
+        //! the shadow index is synced with mm2 when a read finds it older than this.
+        std::chrono::milliseconds sync_interval{500};
+        std::size_t archive_capacity{1024};
+        //! my_recent_swaps page size, and the number of pages read at most by a sync.
+        std::size_t swaps_page_size{50};
+        std::size_t max_swaps_pages{10};
+    };
+
+    /**
+     * @brief abstract_dex on top of a running mm2.
+     *        Asks are setprice orders on base/rel, bids are setprice orders on the inverted pair: mm2 makers only
+     *        sell their base. The orders are kept in a shadow index keyed by their mm2 uuid, synced from my_orders
+     *        and my_recent_swaps (both in flight at the same time), every finished swap of an order is one of its
+     *        executions. Placing and cancelling several orders is one JSON-RPC batch.
+     *        Not thread safe, like the order manager driving it, but for the swaps published by an attached feed.
+     */
+    class mm2_dex : public abstract_dex
+    {
+    public:
+        using execution_listener = std::function<void(const orders::execution &ex)>;
+
+        explicit mm2_dex(mm2_client &client, mm2_dex_options options = {});
+
+        //! the swaps come from `feed` instead of the syncs, before the feed starts.
+        void attach(mm2_swap_feed &feed);
+
+        //! called from the feed thread as soon as a swap of a known order finishes, before the feed starts.
+        //! The execution is also in the next get_recent_executions.
+        void add_execution_listener(execution_listener listener);
+
+        //! not_implemented, an mm2 order needs a pair.
+        orders::order &place(const orders::order_level &ol) override;
+        //! throws std::runtime_error if mm2 refuses the order, std::invalid_argument for side::both.
+        orders::order &place(const antara::pair &pair, const orders::order_level &ol) override;
+        //! one setprice batch, the levels refused by mm2 are left out.
+        std::vector<orders::order> place(const antara::pair &pair, const std::vector<orders::order_level> &levels) override;
+        //! take the offers of the book up to ol.price with a buy (taker) order.
+        orders::order &take(const antara::pair &pair, const orders::order_level &ol);
+        bool cancel(st_order_id id) override;
+        //! cancel_all_orders on base/rel and on rel/base in one batch.
+        cancel_result cancel_all(const antara::pair &pair) override;
+        //! one cancel_order batch.
+        cancel_result cancel_all(const std::unordered_set<st_order_id> &ids) override;
+
+        std::vector<orders::order> get_live_orders() override;
+        //! the finished orders are found in the archive, throws std::out_of_range for an unknown order.
+        orders::order get_order_status(const st_order_id &id) override;
+
+        std::vector<orders::execution> get_executions() override;
+        std::vector<orders::execution> get_executions(const st_order_id &id) override;
+        std::vector<orders::execution> get_executions(const std::unordered_set<st_order_id> &ids) override;
+        //! the executions found since the last call.
+        std::vector<orders::execution> get_recent_executions() override;
+
+        mm2::orderbook_answer get_orderbook(const antara::pair &pair);
+
+        //! sync the shadow index now, whatever its age.
+        void sync();
+
+        [[nodiscard]] const orders::order_archive &get_archive() const noexcept
+        {
+            return archive_;
+        }
+
+    private:
+        struct shadow_order
+        {
+            orders::order order;
+            std::vector<orders::execution> executions;
+            //! the started swaps that are not finished yet.
+            std::unordered_set<std::string> running_swaps;
+            //! absent from my_orders at the previous sync.
+            bool missing{false};
+        };
+
+        using shadow_index = std::unordered_map<st_order_id, shadow_order>;
+
+        void sync_if_stale();
+
+        //! my_orders, and the swaps since the last applied ones in `swaps` (the oldest first), pipelined.
+        mm2::my_orders_answer read_orders_and_swaps(std::vector<mm2::swap_contents> &swaps);
+
+        void apply_swaps(const std::vector<mm2::swap_contents> &swaps);
+
+        void apply_orders(const mm2::my_orders_answer &answer);
+
+        //! feed thread.
+        void on_swap(const mm2::swap_contents &swap);
+
+        orders::order &add_order(st_order_id uuid, const antara::pair &pair, const orders::order_level &ol);
+
+        //! terminal orders leave the index for the archive.
+        shadow_index::iterator archive_order(shadow_index::iterator it);
+
+        void mark_cancelled(const std::vector<std::string> &uuids);
+
+        bool is_known_swap(const std::string &uuid) const;
+
+        void remember_swap(const std::string &uuid);
+
+        mm2_client &client_;
+        mm2_dex_options options_;
+        shadow_index orders_;
+        orders::order_archive archive_;
+        //! the swaps of the maker orders, mm2 versions without my_order_uuid are matched with the started_swaps.
+        std::unordered_map<std::string, st_order_id> order_of_swap_;
+        //! finished or failed swaps already applied, bounded: the oldest are forgotten first.
+        std::unordered_set<std::string> known_swaps_;
+        std::deque<std::string> known_swaps_order_;
+        std::vector<orders::execution> recent_executions_;
+        std::chrono::steady_clock::time_point last_sync_{};
+
+        bool attached_{false};
+        std::vector<execution_listener> execution_listeners_;
+        //! guards what the feed thread shares with the dex: the orders it maps the swaps to, and its swaps until the
+        //! next sync applies them.
+        std::mutex feed_mutex_;
+        std::unordered_map<st_order_id, orders::order> feed_orders_;
+        std::vector<mm2::swap_contents> feed_swaps_;
+    };
+}
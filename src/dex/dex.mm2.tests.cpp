@@ -0,0 +1,238 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+#include "config/config.hpp"
+#include "mm2/mm2.mock.server.hpp"
+#include "dex/dex.mm2.hpp"
+#include "price/fair.value.hpp"
+
+namespace antara::mmbot::tests
+{
+    namespace
+    {
+        const antara::pair rick_morty{{st_symbol{"MORTY"}}, {st_symbol{"RICK"}}};
+
+        //! prices and quantities of RICK/MORTY, both coins have 8 decimals.
+        orders::order_level level(std::uint64_t price, double quantity, antara::side side)
+        {
+            return orders::order_level{st_price{price}, st_quantity{quantity}, side};
+        }
+
+        mm2_dex_options synced_on_every_read()
+        {
+            mm2_dex_options options;
+            options.sync_interval = std::chrono::milliseconds{0};
+            return options;
+        }
+
+        //! a mock mm2 on `port` with the config pointing at it while it lives.
+        struct mock_mm2_scope
+        {
+            explicit mock_mm2_scope(unsigned short port) : server(make_options(port))
+            {
+                load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+                server.start();
+                auto cfg = get_mmbot_config();
+                cfg.mm2_endpoint = server.endpoint();
+                set_mmbot_config(cfg);
+            }
+
+            ~mock_mm2_scope()
+            {
+                server.stop();
+                load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+            }
+
+            static mock_mm2_options make_options(unsigned short port)
+            {
+                mock_mm2_options options;
+                options.port = port;
+                return options;
+            }
+
+            mock_mm2_server server;
+        };
+    }
+
+    TEST_CASE ("mm2 dex places the asks and the inverted bids in one batch")
+    {
+        mock_mm2_scope mock(7791);
+        mm2_client client(false);
+        mm2_dex dex(client, synced_on_every_read());
+
+        const auto nb_requests = mock.server.nb_requests();
+        auto placed = dex.place(rick_morty, {level(50000000, 10.0, antara::side::buy),
+                                             level(100000000, 4.0, antara::side::sell)});
+        REQUIRE_EQ(2, placed.size());
+        CHECK_EQ(nb_requests + 1, mock.server.nb_requests());
+        CHECK_EQ(orders::order_status::live, placed[0].status);
+        CHECK_EQ(rick_morty, placed[0].pair);
+
+        auto my_orders = client.rpc_my_orders();
+        REQUIRE_EQ(2, my_orders.maker_orders.size());
+        for (auto &&maker : my_orders.maker_orders) {
+            if (maker.uuid == placed[0].id) {
+                //! the bid sells 5 MORTY for RICK at 2 RICK per MORTY.
+                CHECK_EQ("MORTY", maker.base.symbol.value());
+                CHECK_EQ("2.00000000", maker.price);
+                CHECK_EQ("5.00000000", maker.max_base_vol);
+            } else {
+                CHECK_EQ("RICK", maker.base.symbol.value());
+                CHECK_EQ("1.00000000", maker.price);
+                CHECK_EQ("4.00000000", maker.max_base_vol);
+            }
+        }
+        CHECK_EQ(2, dex.get_live_orders().size());
+        CHECK_THROWS_AS(dex.place(rick_morty, level(100000000, 1.0, antara::side::both)), std::invalid_argument);
+    }
+
+    TEST_CASE ("mm2 dex maps the swaps of its orders to executions")
+    {
+        mock_mm2_scope mock(7792);
+        mm2_client client(false);
+        mm2_dex dex(client, synced_on_every_read());
+
+        auto ask_id = dex.place(rick_morty, level(100000000, 4.0, antara::side::sell)).id;
+        auto bid_id = dex.place(rick_morty, level(50000000, 10.0, antara::side::buy)).id;
+        auto ask_swap = mock.server.fill_order(ask_id);
+        auto bid_swap = mock.server.start_swap(bid_id);
+
+        auto executions = dex.get_recent_executions();
+        REQUIRE_EQ(1, executions.size());
+        CHECK_EQ(ask_swap, executions[0].id);
+        CHECK_EQ(doctest::Approx(4.0), executions[0].quantity.value());
+        CHECK_EQ(antara::side::sell, executions[0].side);
+        CHECK(executions[0].maker);
+        CHECK_EQ(orders::order_status::filled, dex.get_order_status(ask_id).status);
+        CHECK_EQ(orders::order_status::live, dex.get_order_status(bid_id).status);
+        CHECK_EQ(1, dex.get_archive().size());
+
+        mock.server.finish_swap(bid_swap);
+        executions = dex.get_recent_executions();
+        REQUIRE_EQ(1, executions.size());
+        //! the bid is filled in RICK, the other coin of its swap.
+        CHECK_EQ(doctest::Approx(10.0), executions[0].quantity.value());
+        CHECK_EQ(antara::side::buy, executions[0].side);
+        CHECK_EQ(orders::order_status::filled, dex.get_order_status(bid_id).status);
+        CHECK(dex.get_recent_executions().empty());
+        CHECK(dex.get_live_orders().empty());
+    }
+
+    TEST_CASE ("mm2 dex cancels in batches and reports the orders in a swap")
+    {
+        mock_mm2_scope mock(7793);
+        mm2_client client(false);
+        mm2_dex dex(client, synced_on_every_read());
+
+        auto placed = dex.place(rick_morty, {level(50000000, 10.0, antara::side::buy),
+                                             level(100000000, 4.0, antara::side::sell),
+                                             level(110000000, 4.0, antara::side::sell)});
+        REQUIRE_EQ(3, placed.size());
+        mock.server.start_swap(placed[1].id);
+
+        auto result = dex.cancel_all(std::unordered_set<st_order_id>{placed[0].id, placed[1].id});
+        CHECK_EQ(std::unordered_set<st_order_id>{placed[0].id}, result.cancelled);
+        CHECK_EQ(std::unordered_set<st_order_id>{placed[1].id}, result.currently_matching);
+        CHECK_EQ(orders::order_status::cancelled, dex.get_order_status(placed[0].id).status);
+
+        result = dex.cancel_all(rick_morty);
+        CHECK_EQ(std::unordered_set<st_order_id>{placed[2].id}, result.cancelled);
+        CHECK_EQ(std::unordered_set<st_order_id>{placed[1].id}, result.currently_matching);
+        CHECK_EQ(1, mock.server.nb_live_orders());
+        CHECK_FALSE(dex.cancel(placed[1].id));
+    }
+
+    TEST_CASE ("mm2 dex follows the orders changed outside of it")
+    {
+        mock_mm2_scope mock(7794);
+        mm2_client client(false);
+        mm2_dex dex(client, synced_on_every_read());
+
+        auto id = dex.place(rick_morty, level(100000000, 4.0, antara::side::sell)).id;
+        CHECK_EQ(200, client.rpc_cancel_order(mm2::cancel_order_request{id}).rpc_result_code);
+        //! gone without a swap: cancelled once a second sync confirms it.
+        CHECK_EQ(orders::order_status::live, dex.get_order_status(id).status);
+        CHECK_EQ(orders::order_status::cancelled, dex.get_order_status(id).status);
+
+        auto adopted = client.rpc_setprice(mm2::setprice_request{{st_symbol{"RICK"}}, {st_symbol{"MORTY"}}, "1.5", "2",
+                                                                 std::nullopt, false});
+        auto live = dex.get_live_orders();
+        REQUIRE_EQ(1, live.size());
+        CHECK_EQ(adopted.result_setprice.uuid, live[0].id);
+        CHECK_EQ(rick_morty, live[0].pair);
+        CHECK_EQ(antara::side::sell, live[0].side);
+        CHECK_EQ(st_price{150000000}, live[0].price);
+        CHECK_EQ(doctest::Approx(2.0), live[0].quantity.value());
+    }
+
+    TEST_CASE ("mm2 dex pushes the executions of the swaps published by its feed")
+    {
+        mock_mm2_scope mock(7797);
+        mm2_client client(false);
+        mm2_swap_feed feed(client);
+        mm2_dex dex(client, synced_on_every_read());
+        std::vector<orders::execution> pushed;
+        dex.attach(feed);
+        dex.add_execution_listener([&pushed](const orders::execution &ex) { pushed.push_back(ex); });
+        feed.poll();
+
+        auto bid_id = dex.place(rick_morty, level(50000000, 10.0, antara::side::buy)).id;
+        auto swap = mock.server.start_swap(bid_id);
+        feed.poll();
+        CHECK(pushed.empty());
+        CHECK_EQ(orders::order_status::live, dex.get_order_status(bid_id).status);
+
+        mock.server.finish_swap(swap);
+        feed.poll();
+        REQUIRE_EQ(1, pushed.size());
+        CHECK_EQ(swap, pushed[0].id);
+        CHECK_EQ(doctest::Approx(10.0), pushed[0].quantity.value());
+        CHECK_EQ(antara::side::buy, pushed[0].side);
+        CHECK_EQ(orders::order_status::filled, dex.get_order_status(bid_id).status);
+        CHECK_EQ(1, dex.get_recent_executions().size());
+    }
+
+    TEST_CASE ("fair value service follows the executions of an attached mm2 dex")
+    {
+        mock_mm2_scope mock(7798);
+        mm2_client client(false);
+        mm2_swap_feed feed(client);
+        mm2_dex dex(client, synced_on_every_read());
+        struct no_reference
+        {
+            st_price get_price(const antara::pair &) const
+            {
+                throw std::runtime_error("no reference");
+            }
+        } reference;
+        fair_value_service<no_reference> fair_value(reference);
+        dex.attach(feed);
+        fair_value.attach(dex);
+        feed.poll();
+
+        auto bid_id = dex.place(rick_morty, level(50000000, 10.0, antara::side::buy)).id;
+        auto swap = mock.server.start_swap(bid_id);
+        feed.poll();
+        CHECK_FALSE(fair_value.get_snapshot(rick_morty).has_value());
+        mock.server.finish_swap(swap);
+        feed.poll();
+        auto snapshot = fair_value.get_snapshot(rick_morty);
+        REQUIRE(snapshot.has_value());
+        CHECK(snapshot->execution_ewma.has_value());
+        CHECK_EQ(snapshot->execution_ewma, snapshot->fair_value);
+    }
+}
@@ -28,8 +28,13 @@ namespace antara::mmbot
     class dex_mock : public dex
     {
     public:
+        using dex::place;
+
         MAKE_MOCK1(place, orders::order&(const orders::order_level&), override);
+        MAKE_MOCK2(place, orders::order&(const antara::pair&, const orders::order_level&), override);
         MAKE_MOCK1(cancel, bool(st_order_id), override);
+        MAKE_MOCK1(cancel_all, cancel_result(const antara::pair&), override);
+        MAKE_MOCK1(cancel_all, cancel_result(const std::unordered_set<st_order_id>&), override);
 
         MAKE_MOCK0(get_live_orders, std::vector<orders::order>(), override);
         MAKE_MOCK1(get_order_status, orders::order(const st_order_id&), override);
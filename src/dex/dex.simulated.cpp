@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "dex.simulated.hpp"
+
+#include <utils/exceptions.hpp>
+#include <utils/pretty_function.hpp>
+
+namespace antara::mmbot
+{
+    simulated_dex::simulated_dex(simulation::matching_engine &engine) noexcept : engine_(engine)
+    {
+    }
+
+    orders::order &simulated_dex::place([[maybe_unused]] const orders::order_level &ol)
+    {
+        throw mmbot::errors::not_implemented(std::string(pretty_function) + ": the simulated book requires a pair");
+    }
+
+    orders::order &simulated_dex::place(const antara::pair &pair, const orders::order_level &ol)
+    {
+        return engine_.submit(pair, ol);
+    }
+
+    bool simulated_dex::cancel(st_order_id id)
+    {
+        return engine_.cancel(id);
+    }
+
+    cancel_result simulated_dex::cancel_all(const antara::pair &pair)
+    {
+        auto ids = engine_.cancel_all(pair);
+        return cancel_result{std::unordered_set<st_order_id>(ids.begin(), ids.end()), {}};
+    }
+
+    cancel_result simulated_dex::cancel_all(const std::unordered_set<st_order_id> &ids)
+    {
+        cancel_result result;
+        for (auto &&id : ids) {
+            if (engine_.cancel(id)) {
+                result.cancelled.insert(id);
+            }
+        }
+        return result;
+    }
+
+    std::vector<orders::order> simulated_dex::get_live_orders()
+    {
+        return engine_.get_live_orders();
+    }
+
+    orders::order simulated_dex::get_order_status(const st_order_id &id)
+    {
+        return engine_.get_order(id);
+    }
+
+    std::vector<orders::execution> simulated_dex::get_executions()
+    {
+        return engine_.get_executions();
+    }
+
+    std::vector<orders::execution> simulated_dex::get_executions(const st_order_id &id)
+    {
+        return engine_.get_executions(id);
+    }
+
+    std::vector<orders::execution> simulated_dex::get_executions(const std::unordered_set<st_order_id> &ids)
+    {
+        std::vector<orders::execution> result;
+        for (auto &&id : ids) {
+            auto current = engine_.get_executions(id);
+            std::move(current.begin(), current.end(), std::back_inserter(result));
+        }
+        return result;
+    }
+
+    std::vector<orders::execution> simulated_dex::get_recent_executions()
+    {
+        return engine_.drain_recent_executions();
+    }
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <simulation/matching.engine.hpp>
+#include "dex.hpp"
+
+namespace antara::mmbot
+{
+    class simulated_dex : public abstract_dex
+    {
+    public:
+        explicit simulated_dex(simulation::matching_engine &engine) noexcept;
+
+        using abstract_dex::place;
+
+        orders::order &place(const orders::order_level &ol) override;
+        orders::order &place(const antara::pair &pair, const orders::order_level &ol) override;
+        bool cancel(st_order_id id) override;
+        cancel_result cancel_all(const antara::pair &pair) override;
+        cancel_result cancel_all(const std::unordered_set<st_order_id> &ids) override;
+
+        std::vector<orders::order> get_live_orders() override;
+        orders::order get_order_status(const st_order_id &id) override;
+
+        std::vector<orders::execution> get_executions() override;
+        std::vector<orders::execution> get_executions(const st_order_id &id) override;
+        std::vector<orders::execution> get_executions(const std::unordered_set<st_order_id> &ids) override;
+        std::vector<orders::execution> get_recent_executions() override;
+
+    private:
+        simulation::matching_engine &engine_;
+    };
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include "metrics/metrics.hpp"
+#include "http/http.body.hpp"
+
+namespace
+{
+    std::string_view trimmed(std::string_view value) noexcept
+    {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+
+    //! If-None-Match uses the weak comparison, W/"x" designates "x".
+    std::string_view opaque_tag(std::string_view tag) noexcept
+    {
+        if (tag.substr(0, 2) == "W/") {
+            tag.remove_prefix(2);
+        }
+        return tag;
+    }
+}
+
+namespace antara::mmbot::http
+{
+    std::string etag_of(std::string_view body)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (auto cur_char : body) {
+            hash ^= static_cast<unsigned char>(cur_char);
+            hash *= 0x100000001b3ull;
+        }
+        char etag[64];
+        std::snprintf(etag, sizeof(etag), "\"%zx-%016llx\"", body.size(), static_cast<unsigned long long>(hash));
+        return etag;
+    }
+
+    bool if_none_match_holds(std::string_view if_none_match, std::string_view etag) noexcept
+    {
+        if (etag.empty()) {
+            return false;
+        }
+        while (!if_none_match.empty()) {
+            const auto comma = if_none_match.find(',');
+            const auto tag = trimmed(if_none_match.substr(0, comma));
+            if (tag == "*" || (!tag.empty() && opaque_tag(tag) == opaque_tag(etag))) {
+                return true;
+            }
+            if_none_match = comma == std::string_view::npos ? std::string_view{} : if_none_match.substr(comma + 1);
+        }
+        return false;
+    }
+
+    restinio::request_handling_status_t
+    reply_with_body(const restinio::request_handle_t &req, restinio::http_status_line_t status, shared_body body,
+                    const std::string &etag, const char *content_type)
+    {
+        if (!etag.empty() && req->header().has_field(restinio::http_field::if_none_match) &&
+            if_none_match_holds(req->header().get_field(restinio::http_field::if_none_match), etag)) {
+            static auto &not_modified = metrics::get_counter("mmbot_http_not_modified_total");
+            not_modified.inc();
+            return req->create_response(restinio::status_not_modified()).append_header(restinio::http_field::etag,
+                                                                                       etag).done();
+        }
+        if (body->size() <= chunk_size) {
+            auto response = req->create_response(status);
+            response.append_header(restinio::http_field::content_type, content_type);
+            if (!etag.empty()) {
+                response.append_header(restinio::http_field::etag, etag);
+            }
+            return response.set_body(std::move(body)).done();
+        }
+        //! big answers, e.g. a full orderbook, are streamed by slices of the shared body instead of one buffer.
+        auto response = req->create_response<restinio::chunked_output_t>(status);
+        response.append_header(restinio::http_field::content_type, content_type);
+        if (!etag.empty()) {
+            response.append_header(restinio::http_field::etag, etag);
+        }
+        for (std::size_t offset = 0; offset < body->size(); offset += chunk_size) {
+            const auto length = std::min(chunk_size, body->size() - offset);
+            response.append_chunk(std::make_shared<body_slice>(body_slice{body, offset, length}));
+        }
+        return response.done();
+    }
+
+    versioned_body::entry versioned_body::get(std::uint64_t version, const serializer &serialize)
+    {
+        std::scoped_lock lock(mutex_);
+        if (!last_.has_value() || last_->version != version) {
+            auto body = std::make_shared<const std::string>(serialize());
+            auto etag = etag_of(*body);
+            last_ = entry{version, std::move(body), std::move(etag)};
+        }
+        return *last_;
+    }
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <restinio/all.hpp>
+
+namespace antara::mmbot::http
+{
+    //! a serialized answer shared between the cache and the responses in flight, never copied into restinio.
+    using shared_body = std::shared_ptr<const std::string>;
+
+    //! bodies above this size are streamed as chunks of this size.
+    inline constexpr std::size_t chunk_size = 64 * 1024;
+
+    //! a part of a shared body handed to restinio as a chunk, it keeps the whole body alive until written.
+    struct body_slice
+    {
+        const char *data() const noexcept
+        {
+            return body->data() + offset;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return length;
+        }
+
+        shared_body body;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    //! strong validator of `body`: its size and a hash of its bytes, quoted.
+    std::string etag_of(std::string_view body);
+
+    //! whether an If-None-Match header value designates `etag`, weak validators and `*` included.
+    bool if_none_match_holds(std::string_view if_none_match, std::string_view etag) noexcept;
+
+    //! answer `req` with `body`, a 304 when the client already has `etag`, an empty `etag` disables validation.
+    restinio::request_handling_status_t
+    reply_with_body(const restinio::request_handle_t &req, restinio::http_status_line_t status, shared_body body,
+                    const std::string &etag, const char *content_type = "application/json");
+
+    //! the last serialization of a versioned document, serialized again only when the version changes.
+    class versioned_body
+    {
+    public:
+        struct entry
+        {
+            std::uint64_t version;
+            shared_body body;
+            std::string etag;
+        };
+
+        using serializer = std::function<std::string()>;
+
+        //! the body of `version`, `serialize` is called only if the cached one is of another version.
+        entry get(std::uint64_t version, const serializer &serialize);
+
+    private:
+        std::mutex mutex_;
+        std::optional<entry> last_;
+    };
+}
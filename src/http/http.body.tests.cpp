@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <string>
+#include <doctest/doctest.h>
+#include "http/http.body.hpp"
+
+namespace antara::mmbot::http::tests
+{
+    TEST_CASE ("etag of a body changes with its content")
+    {
+        auto etag = etag_of(R"({"KMD":{"BTC":"0.0001"}})");
+        CHECK_EQ(etag, etag_of(R"({"KMD":{"BTC":"0.0001"}})"));
+        CHECK_NE(etag, etag_of(R"({"KMD":{"BTC":"0.0002"}})"));
+        CHECK_EQ(etag.front(), '"');
+        CHECK_EQ(etag.back(), '"');
+    }
+
+    TEST_CASE ("if none match holds for the etag, a list containing it, its weak form and *")
+    {
+        const std::string etag = etag_of("body");
+        CHECK(if_none_match_holds(etag, etag));
+        CHECK(if_none_match_holds("\"other\", " + etag, etag));
+        CHECK(if_none_match_holds("W/" + etag, etag));
+        CHECK(if_none_match_holds(" * ", etag));
+        CHECK_FALSE(if_none_match_holds("\"other\"", etag));
+        CHECK_FALSE(if_none_match_holds("", etag));
+        CHECK_FALSE(if_none_match_holds(",,", etag));
+        CHECK_FALSE(if_none_match_holds("*", ""));
+    }
+
+    TEST_CASE ("versioned body serializes once per version")
+    {
+        versioned_body cache;
+        std::size_t nb_serializations = 0;
+        auto serialize = [&nb_serializations]() {
+            ++nb_serializations;
+            return "prices v" + std::to_string(nb_serializations);
+        };
+        auto first = cache.get(1, serialize);
+        auto again = cache.get(1, serialize);
+        CHECK_EQ(nb_serializations, 1);
+        CHECK_EQ(first.body, again.body);
+        CHECK_EQ(first.etag, again.etag);
+        CHECK_EQ(*first.body, "prices v1");
+
+        auto next = cache.get(2, serialize);
+        CHECK_EQ(nb_serializations, 2);
+        CHECK_EQ(*next.body, "prices v2");
+        CHECK_NE(first.etag, next.etag);
+        CHECK_EQ(*first.body, "prices v1");
+    }
+}
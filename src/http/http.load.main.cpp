@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <restclient-cpp/connection.h>
+#include <restclient-cpp/restclient.h>
+
+namespace
+{
+    struct load_result
+    {
+        std::size_t nb_requests{0};
+        std::size_t nb_errors{0};
+        std::vector<double> latencies_ms;
+    };
+
+    double percentile(std::vector<double> &values, double ratio)
+    {
+        if (values.empty()) {
+            return 0.0;
+        }
+        auto idx = static_cast<std::size_t>(ratio * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + idx, values.end());
+        return values[idx];
+    }
+
+    load_result run_client(const std::string &base, const std::string &target,
+                           std::chrono::steady_clock::time_point deadline)
+    {
+        load_result result;
+        RestClient::Connection connection(base);
+        connection.SetTimeout(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto start = std::chrono::steady_clock::now();
+            auto resp = connection.get(target);
+            auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+            ++result.nb_requests;
+            if (resp.code != 200) {
+                ++result.nb_errors;
+            }
+            result.latencies_ms.push_back(elapsed.count());
+        }
+        return result;
+    }
+
+    nlohmann::json run_level(const std::string &base, const std::string &target, std::size_t concurrency,
+                             std::chrono::seconds duration)
+    {
+        std::vector<load_result> results(concurrency);
+        std::vector<std::thread> clients;
+        auto deadline = std::chrono::steady_clock::now() + duration;
+        for (std::size_t idx = 0; idx < concurrency; ++idx) {
+            clients.emplace_back([&results, idx, &base, &target, deadline]() {
+                results[idx] = run_client(base, target, deadline);
+            });
+        }
+        for (auto &&client : clients) {
+            client.join();
+        }
+        load_result total;
+        for (auto &&result : results) {
+            total.nb_requests += result.nb_requests;
+            total.nb_errors += result.nb_errors;
+            total.latencies_ms.insert(total.latencies_ms.end(), result.latencies_ms.begin(),
+                                      result.latencies_ms.end());
+        }
+        auto requests_per_sec = static_cast<double>(total.nb_requests) / static_cast<double>(duration.count());
+        return {{"concurrency", concurrency},
+                {"requests", total.nb_requests},
+                {"errors", total.nb_errors},
+                {"requests_per_sec", requests_per_sec},
+                {"p50_ms", percentile(total.latencies_ms, 0.50)},
+                {"p99_ms", percentile(total.latencies_ms, 0.99)}};
+    }
+}
+
+//! Hammer one endpoint of a running mmbot with an increasing number of keep-alive clients.
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <url> [duration_seconds] [concurrency...]\n"
+                  << "example: " << argv[0]
+                  << " \"http://localhost:7777/api/v1/getprice?base_currency=KMD&quote_currency=BTC\" 10 1 2 4 8\n";
+        return 1;
+    }
+    std::string url = argv[1];
+    auto scheme_end = url.find("://");
+    auto path_start = url.find('/', scheme_end == std::string::npos ? 0 : scheme_end + 3);
+    std::string base = path_start == std::string::npos ? url : url.substr(0, path_start);
+    std::string target = path_start == std::string::npos ? "/" : url.substr(path_start);
+    std::chrono::seconds duration{argc > 2 ? std::atoi(argv[2]) : 10};
+    std::vector<std::size_t> levels;
+    for (int idx = 3; idx < argc; ++idx) {
+        levels.push_back(static_cast<std::size_t>(std::atoi(argv[idx])));
+    }
+    if (levels.empty()) {
+        const std::size_t max_concurrency = std::max(1u, std::thread::hardware_concurrency()) * 2u;
+        for (std::size_t concurrency = 1; concurrency <= max_concurrency; concurrency *= 2) {
+            levels.push_back(concurrency);
+        }
+    }
+
+    RestClient::init();
+    nlohmann::json report = nlohmann::json::array();
+    for (auto concurrency : levels) {
+        auto level = run_level(base, target, concurrency, duration);
+        std::cerr << level.dump() << std::endl;
+        report.push_back(level);
+    }
+    RestClient::disable();
+    std::cout << report.dump(4) << std::endl;
+    return 0;
+}
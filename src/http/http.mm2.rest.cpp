@@ -14,6 +14,7 @@
  *                                                                            *
  ******************************************************************************/
 
+#include "tracing/tracing.hpp"
 #include "http.mm2.rest.hpp"
 
 namespace antara::mmbot::http::rest
@@ -31,7 +32,7 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     mm2::get_orderbook(const restinio::request_handle_t &req, const restinio::router::route_params_t &)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/getorderbook");
         const auto query_params = restinio::parse_query(req->header().query());
         if (query_params.size() != 2) {
@@ -46,17 +47,16 @@ namespace antara::mmbot::http::rest
         antara::mmbot::mm2::orderbook_request orderbook_request{
                 antara::pair::of(std::string(query_params["quote_currency"]),
                                  std::string(query_params["base_currency"]))};
-        auto orderbook_answer = mm2_client_.rpc_orderbook(std::move(orderbook_request));
-        auto answer_json = nlohmann::json::parse(orderbook_answer.result);
-        auto final_status = restinio::http_status_line_t(
-                static_cast<restinio::http_status_code_t>(orderbook_answer.rpc_result_code), "");
-        return req->create_response(final_status).set_body(answer_json.dump()).done();
+        mm2_client_.async_call([this, orderbook_request]() mutable {
+            return this->mm2_client_.rpc_orderbook(std::move(orderbook_request));
+        }, [req](auto &&answer) { reply_with_answer(req, std::move(answer), true); });
+        return restinio::request_accepted();
     }
 
     restinio::request_handling_status_t
     mm2::my_balance(const restinio::request_handle_t &req, const restinio::router::route_params_t &)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/my_balance");
         const auto query_params = restinio::parse_query(req->header().query());
         if (query_params.size() != 1) {
@@ -70,29 +70,26 @@ namespace antara::mmbot::http::rest
         }
         antara::mmbot::mm2::balance_request balance_request{
                 antara::asset{st_symbol{std::string(query_params["currency"])}}};
-        auto balance_answer = mm2_client_.rpc_balance(std::move(balance_request));
-        auto answer_json = nlohmann::json::parse(balance_answer.result);
-        auto final_status = restinio::http_status_line_t(
-                static_cast<restinio::http_status_code_t>(balance_answer.rpc_result_code), "");
-        return req->create_response(final_status).set_body(answer_json.dump()).done();
+        mm2_client_.async_call([this, balance_request]() mutable {
+            return this->mm2_client_.rpc_balance(std::move(balance_request));
+        }, [req](auto &&answer) { reply_with_answer(req, std::move(answer), true); });
+        return restinio::request_accepted();
     }
 
     restinio::request_handling_status_t
     mm2::version(const restinio::request_handle_t &req, const restinio::router::route_params_t &)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/version");
-        auto version_answer = mm2_client_.rpc_version();
-        auto answer_json = nlohmann::json::parse(version_answer.result);
-        auto final_status = restinio::http_status_line_t(
-                static_cast<restinio::http_status_code_t>(version_answer.rpc_result_code), "");
-        return req->create_response(final_status).set_body(answer_json.dump()).done();
+        mm2_client_.async_call([this]() { return this->mm2_client_.rpc_version(); },
+                               [req](auto &&answer) { reply_with_answer(req, std::move(answer), true); });
+        return restinio::request_accepted();
     }
 
     restinio::request_handling_status_t
     mm2::set_price(const restinio::request_handle_t &req, const restinio::router::route_params_t &params)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/setprice");
         return process_post_function<antara::mmbot::mm2::setprice_request>(req, params, [this](auto &&request) {
             return this->mm2_client_.rpc_setprice(
@@ -103,7 +100,7 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     mm2::cancel_order(const restinio::request_handle_t &req, const restinio::router::route_params_t &params)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/cancel_order");
         return process_post_function<antara::mmbot::mm2::cancel_order_request>(req, params,
                                                                                [this](auto &&request) {
@@ -116,7 +113,7 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     mm2::buy(const restinio::request_handle_t &req, const restinio::router::route_params_t &params)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/buy");
         return process_post_function<antara::mmbot::mm2::buy_request>(req, params, [this](auto &&request) {
             return this->mm2_client_.rpc_buy(
@@ -127,7 +124,7 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     mm2::cancel_all_orders(const restinio::request_handle_t &req, const restinio::router::route_params_t &params)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/legacy/mm2/cancel_all_orders");
         return process_post_function<antara::mmbot::mm2::cancel_all_orders_request>(req, params, [this](auto &&request) {
             return this->mm2_client_.rpc_cancel_all_orders(
@@ -20,6 +20,7 @@
 #include <restinio/common_types.hpp>
 #include "config/config.hpp"
 #include "mm2/mm2.client.hpp"
+#include "http/http.body.hpp"
 
 namespace antara::mmbot::http::rest
 {
@@ -51,27 +52,41 @@ namespace antara::mmbot::http::rest
         restinio::request_handling_status_t
         cancel_order(const restinio::request_handle_t &req, const restinio::router::route_params_t &params);
 
+        //! Answer `req` with the status and body of an mm2 rpc answer, can be called from any thread.
+        //! The body is validated but sent as received, a big orderbook is streamed without being copied.
+        //! Only a `cacheable` answer, the one of a read only rpc, gets an ETag and may be a 304.
+        template<typename TAnswer>
+        static restinio::request_handling_status_t
+        reply_with_answer(const restinio::request_handle_t &req, TAnswer answer, bool cacheable)
+        {
+            if (!nlohmann::json::accept(answer.result)) {
+                VLOG_F(loguru::Verbosity_ERROR, "mm2 answer is not json: %s", answer.result.c_str());
+                return req->create_response(restinio::status_internal_server_error()).set_body(answer.result).done();
+            }
+            auto final_status = restinio::http_status_line_t(
+                    static_cast<restinio::http_status_code_t>(answer.rpc_result_code), "");
+            auto body = std::make_shared<const std::string>(std::move(answer.result));
+            auto etag = cacheable && answer.rpc_result_code == 200 ? http::etag_of(*body) : std::string{};
+            return http::reply_with_body(req, final_status, std::move(body), etag);
+        }
+
+        //! The request is parsed on the server thread, the rpc runs on the mm2 client workers and completes `req`.
+        //! The rpc changes the state of mm2, its answer is never cached.
         template<typename TRequest, typename Functor>
         restinio::request_handling_status_t process_post_function(const restinio::request_handle_t &req, const restinio::router::route_params_t &, Functor&& rpc_functor)
         {
-            nlohmann::json json_answer;
-            auto status = restinio::status_ok();
+            TRequest request;
             try {
                 auto json_data = nlohmann::json::parse(req->body());
-                TRequest request;
                 mmbot::mm2::from_json(json_data, request);
-                auto answer = rpc_functor(std::move(request));
-                status = restinio::http_status_line_t(
-                        static_cast<restinio::http_status_code_t>(answer.rpc_result_code), "");
-                json_answer = nlohmann::json::parse(answer.result);
             }
             catch (const nlohmann::json::exception &error) {
                 VLOG_SCOPE_F(loguru::Verbosity_ERROR, "json error: %s", error.what());
                 return req->create_response(restinio::status_bad_request()).set_body(error.what()).done();
             }
-            return req->create_response(status).append_header(restinio::http_field::content_type,
-                                                              "application/json").set_body(
-                    json_answer.dump()).done();
+            mm2_client_.async_call([rpc_functor, request]() mutable { return rpc_functor(std::move(request)); },
+                                   [req](auto &&answer) { reply_with_answer(req, std::move(answer), false); });
+            return restinio::request_accepted();
         }
 
     private:
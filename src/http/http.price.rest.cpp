@@ -16,11 +16,14 @@
 
 #include <price/exceptions.price.platform.hpp>
 #include <utils/antara.utils.hpp>
+#include <tracing/tracing.hpp>
 #include "http.price.rest.hpp"
 
 namespace antara::mmbot::http::rest
 {
-    price::price(price_service_platform &price_service) noexcept : price_service_(price_service)
+    price::price(price_service_platform &price_service) noexcept :
+            price_service_(price_service),
+            price_cache_(price_service, std::chrono::milliseconds{get_mmbot_config().price_cache_ttl_ms})
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
     }
@@ -33,7 +36,7 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     price::get_price(const restinio::request_handle_t& req, const restinio::router::route_params_t &)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/getprice");
         const auto query_params = restinio::parse_query(req->header().query());
         if (query_params.size() != 2) {
@@ -50,12 +53,12 @@ namespace antara::mmbot::http::rest
         st_price price{0ull};
         nlohmann::json answer_json;
         try {
-            price = price_service_.get_price(currency_pair);
+            price = price_cache_.get_price(currency_pair);
             answer_json = {{"price", get_price_as_string_decimal(get_mmbot_config(), currency_pair.base.symbol, currency_pair.quote.symbol, price)}};
         }
         catch (const antara::mmbot::errors::pair_not_available& e) {
             nlohmann::json error_json = {"errors", e.what()};
-            req->create_response(restinio::status_internal_server_error()).set_body(error_json.dump()).done();
+            return req->create_response(restinio::status_internal_server_error()).set_body(error_json.dump()).done();
         }
         return req->create_response(restinio::status_ok()).set_body(answer_json.dump()).done();
     }
@@ -63,9 +66,20 @@ namespace antara::mmbot::http::rest
     restinio::request_handling_status_t
     price::get_all_prices(const restinio::request_handle_t &req, const restinio::router::route_params_t &)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/getallprice");
-        auto answer_json = price_service_.get_price_registry();
+        auto all_prices = all_prices_body_.get(price_service_.get_price_registry_version(), [this]() {
+            return price_service_.get_price_registry().dump();
+        });
+        return reply_with_body(req, restinio::status_ok(), std::move(all_prices.body), all_prices.etag);
+    }
+
+    restinio::request_handling_status_t
+    price::get_price_cache_stats(const restinio::request_handle_t &req, const restinio::router::route_params_t &)
+    {
+        MMBOT_TRACE_FUNCTION();
+        DVLOG_F(loguru::Verbosity_INFO, "http call: %s", "/api/v1/getpricecachestats");
+        nlohmann::json answer_json = price_cache_.get_stats();
         return req->create_response(restinio::status_ok()).set_body(answer_json.dump()).done();
     }
-}
\ No newline at end of file
+}
@@ -18,6 +18,8 @@
 
 #include <restinio/all.hpp>
 #include "price/service.price.platform.hpp"
+#include "price/price.cache.hpp"
+#include "http/http.body.hpp"
 
 namespace antara::mmbot::http::rest
 {
@@ -30,7 +32,11 @@ namespace antara::mmbot::http::rest
 
         restinio::request_handling_status_t get_price(const restinio::request_handle_t& req, const restinio::router::route_params_t &);
         restinio::request_handling_status_t get_all_prices(const restinio::request_handle_t& req, const restinio::router::route_params_t &);
+        restinio::request_handling_status_t get_price_cache_stats(const restinio::request_handle_t& req, const restinio::router::route_params_t &);
     private:
         price_service_platform &price_service_;
+        price_cache<price_service_platform> price_cache_;
+        //! the registry is serialized once per version of it, the polling clients share that body.
+        versioned_body all_prices_body_;
     };
 }
\ No newline at end of file
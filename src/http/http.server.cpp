@@ -14,8 +14,27 @@
  *                                                                            *
  ******************************************************************************/
 
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
 #include "http/http.server.hpp"
 
+namespace
+{
+    //! count the requests of a route and time its handler, asynchronous handlers are timed until they are accepted.
+    template<typename Handler>
+    auto instrumented(const std::string &route, Handler handler)
+    {
+        using namespace antara::mmbot;
+        auto &requests = metrics::get_counter("mmbot_http_requests_total", metrics::label("route", route));
+        auto &latency = metrics::get_histogram("mmbot_http_handler_latency_us", metrics::label("route", route));
+        return [&requests, &latency, handler](auto &&... params) {
+            requests.inc();
+            metrics::scoped_timer timer(latency);
+            return handler(std::forward<decltype(params)>(params)...);
+        };
+    }
+}
+
 namespace antara::mmbot
 {
     http_server::http_server(price_service_platform &price_service, mmbot::mm2_client &mm2_client)
@@ -33,41 +52,76 @@ namespace antara::mmbot
             return req->create_response(status_ok()).set_body("Welcome.").done();
         });
 
-        http_router->http_get("/api/v1/getprice", [this](auto &&... params) {
-            return this->price_rest_callbook_.get_price(std::forward<decltype(params)>(params)...);
+        http_router->http_get("/metrics", [](const auto &req, const auto &) {
+            return req->create_response(status_ok()).append_header(http_field::content_type,
+                                                                   "text/plain; version=0.0.4").set_body(
+                    metrics::get_registry().to_prometheus()).done();
         });
 
-        http_router->http_get("/api/v1/getallprice", [this](auto &&... params) {
-            return this->price_rest_callbook_.get_all_prices(std::forward<decltype(params)>(params)...);
+        http_router->http_get("/api/v1/trace", [](const auto &req, const auto &) {
+            return req->create_response(status_ok()).append_header(http_field::content_type,
+                                                                   "application/json").set_body(
+                    tracing::dump_chrome_trace().dump()).done();
         });
 
-        http_router->http_get("/api/v1/legacy/mm2/getorderbook", [this](auto &&... params) {
-            return this->mm2_rest_callbook_.get_orderbook(std::forward<decltype(params)>(params)...);
+        http_router->http_post("/api/v1/trace/start", [](const auto &req, const auto &) {
+            tracing::clear();
+            tracing::set_enabled(true);
+            return req->create_response(status_ok()).done();
         });
 
-        http_router->http_post("/api/v1/legacy/mm2/setprice", [this](auto &&... params) {
-            return this->mm2_rest_callbook_.set_price(std::forward<decltype(params)>(params)...);
+        http_router->http_post("/api/v1/trace/stop", [](const auto &req, const auto &) {
+            tracing::set_enabled(false);
+            return req->create_response(status_ok()).done();
         });
 
-        http_router->http_post("/api/v1/legacy/mm2/cancel_order", [this](auto &&... params) {
-            return this->mm2_rest_callbook_.cancel_order(std::forward<decltype(params)>(params)...);
+        http_router->http_post("/api/v1/config/reload", [](const auto &req, const auto &) {
+            auto status = reload_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json") ?
+                          status_ok() : status_unprocessable_entity();
+            nlohmann::json answer_json = {{"version", get_mmbot_config_version()}};
+            return req->create_response(status).append_header(http_field::content_type, "application/json").set_body(
+                    answer_json.dump()).done();
         });
 
-        http_router->http_post("/api/v1/legacy/mm2/buy", [this](auto &&... params) {
+        http_router->http_get("/api/v1/getprice", instrumented("/api/v1/getprice", [this](auto &&... params) {
+            return this->price_rest_callbook_.get_price(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_get("/api/v1/getallprice", instrumented("/api/v1/getallprice", [this](auto &&... params) {
+            return this->price_rest_callbook_.get_all_prices(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_get("/api/v1/getpricecachestats", instrumented("/api/v1/getpricecachestats", [this](auto &&... params) {
+            return this->price_rest_callbook_.get_price_cache_stats(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_get("/api/v1/legacy/mm2/getorderbook", instrumented("/api/v1/legacy/mm2/getorderbook", [this](auto &&... params) {
+            return this->mm2_rest_callbook_.get_orderbook(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_post("/api/v1/legacy/mm2/setprice", instrumented("/api/v1/legacy/mm2/setprice", [this](auto &&... params) {
+            return this->mm2_rest_callbook_.set_price(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_post("/api/v1/legacy/mm2/cancel_order", instrumented("/api/v1/legacy/mm2/cancel_order", [this](auto &&... params) {
+            return this->mm2_rest_callbook_.cancel_order(std::forward<decltype(params)>(params)...);
+        }));
+
+        http_router->http_post("/api/v1/legacy/mm2/buy", instrumented("/api/v1/legacy/mm2/buy", [this](auto &&... params) {
             return this->mm2_rest_callbook_.buy(std::forward<decltype(params)>(params)...);
-        });
+        }));
 
-        http_router->http_post("/api/v1/legacy/mm2/cancel_all_orders", [this](auto &&... params) {
+        http_router->http_post("/api/v1/legacy/mm2/cancel_all_orders", instrumented("/api/v1/legacy/mm2/cancel_all_orders", [this](auto &&... params) {
             return this->mm2_rest_callbook_.cancel_all_orders(std::forward<decltype(params)>(params)...);
-        });
+        }));
 
-        http_router->http_get("/api/v1/legacy/mm2/my_balance", [this](auto &&... params) {
+        http_router->http_get("/api/v1/legacy/mm2/my_balance", instrumented("/api/v1/legacy/mm2/my_balance", [this](auto &&... params) {
             return this->mm2_rest_callbook_.my_balance(std::forward<decltype(params)>(params)...);
-        });
+        }));
 
-        http_router->http_get("/api/v1/legacy/mm2/version", [this](auto &&... params) {
+        http_router->http_get("/api/v1/legacy/mm2/version", instrumented("/api/v1/legacy/mm2/version", [this](auto &&... params) {
             return this->mm2_rest_callbook_.version(std::forward<decltype(params)>(params)...);
-        });
+        }));
 
 
         http_router->non_matched_request_handler(
@@ -81,9 +135,16 @@ namespace antara::mmbot
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
         const auto &mmbot_cfg = get_mmbot_config();
-        DVLOG_F(loguru::Verbosity_INFO, "launch http server on port: %d", mmbot_cfg.http_port);
-        restinio::run(
-                restinio::on_this_thread<http_server_traits>().port(mmbot_cfg.http_port).address(
-                        "localhost").request_handler(create_routes()));
+        DVLOG_F(loguru::Verbosity_INFO, "launch http server on port: %d with %zu thread(s)", mmbot_cfg.http_port,
+                mmbot_cfg.http_thread_pool_size);
+        if (mmbot_cfg.http_thread_pool_size > 1) {
+            restinio::run(
+                    restinio::on_thread_pool<http_server_pool_traits>(mmbot_cfg.http_thread_pool_size).port(
+                            mmbot_cfg.http_port).address("localhost").request_handler(create_routes()));
+        } else {
+            restinio::run(
+                    restinio::on_this_thread<http_server_traits>().port(mmbot_cfg.http_port).address(
+                            "localhost").request_handler(create_routes()));
+        }
     }
 }
\ No newline at end of file
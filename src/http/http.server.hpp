@@ -31,6 +31,12 @@ namespace antara::mmbot
         using request_handler_t = restinio::router::express_router_t<>;
     };
 
+    //! used when `http_thread_pool_size` is greater than one, handlers are then called concurrently.
+    struct http_server_pool_traits : public restinio::default_traits_t
+    {
+        using request_handler_t = restinio::router::express_router_t<>;
+    };
+
     class http_server
     {
     public:
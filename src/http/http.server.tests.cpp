@@ -14,10 +14,13 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <atomic>
 #include <csignal>
 #include <thread>
+#include <vector>
 #include <doctest/doctest.h>
 #include <restclient-cpp/restclient.h>
+#include <restclient-cpp/connection.h>
 #include "config/config.hpp"
 #include "http.server.hpp"
 
@@ -51,6 +54,43 @@ namespace antara::mmbot::tests
         std::thread server_thread_;
     };
 
+    class http_server_pool_tests_fixture
+    {
+    public:
+        http_server_pool_tests_fixture()
+        {
+            server_thread_ = std::thread([this](){this->server_.run();});
+        }
+
+        ~http_server_pool_tests_fixture()
+        {
+            server_thread_.join();
+        }
+
+    private:
+        struct tmp_magic
+        {
+            tmp_magic()
+            {
+                mmbot::load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+                auto cfg = get_mmbot_config();
+                cfg.http_thread_pool_size = 4;
+                set_mmbot_config(cfg);
+            }
+
+            ~tmp_magic()
+            {
+                mmbot::load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+            }
+        };
+
+        tmp_magic magic;
+        price_service_platform price_service_;
+        mm2_client mm2_client_;
+        antara::mmbot::http_server server_{price_service_, mm2_client_};
+        std::thread server_thread_;
+    };
+
     using namespace std::chrono_literals;
     TEST_CASE_FIXTURE (http_server_tests_fixture, "test run http_server")
     {
@@ -82,6 +122,53 @@ namespace antara::mmbot::tests
         std::raise(SIGINT);
     }
 
+    TEST_CASE_FIXTURE(http_server_tests_fixture, "test getprice is served from the price cache")
+    {
+        std::this_thread::sleep_for(1s);
+        auto resp = RestClient::get("localhost:7777/api/v1/getprice?base_currency=KMD&quote_currency=BTC");
+        CHECK_EQ(resp.code, 200);
+        resp = RestClient::get("localhost:7777/api/v1/getprice?base_currency=KMD&quote_currency=BTC");
+        CHECK_EQ(resp.code, 200);
+        resp = RestClient::get("localhost:7777/api/v1/getpricecachestats");
+        CHECK_EQ(resp.code, 200);
+        auto stats = nlohmann::json::parse(resp.body);
+        CHECK_EQ(stats.at("misses").get<std::size_t>(), 1);
+        CHECK_EQ(stats.at("hits").get<std::size_t>(), 1);
+        std::raise(SIGINT);
+    }
+
+    TEST_CASE_FIXTURE(http_server_pool_tests_fixture, "test http_server on a thread pool answers concurrent clients")
+    {
+        std::this_thread::sleep_for(1s);
+        std::vector<std::thread> clients;
+        std::atomic_size_t nb_ok{0};
+        for (int idx = 0; idx < 8; ++idx) {
+            clients.emplace_back([&nb_ok]() {
+                auto resp = RestClient::get("localhost:7777/api/v1/getprice?base_currency=KMD&quote_currency=BTC");
+                if (resp.code == 200) {
+                    ++nb_ok;
+                }
+            });
+        }
+        for (auto &&client : clients) {
+            client.join();
+        }
+        CHECK_EQ(nb_ok, 8);
+        std::raise(SIGINT);
+    }
+
+    TEST_CASE_FIXTURE(http_server_tests_fixture, "test metrics")
+    {
+        std::this_thread::sleep_for(1s);
+        auto resp = RestClient::get("localhost:7777/api/v1/getprice?base_currency=KMD&quote_currency=BTC");
+        CHECK_EQ(resp.code, 200);
+        resp = RestClient::get("localhost:7777/metrics");
+        CHECK_EQ(resp.code, 200);
+        CHECK_NE(resp.body.find("mmbot_http_requests_total{route=\"/api/v1/getprice\"}"), std::string::npos);
+        CHECK_NE(resp.body.find("mmbot_price_latency_us{quantile=\"0.99\"}"), std::string::npos);
+        std::raise(SIGINT);
+    }
+
     TEST_CASE_FIXTURE(http_server_tests_fixture, "test mm2 get orderbook")
     {
         std::this_thread::sleep_for(1s);
@@ -126,6 +213,20 @@ namespace antara::mmbot::tests
         std::raise(SIGINT);
     }
 
+    TEST_CASE_FIXTURE(http_server_tests_fixture, "test get all prices answers 304 to a client having them")
+    {
+        std::this_thread::sleep_for(1s);
+        auto resp = RestClient::get("localhost:7777/api/v1/getallprice");
+        CHECK_EQ(resp.code, 200);
+        REQUIRE_EQ(resp.headers.count("ETag"), 1);
+        RestClient::Connection connection("localhost:7777");
+        connection.AppendHeader("If-None-Match", resp.headers["ETag"]);
+        auto cached_resp = connection.get("/api/v1/getallprice");
+        CHECK_EQ(cached_resp.code, 304);
+        CHECK(cached_resp.body.empty());
+        std::raise(SIGINT);
+    }
+
     TEST_CASE_FIXTURE(http_server_tests_fixture, "test mm2 setprice")
     {
         std::this_thread::sleep_for(1s);
@@ -179,8 +280,13 @@ namespace antara::mmbot::tests
         mm2::cancel_all_orders_request cancel_request{"All"};
         json_request.clear();
         mm2::to_json(json_request, cancel_request);
-        resp = RestClient::post("localhost:7777/api/v1/legacy/mm2/cancel_all_orders", "application/json", json_request.dump());
+        //! an order placed or cancelled is never answered by a 304.
+        RestClient::Connection connection("localhost:7777");
+        connection.AppendHeader("If-None-Match", "*");
+        connection.AppendHeader("Content-Type", "application/json");
+        resp = connection.post("/api/v1/legacy/mm2/cancel_all_orders", json_request.dump());
         CHECK_EQ(resp.code, 200);
+        CHECK_EQ(resp.headers.count("ETag"), 0);
         std::raise(SIGINT);
     }
 }
\ No newline at end of file
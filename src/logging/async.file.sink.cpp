@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <system_error>
+#include "metrics/metrics.hpp"
+#include "logging/async.file.sink.hpp"
+
+namespace antara::mmbot::logging
+{
+    std::mutex async_file_sink::installed_mutex_;
+    std::vector<const async_file_sink *> async_file_sink::installed_sinks_;
+
+    async_file_sink::async_file_sink(std::filesystem::path path, async_file_sink_options options) :
+            path_(std::move(path)), options_(options), queue_(options.queue_capacity),
+            callback_id_(path_.string())
+    {
+        std::error_code ec;
+        if (path_.has_parent_path()) {
+            std::filesystem::create_directories(path_.parent_path(), ec);
+        }
+        open(options_.truncate);
+        writer_ = std::thread([this]() { this->write_loop(); });
+    }
+
+    async_file_sink::~async_file_sink() noexcept
+    {
+        stop();
+    }
+
+    bool async_file_sink::push(std::string line) noexcept
+    {
+        nb_pushed_.fetch_add(1, std::memory_order_relaxed);
+        if (!running_.load(std::memory_order_relaxed) || !queue_.try_push(std::move(line))) {
+            nb_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void async_file_sink::install(loguru::Verbosity verbosity)
+    {
+        loguru::add_callback(callback_id_.c_str(), &async_file_sink::on_log, this, verbosity, nullptr, nullptr);
+        installed_ = true;
+        std::scoped_lock lock(installed_mutex_);
+        installed_sinks_.push_back(this);
+    }
+
+    void async_file_sink::flush(std::chrono::milliseconds timeout) const noexcept
+    {
+        const auto target = nb_pushed_.load(std::memory_order_relaxed);
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (nb_written_.load(std::memory_order_acquire) + nb_dropped_.load(std::memory_order_relaxed) < target &&
+               running_.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    void async_file_sink::flush_installed(std::chrono::milliseconds timeout) noexcept
+    {
+        std::scoped_lock lock(installed_mutex_);
+        for (auto &&sink : installed_sinks_) {
+            sink->flush(timeout);
+        }
+    }
+
+    void async_file_sink::stop() noexcept
+    {
+        if (installed_) {
+            loguru::remove_callback(callback_id_.c_str());
+            installed_ = false;
+            std::scoped_lock lock(installed_mutex_);
+            installed_sinks_.erase(std::remove(begin(installed_sinks_), end(installed_sinks_), this),
+                                   end(installed_sinks_));
+        }
+        running_.store(false, std::memory_order_release);
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    std::size_t async_file_sink::nb_dropped() const noexcept
+    {
+        return nb_dropped_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t async_file_sink::nb_written() const noexcept
+    {
+        return nb_written_.load(std::memory_order_acquire);
+    }
+
+    const std::filesystem::path &async_file_sink::path() const noexcept
+    {
+        return path_;
+    }
+
+    void async_file_sink::write_loop()
+    {
+        auto &dropped_counter = metrics::get_counter("mmbot_log_dropped_total",
+                                                     metrics::label("sink", path_.filename().string()));
+        std::size_t nb_reported_dropped = 0;
+        std::string batch;
+        batch.reserve(options_.max_batch_bytes);
+        std::string line;
+        for (;;) {
+            //! read before draining so that the lines pushed before stop() are all written.
+            const bool running = running_.load(std::memory_order_acquire);
+            std::size_t nb_lines = 0;
+            while (batch.size() < options_.max_batch_bytes && queue_.try_pop(line)) {
+                batch += line;
+                ++nb_lines;
+            }
+            if (const auto nb_dropped = nb_dropped_.load(std::memory_order_relaxed); nb_dropped != nb_reported_dropped) {
+                dropped_counter.inc(nb_dropped - nb_reported_dropped);
+                batch += "async log sink: " + std::to_string(nb_dropped - nb_reported_dropped) +
+                         " line(s) dropped, the queue was full\n";
+                nb_reported_dropped = nb_dropped;
+            }
+            if (!batch.empty()) {
+                write_batch(batch, nb_lines);
+                batch.clear();
+                continue;
+            }
+            if (!running) {
+                break;
+            }
+            std::this_thread::sleep_for(options_.idle_wait);
+        }
+    }
+
+    void async_file_sink::write_batch(const std::string &batch, std::size_t nb_lines)
+    {
+        if (file_size_ > 0 && file_size_ + batch.size() > options_.max_file_size) {
+            rotate();
+        }
+        if (file_ != nullptr) {
+            std::fwrite(batch.data(), 1, batch.size(), file_);
+            std::fflush(file_);
+            file_size_ += batch.size();
+        }
+        nb_written_.fetch_add(nb_lines, std::memory_order_release);
+    }
+
+    void async_file_sink::open(bool truncate)
+    {
+        file_ = std::fopen(path_.string().c_str(), truncate ? "wb" : "ab");
+        std::error_code ec;
+        const auto size = truncate ? 0 : std::filesystem::file_size(path_, ec);
+        file_size_ = ec ? 0 : static_cast<std::size_t>(size);
+    }
+
+    void async_file_sink::rotate()
+    {
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+        auto rotated = [this](std::size_t idx) {
+            return std::filesystem::path(path_.string() + "." + std::to_string(idx));
+        };
+        std::error_code ec;
+        if (options_.max_rotated_files > 0) {
+            std::filesystem::remove(rotated(options_.max_rotated_files), ec);
+            for (auto idx = options_.max_rotated_files - 1; idx > 0; --idx) {
+                std::filesystem::rename(rotated(idx), rotated(idx + 1), ec);
+            }
+            std::filesystem::rename(path_, rotated(1), ec);
+        }
+        open(true);
+    }
+
+    void async_file_sink::on_log(void *user_data, const loguru::Message &message)
+    {
+        std::string line;
+        line.reserve(std::char_traits<char>::length(message.preamble) +
+                     std::char_traits<char>::length(message.indentation) +
+                     std::char_traits<char>::length(message.prefix) +
+                     std::char_traits<char>::length(message.message) + 1);
+        line += message.preamble;
+        line += message.indentation;
+        line += message.prefix;
+        line += message.message;
+        line += '\n';
+        static_cast<async_file_sink *>(user_data)->push(std::move(line));
+    }
+}
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <loguru.hpp>
+#include "utils/antara.mpsc.queue.hpp"
+
+namespace antara::mmbot::logging
+{
+    struct async_file_sink_options
+    {
+        std::size_t queue_capacity{65536};
+        std::size_t max_batch_bytes{64 * 1024};
+        std::size_t max_file_size{64 * 1024 * 1024};
+        std::size_t max_rotated_files{5};
+        std::chrono::milliseconds idle_wait{5};
+        bool truncate{false};
+    };
+
+    /**
+     * @brief File sink whose writes happen on a background thread: producers only push the formatted line in a
+     *        bounded lock-free queue, the writer appends what is queued in a single write per batch and rotates the
+     *        file (path.1 ... path.n) once it reaches max_file_size. Lines pushed while the queue is full are dropped
+     *        and counted, the writer notes how many in the file.
+     */
+    class async_file_sink
+    {
+    public:
+        explicit async_file_sink(std::filesystem::path path, async_file_sink_options options = {});
+
+        ~async_file_sink() noexcept;
+
+        async_file_sink(const async_file_sink &) = delete;
+
+        async_file_sink &operator=(const async_file_sink &) = delete;
+
+        //! returns false if the line is dropped.
+        bool push(std::string line) noexcept;
+
+        //! receive the loguru messages up to the given verbosity, replaces loguru::add_file. No flush handler is
+        //! given to loguru, which would call it after every message while holding its lock.
+        void install(loguru::Verbosity verbosity);
+
+        //! wait until what is pushed so far is written, or timeout.
+        void flush(std::chrono::milliseconds timeout = std::chrono::milliseconds{1000}) const noexcept;
+
+        //! flush every installed sink, e.g. from the fatal handler before the process exits.
+        static void flush_installed(std::chrono::milliseconds timeout = std::chrono::milliseconds{1000}) noexcept;
+
+        //! stop receiving loguru messages, write what is queued and join the writer.
+        void stop() noexcept;
+
+        [[nodiscard]] std::size_t nb_dropped() const noexcept;
+
+        [[nodiscard]] std::size_t nb_written() const noexcept;
+
+        [[nodiscard]] const std::filesystem::path &path() const noexcept;
+
+    private:
+        void write_loop();
+
+        void write_batch(const std::string &batch, std::size_t nb_lines);
+
+        void open(bool truncate);
+
+        void rotate();
+
+        static void on_log(void *user_data, const loguru::Message &message);
+
+        static std::mutex installed_mutex_;
+        static std::vector<const async_file_sink *> installed_sinks_;
+
+        std::filesystem::path path_;
+        async_file_sink_options options_;
+        antara::mpsc_queue<std::string> queue_;
+        std::FILE *file_{nullptr};
+        std::size_t file_size_{0};
+        std::string callback_id_;
+        bool installed_{false};
+        std::atomic_size_t nb_pushed_{0};
+        std::atomic_size_t nb_dropped_{0};
+        std::atomic_size_t nb_written_{0};
+        std::atomic_bool running_{true};
+        std::thread writer_;
+    };
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <doctest/doctest.h>
+#include "logging/async.file.sink.hpp"
+#include "logging/payload.sampler.hpp"
+
+namespace antara::mmbot::tests
+{
+    namespace
+    {
+        std::string read_file(const std::filesystem::path &path)
+        {
+            std::ifstream ifs(path);
+            std::stringstream ss;
+            ss << ifs.rdbuf();
+            return ss.str();
+        }
+    }
+
+    TEST_CASE ("async file sink writes every pushed line before stopping")
+    {
+        const auto path = std::filesystem::temp_directory_path() / "mmbot.async.sink.tests.log";
+        logging::async_file_sink_options options;
+        options.truncate = true;
+        logging::async_file_sink sink(path, options);
+        for (int idx = 0; idx < 100; ++idx) {
+            CHECK(sink.push("line " + std::to_string(idx) + "\n"));
+        }
+        sink.flush();
+        CHECK_EQ(100, sink.nb_written());
+        sink.stop();
+        CHECK_FALSE(sink.push("after stop\n"));
+        auto content = read_file(path);
+        CHECK_EQ(0, content.find("line 0\n"));
+        CHECK_NE(std::string::npos, content.find("line 99\n"));
+        CHECK_EQ(std::string::npos, content.find("after stop"));
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE ("async file sink rotates the file once it reaches its max size")
+    {
+        const auto path = std::filesystem::temp_directory_path() / "mmbot.async.sink.rotation.tests.log";
+        logging::async_file_sink_options options;
+        options.truncate = true;
+        options.max_file_size = 16;
+        options.max_rotated_files = 2;
+        {
+            logging::async_file_sink sink(path, options);
+            for (int idx = 0; idx < 4; ++idx) {
+                sink.push("0123456789\n");
+                sink.flush();
+            }
+        }
+        CHECK_EQ("0123456789\n", read_file(path));
+        CHECK_EQ("0123456789\n", read_file(path.string() + ".1"));
+        CHECK_EQ("0123456789\n", read_file(path.string() + ".2"));
+        CHECK_FALSE(std::filesystem::exists(path.string() + ".3"));
+        std::filesystem::remove(path);
+        std::filesystem::remove(path.string() + ".1");
+        std::filesystem::remove(path.string() + ".2");
+    }
+
+    TEST_CASE ("logging with an installed async file sink doesn't wait for the file")
+    {
+        const auto path = std::filesystem::temp_directory_path() / "mmbot.async.sink.latency.tests.log";
+        logging::async_file_sink_options options;
+        options.truncate = true;
+        options.idle_wait = std::chrono::milliseconds{50};
+        const auto stderr_verbosity = loguru::g_stderr_verbosity;
+        loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+        logging::async_file_sink sink(path, options);
+        sink.install(loguru::Verbosity_INFO);
+        //! a log call waiting for the writer would take up to idle_wait, i.e. seconds for these 100 calls.
+        const auto start = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < 100; ++idx) {
+            VLOG_F(loguru::Verbosity_INFO, "latency line %d", idx);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        sink.stop();
+        loguru::g_stderr_verbosity = stderr_verbosity;
+        CHECK_LT(elapsed, std::chrono::milliseconds{500});
+        CHECK_NE(std::string::npos, read_file(path).find("latency line 99"));
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE ("payload sampler")
+    {
+        logging::payload_sampler sampler;
+        CHECK_FALSE(sampler.sample(0));
+        std::size_t nb_sampled = 0;
+        for (int idx = 0; idx < 100; ++idx) {
+            nb_sampled += sampler.sample(10) ? 1u : 0u;
+        }
+        CHECK_EQ(10, nb_sampled);
+    }
+}
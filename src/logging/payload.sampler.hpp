@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace antara::mmbot::logging
+{
+    //! keeps one call out of one_out_of, 0 keeps none.
+    class payload_sampler
+    {
+    public:
+        bool sample(std::size_t one_out_of) noexcept
+        {
+            return one_out_of > 0 && nb_calls_.fetch_add(1, std::memory_order_relaxed) % one_out_of == 0;
+        }
+
+    private:
+        std::atomic_size_t nb_calls_{0};
+    };
+
+    //! whether a response body should be logged, according to the log_payload_sample_rate of the config.
+    bool should_log_payload() noexcept;
+}
@@ -15,18 +15,58 @@
  ******************************************************************************/
 
 #include <cstdlib>
+#include <optional>
+#include <string>
+#include <restclient-cpp/restclient.h>
 #include "app/mmbot.application.hpp"
+#include "logging/async.file.sink.hpp"
+#include "shard/shard.coordinator.hpp"
 
-int main()
+//! `mmbot` runs the bot, or the shard coordinator when `shard.nb_workers` is set in the config, which launches
+//! `mmbot --shard-worker <index>` for each of its workers.
+int main(int argc, char **argv)
 {
-    loguru::add_file("logs/mmbot.everything.log", loguru::Append, loguru::Verbosity_MAX);
-    loguru::add_file("logs/mmbot.latest.readable.log", loguru::Truncate, loguru::Verbosity_INFO);
+    std::optional<std::size_t> shard_worker;
+    for (int idx = 1; idx + 1 < argc; ++idx) {
+        if (std::string(argv[idx]) == "--shard-worker") {
+            shard_worker = std::stoul(argv[idx + 1]);
+        }
+    }
+    const std::string log_prefix = shard_worker.has_value() ?
+                                   "logs/mmbot.shard." + std::to_string(shard_worker.value()) : "logs/mmbot";
+    //! the files are written from background threads so logging never waits on the disk.
+    antara::mmbot::logging::async_file_sink everything_log(log_prefix + ".everything.log");
+    everything_log.install(loguru::Verbosity_MAX);
+    antara::mmbot::logging::async_file_sink_options readable_options;
+    readable_options.truncate = true;
+    antara::mmbot::logging::async_file_sink readable_log(log_prefix + ".latest.readable.log", readable_options);
+    readable_log.install(loguru::Verbosity_INFO);
     loguru::set_thread_name("main thread");
+    if (shard_worker.has_value()) {
+        //! nothing reads the stderr of a worker, it would fill up and block the logging threads.
+        loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+    }
     loguru::set_fatal_handler([](const loguru::Message& message){
         VLOG_F(loguru::Verbosity_FATAL, "err occured: %s", message.message);
+        //! std::exit doesn't destroy the sinks of main, what they have queued is written first.
+        antara::mmbot::logging::async_file_sink::flush_installed();
         std::exit(1);
     });
     antara::mmbot::load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
-    antara::mmbot::application app;
-    return app.run();
-}
\ No newline at end of file
+    if (shard_worker.has_value()) {
+        auto cfg = antara::mmbot::shard::worker_config(antara::mmbot::get_mmbot_config(), shard_worker.value());
+        antara::mmbot::set_mmbot_config(cfg);
+    }
+    //! curl global state is not thread safe, it has to be set up before the http and price threads start.
+    RestClient::init();
+    int res = 0;
+    if (!shard_worker.has_value() && antara::mmbot::get_mmbot_config().shard.nb_workers > 0) {
+        antara::mmbot::shard::coordinator coordinator(std::filesystem::absolute(argv[0]).string());
+        res = coordinator.run();
+    } else {
+        antara::mmbot::application app(shard_worker);
+        res = app.run();
+    }
+    RestClient::disable();
+    return res;
+}
@@ -0,0 +1,284 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include "metrics.hpp"
+
+namespace
+{
+    std::size_t most_significant_bit(std::uint64_t value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+        std::size_t msb = 0;
+        while (value >>= 1u) {
+            ++msb;
+        }
+        return msb;
+#endif
+    }
+
+    std::string with_labels(const std::string &name, const std::string &labels, const std::string &extra = "")
+    {
+        if (labels.empty() && extra.empty()) {
+            return name;
+        }
+        std::string result = name + "{" + labels;
+        if (!labels.empty() && !extra.empty()) {
+            result += ",";
+        }
+        return result + extra + "}";
+    }
+
+    //! `labels` first in the label set of the sample line `line`.
+    std::string add_labels(const std::string &line, const std::string &labels)
+    {
+        auto name_end = line.find_first_of("{ ");
+        if (name_end == std::string::npos) {
+            return line;
+        }
+        if (line[name_end] == ' ') {
+            return line.substr(0, name_end) + "{" + labels + "}" + line.substr(name_end);
+        }
+        return line.substr(0, name_end + 1) + labels + "," + line.substr(name_end + 1);
+    }
+}
+
+namespace antara::mmbot::metrics
+{
+    std::size_t current_shard() noexcept
+    {
+        static std::atomic_size_t next_shard{0};
+        thread_local const std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % nb_shards;
+        return shard;
+    }
+
+    std::uint64_t counter::value() const noexcept
+    {
+        std::uint64_t total = 0;
+        for (auto &&current_shard : shards_) {
+            total += current_shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::size_t histogram::bucket_of(std::uint64_t value) noexcept
+    {
+        value = std::min(value, (std::uint64_t{1} << max_value_bits) - 1u);
+        if (value < sub_bucket_count) {
+            return static_cast<std::size_t>(value);
+        }
+        auto msb = most_significant_bit(value);
+        auto sub_bucket = (value >> (msb - sub_bucket_bits)) & (sub_bucket_count - 1u);
+        return (msb - sub_bucket_bits + 1u) * sub_bucket_count + static_cast<std::size_t>(sub_bucket);
+    }
+
+    std::uint64_t histogram::lower_bound_of(std::size_t bucket) noexcept
+    {
+        if (bucket < sub_bucket_count) {
+            return bucket;
+        }
+        auto octave = bucket / sub_bucket_count;
+        auto sub_bucket = bucket % sub_bucket_count;
+        return (sub_bucket_count + sub_bucket) << (octave - 1u);
+    }
+
+    void histogram::record(std::uint64_t value) noexcept
+    {
+        auto &current = shards_[current_shard()];
+        current.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        current.count.fetch_add(1, std::memory_order_relaxed);
+        current.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    std::uint64_t histogram::count() const noexcept
+    {
+        std::uint64_t total = 0;
+        for (auto &&current : shards_) {
+            total += current.count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::uint64_t histogram::sum() const noexcept
+    {
+        std::uint64_t total = 0;
+        for (auto &&current : shards_) {
+            total += current.sum.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    double histogram::percentile(double quantile) const noexcept
+    {
+        std::array<std::uint64_t, nb_buckets> merged{};
+        std::uint64_t total = 0;
+        for (auto &&current : shards_) {
+            for (std::size_t idx = 0; idx < nb_buckets; ++idx) {
+                auto nb_values = current.buckets[idx].load(std::memory_order_relaxed);
+                merged[idx] += nb_values;
+                total += nb_values;
+            }
+        }
+        if (total == 0) {
+            return 0.0;
+        }
+        auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+        rank = std::max<std::uint64_t>(rank, 1u);
+        std::uint64_t seen = 0;
+        for (std::size_t idx = 0; idx < nb_buckets; ++idx) {
+            seen += merged[idx];
+            if (seen >= rank) {
+                auto lower = lower_bound_of(idx);
+                auto width = lower_bound_of(idx + 1) - lower;
+                return static_cast<double>(lower) + static_cast<double>(width - 1u) / 2.0;
+            }
+        }
+        return static_cast<double>(lower_bound_of(nb_buckets - 1u));
+    }
+
+    template<typename TMetric>
+    TMetric &registry::get_or_create(family<TMetric> &metrics, const std::string &name, const std::string &labels)
+    {
+        {
+            std::shared_lock lock(mutex_);
+            if (auto family_it = metrics.find(name); family_it != metrics.end()) {
+                if (auto it = family_it->second.find(labels); it != family_it->second.end()) {
+                    return *it->second;
+                }
+            }
+        }
+        std::unique_lock lock(mutex_);
+        auto &metric = metrics[name][labels];
+        if (metric == nullptr) {
+            metric = std::make_unique<TMetric>();
+        }
+        return *metric;
+    }
+
+    counter &registry::get_counter(const std::string &name, const std::string &labels)
+    {
+        return get_or_create(counters_, name, labels);
+    }
+
+    histogram &registry::get_histogram(const std::string &name, const std::string &labels)
+    {
+        return get_or_create(histograms_, name, labels);
+    }
+
+    std::string registry::to_prometheus() const
+    {
+        std::ostringstream ss;
+        std::shared_lock lock(mutex_);
+        for (auto &&[name, metrics] : counters_) {
+            ss << "# TYPE " << name << " counter\n";
+            for (auto &&[labels, metric] : metrics) {
+                ss << with_labels(name, labels) << " " << metric->value() << "\n";
+            }
+        }
+        for (auto &&[name, metrics] : histograms_) {
+            ss << "# TYPE " << name << " summary\n";
+            for (auto &&[labels, metric] : metrics) {
+                for (auto quantile : {"0.5", "0.9", "0.99", "0.999"}) {
+                    ss << with_labels(name, labels, std::string("quantile=\"") + quantile + "\"") << " "
+                       << metric->percentile(std::stod(quantile)) << "\n";
+                }
+                ss << with_labels(name + "_sum", labels) << " " << metric->sum() << "\n";
+                ss << with_labels(name + "_count", labels) << " " << metric->count() << "\n";
+            }
+        }
+        return ss.str();
+    }
+
+    std::string merge_prometheus(const std::vector<labelled_exposition> &expositions)
+    {
+        struct family
+        {
+            std::vector<std::string> comments;
+            std::vector<std::string> samples;
+        };
+        std::vector<std::string> order;
+        std::map<std::string, family> families;
+        auto family_of = [&order, &families](const std::string &name) -> family & {
+            auto[it, inserted] = families.try_emplace(name);
+            if (inserted) {
+                order.push_back(name);
+            }
+            return it->second;
+        };
+        for (auto &&exposition : expositions) {
+            std::istringstream lines(exposition.text);
+            std::string current;
+            for (std::string line; std::getline(lines, line);) {
+                if (line.empty()) {
+                    continue;
+                }
+                if (line[0] == '#') {
+                    std::istringstream words(line);
+                    std::string hash, keyword;
+                    words >> hash >> keyword >> current;
+                    auto &comments = family_of(current).comments;
+                    if (std::find(begin(comments), end(comments), line) == end(comments)) {
+                        comments.push_back(line);
+                    }
+                    continue;
+                }
+                if (current.empty()) {
+                    current = line.substr(0, line.find_first_of("{ "));
+                }
+                family_of(current).samples.push_back(
+                        exposition.labels.empty() ? line : add_labels(line, exposition.labels));
+            }
+        }
+        std::ostringstream ss;
+        for (auto &&name : order) {
+            for (auto &&line : families[name].comments) {
+                ss << line << "\n";
+            }
+            for (auto &&line : families[name].samples) {
+                ss << line << "\n";
+            }
+        }
+        return ss.str();
+    }
+
+    registry &get_registry() noexcept
+    {
+        static registry instance;
+        return instance;
+    }
+
+    std::string label(const std::string &key, const std::string &value)
+    {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (auto cur_char : value) {
+            if (cur_char == '\\' || cur_char == '"') {
+                escaped += '\\';
+                escaped += cur_char;
+            } else if (cur_char == '\n') {
+                escaped += "\\n";
+            } else {
+                escaped += cur_char;
+            }
+        }
+        return key + "=\"" + escaped + "\"";
+    }
+}
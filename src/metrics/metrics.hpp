@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace antara::mmbot::metrics
+{
+    inline constexpr std::size_t nb_shards = 8;
+
+    //! index of the shard the calling thread writes to, threads are spread round robin.
+    std::size_t current_shard() noexcept;
+
+    /**
+     * @brief Monotonic counter, every thread increments its own cache line and reads sum the shards.
+     */
+    class counter
+    {
+    public:
+        void inc(std::uint64_t value = 1) noexcept
+        {
+            shards_[current_shard()].value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t value() const noexcept;
+
+    private:
+        struct alignas(64) shard
+        {
+            std::atomic<std::uint64_t> value{0};
+        };
+
+        std::array<shard, nb_shards> shards_{};
+    };
+
+    /**
+     * @brief Log-linear latency histogram in the HDR style: every power of two is split into 16 buckets, so any
+     *        recorded value is known within 6.25%. Values are microseconds and are clamped to 2^40.
+     */
+    class histogram
+    {
+    public:
+        static constexpr std::size_t sub_bucket_bits = 4;
+        static constexpr std::size_t sub_bucket_count = 1u << sub_bucket_bits;
+        static constexpr std::size_t max_value_bits = 40;
+        static constexpr std::size_t nb_buckets = (max_value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+        static std::size_t bucket_of(std::uint64_t value) noexcept;
+
+        //! smallest value falling in `bucket`.
+        static std::uint64_t lower_bound_of(std::size_t bucket) noexcept;
+
+        void record(std::uint64_t value) noexcept;
+
+        void record(std::chrono::nanoseconds elapsed) noexcept
+        {
+            record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+        }
+
+        [[nodiscard]] std::uint64_t count() const noexcept;
+
+        [[nodiscard]] std::uint64_t sum() const noexcept;
+
+        //! value at `quantile` (0..1), middle of the bucket holding it.
+        [[nodiscard]] double percentile(double quantile) const noexcept;
+
+    private:
+        struct alignas(64) shard
+        {
+            std::array<std::atomic<std::uint64_t>, nb_buckets> buckets{};
+            std::atomic<std::uint64_t> count{0};
+            std::atomic<std::uint64_t> sum{0};
+        };
+
+        std::array<shard, nb_shards> shards_{};
+    };
+
+    //! Records the time spent in a scope into a histogram.
+    class scoped_timer
+    {
+    public:
+        explicit scoped_timer(histogram &target) noexcept : target_(target), start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~scoped_timer() noexcept
+        {
+            target_.record(std::chrono::steady_clock::now() - start_);
+        }
+
+        scoped_timer(const scoped_timer &) = delete;
+
+        scoped_timer &operator=(const scoped_timer &) = delete;
+
+    private:
+        histogram &target_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Owns every metric of the process, metrics live until exit so references can be cached by the callers.
+     *        `labels` is the prometheus label set without braces, for example `pair="KMD/BTC"`.
+     */
+    class registry
+    {
+    public:
+        counter &get_counter(const std::string &name, const std::string &labels = "");
+
+        histogram &get_histogram(const std::string &name, const std::string &labels = "");
+
+        //! Prometheus text exposition format, histograms are exported as summaries.
+        [[nodiscard]] std::string to_prometheus() const;
+
+    private:
+        template<typename TMetric>
+        using family = std::map<std::string, std::map<std::string, std::unique_ptr<TMetric>>>;
+
+        template<typename TMetric>
+        TMetric &get_or_create(family<TMetric> &metrics, const std::string &name, const std::string &labels);
+
+        mutable std::shared_mutex mutex_;
+        family<counter> counters_;
+        family<histogram> histograms_;
+    };
+
+    registry &get_registry() noexcept;
+
+    inline counter &get_counter(const std::string &name, const std::string &labels = "")
+    {
+        return get_registry().get_counter(name, labels);
+    }
+
+    inline histogram &get_histogram(const std::string &name, const std::string &labels = "")
+    {
+        return get_registry().get_histogram(name, labels);
+    }
+
+    //! `key="value"`, the value is escaped for the exposition format.
+    std::string label(const std::string &key, const std::string &value);
+
+    //! the exposition of one process and the labels added to each of its samples, for example `shard="0"`.
+    struct labelled_exposition
+    {
+        std::string labels;
+        std::string text;
+    };
+
+    //! one exposition of several processes, the samples of a family stay together under a single TYPE line.
+    std::string merge_prometheus(const std::vector<labelled_exposition> &expositions);
+}
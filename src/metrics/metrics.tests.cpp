@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "metrics.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("counters sum the increments of every thread")
+    {
+        metrics::counter counter;
+        std::vector<std::thread> threads;
+        for (int idx = 0; idx < 8; ++idx) {
+            threads.emplace_back([&counter]() {
+                for (int nb_inc = 0; nb_inc < 1000; ++nb_inc) {
+                    counter.inc();
+                }
+            });
+        }
+        for (auto &&thread : threads) {
+            thread.join();
+        }
+        CHECK_EQ(8000, counter.value());
+    }
+
+    TEST_CASE ("histogram buckets are contiguous and precise within 6.25%")
+    {
+        for (std::uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456789ull}) {
+            auto bucket = metrics::histogram::bucket_of(value);
+            CHECK_LE(metrics::histogram::lower_bound_of(bucket), value);
+            CHECK_GT(metrics::histogram::lower_bound_of(bucket + 1), value);
+        }
+        CHECK_EQ(metrics::histogram::nb_buckets - 1, metrics::histogram::bucket_of(~0ull));
+
+        metrics::histogram histogram;
+        for (std::uint64_t value = 1; value <= 10000; ++value) {
+            histogram.record(value);
+        }
+        CHECK_EQ(10000, histogram.count());
+        CHECK_EQ(50005000, histogram.sum());
+        CHECK_EQ(doctest::Approx(5000).epsilon(0.0625), histogram.percentile(0.5));
+        CHECK_EQ(doctest::Approx(9900).epsilon(0.0625), histogram.percentile(0.99));
+        CHECK_EQ(doctest::Approx(1.0), histogram.percentile(0.0));
+    }
+
+    TEST_CASE ("registry exports prometheus text")
+    {
+        metrics::registry registry;
+        registry.get_counter("mmbot_requests_total", metrics::label("route", "/metrics")).inc(3);
+        auto &latency = registry.get_histogram("mmbot_latency_us", metrics::label("pair", "KMD/BTC"));
+        CHECK_EQ(&latency, &registry.get_histogram("mmbot_latency_us", metrics::label("pair", "KMD/BTC")));
+        latency.record(std::chrono::microseconds{10});
+        auto text = registry.to_prometheus();
+        CHECK_NE(std::string::npos, text.find("# TYPE mmbot_requests_total counter\n"));
+        CHECK_NE(std::string::npos, text.find("mmbot_requests_total{route=\"/metrics\"} 3\n"));
+        CHECK_NE(std::string::npos, text.find("mmbot_latency_us{pair=\"KMD/BTC\",quantile=\"0.99\"} 10\n"));
+        CHECK_NE(std::string::npos, text.find("mmbot_latency_us_count{pair=\"KMD/BTC\"} 1\n"));
+        CHECK_EQ("key=\"a\\\"b\"", metrics::label("key", "a\"b"));
+    }
+
+    TEST_CASE ("expositions of several processes are merged by family")
+    {
+        const std::string worker = "# TYPE mmbot_requests_total counter\n"
+                                   "mmbot_requests_total{route=\"/\"} 3\n"
+                                   "# TYPE mmbot_up counter\n"
+                                   "mmbot_up 1\n";
+        auto text = metrics::merge_prometheus({{metrics::label("shard", "0"), worker},
+                                               {metrics::label("shard", "1"), worker}});
+        CHECK_EQ("# TYPE mmbot_requests_total counter\n"
+                 "mmbot_requests_total{shard=\"0\",route=\"/\"} 3\n"
+                 "mmbot_requests_total{shard=\"1\",route=\"/\"} 3\n"
+                 "# TYPE mmbot_up counter\n"
+                 "mmbot_up{shard=\"0\"} 1\n"
+                 "mmbot_up{shard=\"1\"} 1\n", text);
+    }
+}
@@ -0,0 +1,247 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <memory>
+#include <benchmark/benchmark.h>
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
+#include "mm2.client.hpp"
+#include "mm2.mock.server.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot;
+
+    std::string make_orderbook_body(std::size_t nb_levels)
+    {
+        auto make_level = [](std::size_t idx) {
+            return nlohmann::json{{"coin",      "RICK"},
+                                  {"address",   "RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd"},
+                                  {"price",     1.0 + static_cast<double>(idx) / 1000.0},
+                                  {"numutxos",  3},
+                                  {"avevolume", 10.0},
+                                  {"maxvolume", 30.0},
+                                  {"depth",     0.0},
+                                  {"pubkey",    "02b3f4e6a7b8c9d0e1f2a3b4c5d6e7f8a9b0c1d2e3f4a5b6c7d8e9f0a1b2c3d4e5"},
+                                  {"age",       10},
+                                  {"zcredits",  0}};
+        };
+        nlohmann::json j{{"askdepth",  0},
+                         {"biddepth",  0},
+                         {"netid",     9999},
+                         {"numasks",   nb_levels},
+                         {"numbids",   nb_levels},
+                         {"timestamp", 1565000000},
+                         {"base",      "RICK"},
+                         {"rel",       "MORTY"},
+                         {"asks",      nlohmann::json::array()},
+                         {"bids",      nlohmann::json::array()}};
+        for (std::size_t idx = 0; idx < nb_levels; ++idx) {
+            j["asks"].push_back(make_level(idx));
+            j["bids"].push_back(make_level(idx));
+        }
+        return j.dump();
+    }
+
+    //! The decoding as it was before tracing: one loguru scope for the answer, each level and each level content.
+    void decode_with_scope_logging(const nlohmann::json &j, mm2::orderbook_answer &answer)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        auto decode_levels = [](const nlohmann::json &levels, auto &out) {
+            for (auto &&level : levels) {
+                VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+                typename std::decay_t<decltype(out)>::value_type decoded;
+                {
+                    VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+                    mm2::from_json(level, decoded);
+                }
+                out.push_back(std::move(decoded));
+            }
+        };
+        decode_levels(j.at("bids"), answer.bids);
+        decode_levels(j.at("asks"), answer.asks);
+    }
+
+    void BM_orderbook_decode_with_scope_logging(benchmark::State &state)
+    {
+        const auto body = make_orderbook_body(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            mm2::orderbook_answer answer;
+            decode_with_scope_logging(nlohmann::json::parse(body), answer);
+            benchmark::DoNotOptimize(answer);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+    }
+
+    void BM_orderbook_decode_tracing_disabled(benchmark::State &state)
+    {
+        const auto body = make_orderbook_body(static_cast<std::size_t>(state.range(0)));
+        tracing::set_enabled(false);
+        for (auto _ : state) {
+            mm2::orderbook_answer answer;
+            mm2::from_json(nlohmann::json::parse(body), answer);
+            benchmark::DoNotOptimize(answer);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+    }
+
+    void BM_orderbook_decode_tracing_enabled(benchmark::State &state)
+    {
+        const auto body = make_orderbook_body(static_cast<std::size_t>(state.range(0)));
+        tracing::set_enabled(true);
+        for (auto _ : state) {
+            mm2::orderbook_answer answer;
+            mm2::from_json(nlohmann::json::parse(body), answer);
+            benchmark::DoNotOptimize(answer);
+        }
+        tracing::set_enabled(false);
+        tracing::clear();
+        state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+    }
+
+    template<typename Request>
+    void BM_mm2_encode(benchmark::State &state, Request request)
+    {
+        for (auto _ : state) {
+            nlohmann::json j;
+            mm2::to_json(j, request);
+            benchmark::DoNotOptimize(j.dump());
+        }
+    }
+
+    //! the answer argument only selects the decoded type.
+    template<typename Answer>
+    void BM_mm2_decode(benchmark::State &state, Answer, std::string body)
+    {
+        for (auto _ : state) {
+            Answer answer{};
+            mm2::from_json(nlohmann::json::parse(body), answer);
+            benchmark::DoNotOptimize(answer);
+        }
+    }
+
+    //! a mock mm2 answering after 1ms on 4 threads, shared by the client round trip benchmarks.
+    struct mock_mm2_environment
+    {
+        mock_mm2_environment() : server(make_options())
+        {
+            server.start();
+            auto cfg = get_mmbot_config();
+            cfg.mm2_endpoint = server.endpoint();
+            set_mmbot_config(cfg);
+            client = std::make_unique<mm2_client>(false);
+        }
+
+        static mock_mm2_options make_options()
+        {
+            mock_mm2_options options;
+            options.port = 7791;
+            options.nb_threads = 4;
+            options.latency = std::chrono::milliseconds{1};
+            return options;
+        }
+
+        mock_mm2_server server;
+        std::unique_ptr<mm2_client> client;
+    };
+
+    mock_mm2_environment &get_mock_mm2()
+    {
+        static mock_mm2_environment environment;
+        return environment;
+    }
+
+    //! round trips through the mock mm2, reports the tail latency seen by each thread next to the throughput.
+    template<typename Rpc>
+    void run_client_round_trips(benchmark::State &state, Rpc &&rpc)
+    {
+        auto &client = *get_mock_mm2().client;
+        auto latency = std::make_unique<metrics::histogram>();
+        std::size_t nb_errors = 0;
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+            auto answer = rpc(client);
+            latency->record(std::chrono::steady_clock::now() - start);
+            nb_errors += answer.rpc_result_code == 200 ? 0 : 1;
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.counters["p50_us"] = benchmark::Counter(latency->percentile(0.5), benchmark::Counter::kAvgThreads);
+        state.counters["p99_us"] = benchmark::Counter(latency->percentile(0.99), benchmark::Counter::kAvgThreads);
+        state.counters["errors"] = benchmark::Counter(static_cast<double>(nb_errors));
+    }
+
+    void BM_mm2_client_version_round_trip(benchmark::State &state)
+    {
+        run_client_round_trips(state, [](mm2_client &client) { return client.rpc_version(); });
+    }
+
+    void BM_mm2_client_orderbook_round_trip(benchmark::State &state)
+    {
+        run_client_round_trips(state, [](mm2_client &client) {
+            return client.rpc_orderbook(mm2::orderbook_request{antara::pair{{st_symbol{"MORTY"}}, {st_symbol{"RICK"}}}});
+        });
+    }
+
+    const antara::asset rick{st_symbol{"RICK"}};
+    const antara::asset morty{st_symbol{"MORTY"}};
+    const char *uuid = "6a4fa2fc-8a6e-4a3f-9b8e-5f3b8c0d3a1e";
+}
+
+BENCHMARK(BM_orderbook_decode_with_scope_logging)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_orderbook_decode_tracing_disabled)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_orderbook_decode_tracing_enabled)->Arg(10)->Arg(100)->Arg(1000);
+
+BENCHMARK(BM_mm2_client_version_round_trip)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_mm2_client_orderbook_round_trip)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_mm2_encode, electrum_request, mm2::electrum_request{"RICK", {{"electrum1.cipig.net:10017"},
+                                                                                  {"electrum2.cipig.net:10017"},
+                                                                                  {"electrum3.cipig.net:10017"}}});
+BENCHMARK_CAPTURE(BM_mm2_encode, orderbook_request, mm2::orderbook_request{antara::pair{morty, rick}});
+BENCHMARK_CAPTURE(BM_mm2_encode, balance_request, mm2::balance_request{rick});
+BENCHMARK_CAPTURE(BM_mm2_encode, setprice_request, mm2::setprice_request{rick, morty, "1.0245", "10", false, true});
+BENCHMARK_CAPTURE(BM_mm2_encode, cancel_order_request, mm2::cancel_order_request{uuid});
+BENCHMARK_CAPTURE(BM_mm2_encode, buy_request, mm2::buy_request{rick, morty, "1.0245", "10"});
+BENCHMARK_CAPTURE(BM_mm2_encode, cancel_all_orders_request,
+                  mm2::cancel_all_orders_request{"Pair", mm2::cancel_all_orders_data{rick, morty}});
+
+BENCHMARK_CAPTURE(BM_mm2_decode, electrum_answer, mm2::electrum_answer{},
+                  R"({"address":"RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd","balance":"7.77","result":"success"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, orderbook_answer, mm2::orderbook_answer{}, make_orderbook_body(100));
+BENCHMARK_CAPTURE(BM_mm2_decode, balance_answer, mm2::balance_answer{},
+                  R"({"address":"RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd","balance":"7.77","coin":"RICK"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, version_answer, mm2::version_answer{},
+                  R"({"result":"2.0.1009_mm2_b08da3aa9_Linux"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, setprice_request, mm2::setprice_request{},
+                  R"({"userpass":"pass","method":"setprice","base":"RICK","rel":"MORTY","price":"1.0245","volume":"10","max":false,"cancel_previous":true})");
+BENCHMARK_CAPTURE(BM_mm2_decode, setprice_answer, mm2::setprice_answer{},
+                  R"({"result":{"base":"RICK","rel":"MORTY","price":"1.0245","max_base_vol":"10","min_base_vol":"0",)"
+                  R"("created_at":1565000000,"matches":{},"started_swaps":[],"uuid":"6a4fa2fc-8a6e-4a3f-9b8e-5f3b8c0d3a1e"}})");
+BENCHMARK_CAPTURE(BM_mm2_decode, cancel_order_request, mm2::cancel_order_request{},
+                  R"({"userpass":"pass","method":"cancel_order","uuid":"6a4fa2fc-8a6e-4a3f-9b8e-5f3b8c0d3a1e"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, cancel_order_answer, mm2::cancel_order_answer{}, R"({"result":"success"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, buy_request, mm2::buy_request{},
+                  R"({"userpass":"pass","method":"buy","base":"RICK","rel":"MORTY","price":"1.0245","volume":"10"})");
+BENCHMARK_CAPTURE(BM_mm2_decode, buy_answer, mm2::buy_answer{},
+                  R"({"result":{"action":"Buy","base":"RICK","rel":"MORTY","base_amount":"10","rel_amount":"10.245",)"
+                  R"("method":"request","dest_pub_key":"0000000000000000000000000000000000000000000000000000000000000000",)"
+                  R"("sender_pubkey":"02b3f4e6a7b8c9d0e1f2a3b4c5d6e7f8a9b0c1d2e3f4a5b6c7d8e9f0a1b2c3d4",)"
+                  R"("uuid":"6a4fa2fc-8a6e-4a3f-9b8e-5f3b8c0d3a1e"}})");
+BENCHMARK_CAPTURE(BM_mm2_decode, cancel_all_orders_request, mm2::cancel_all_orders_request{},
+                  R"({"userpass":"pass","method":"cancel_all_orders","cancel_by":{"type":"Pair","data":{"base":"RICK","rel":"MORTY"}}})");
+BENCHMARK_CAPTURE(BM_mm2_decode, cancel_all_orders_answer, mm2::cancel_all_orders_answer{},
+                  R"({"result":{"cancelled":["6a4fa2fc-8a6e-4a3f-9b8e-5f3b8c0d3a1e"],"currently_matching":[]}})");
@@ -15,13 +15,15 @@
  ******************************************************************************/
 
 #include <cstdlib>
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
 #include "mm2.client.hpp"
 
 namespace antara::mmbot::mm2
 {
     void to_json(nlohmann::json &j, const electrum_request &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         j["coin"] = cfg.coin_name;
         j["servers"] = cfg.servers;
         j["tx_history"] = cfg.with_tx_history;
@@ -29,7 +31,7 @@ namespace antara::mmbot::mm2
 
     void from_json(const nlohmann::json &j, electrum_answer &answer)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         j.at("address").get_to(answer.address);
         j.at("balance").get_to(answer.balance);
         j.at("result").get_to(answer.result);
@@ -37,14 +39,14 @@ namespace antara::mmbot::mm2
 
     void to_json(nlohmann::json &j, const orderbook_request &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         j["base"] = cfg.trading_pair.base.symbol.value();
         j["rel"] = cfg.trading_pair.quote.symbol.value();
     }
 
     void from_json(const nlohmann::json &j, order_contents &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         std::string coin;
         j.at("coin").get_to(coin);
         cfg.coin.symbol = st_symbol{coin};
@@ -61,19 +63,19 @@ namespace antara::mmbot::mm2
 
     void from_json(const nlohmann::json &j, orderbook_bids &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         from_json(j, cfg.bids_contents);
     }
 
     void from_json(const nlohmann::json &j, orderbook_asks &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         from_json(j, cfg.ask_contents);
     }
 
     void from_json(const nlohmann::json &j, orderbook_answer &cfg)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         j.at("askdepth").get_to(cfg.ask_depth);
         j.at("biddepth").get_to(cfg.bid_depth);
         j.at("netid").get_to(cfg.net_id);
@@ -155,7 +157,7 @@ namespace antara::mmbot::mm2
         j.at("result").at("uuid").get_to(cfg.result_setprice.uuid);
         j.at("result").at("started_swaps").get_to(cfg.result_setprice.started_swaps);
         j.at("result").at("max_base_vol").get_to(cfg.result_setprice.max_base_vol);
-        j.at("result").at("min_base_vol").get_to(cfg.result_setprice.max_base_vol);
+        j.at("result").at("min_base_vol").get_to(cfg.result_setprice.min_base_vol);
         j.at("result").at("created_at").get_to(cfg.result_setprice.created_at);
         cfg.result_setprice.matches = j.at("result").at("matches");
     }
@@ -220,146 +222,323 @@ namespace antara::mmbot::mm2
             cfg.data.value().rel = antara::asset{st_symbol{j.at("cancel_by").at("data").at("rel").get<std::string>()}};
         }
     }
+
+    void from_json(const nlohmann::json &j, maker_order_contents &cfg)
+    {
+        j.at("uuid").get_to(cfg.uuid);
+        cfg.base = antara::asset{st_symbol{j.at("base").get<std::string>()}};
+        cfg.rel = antara::asset{st_symbol{j.at("rel").get<std::string>()}};
+        j.at("price").get_to(cfg.price);
+        j.at("max_base_vol").get_to(cfg.max_base_vol);
+        cfg.available_amount = j.value("available_amount", cfg.max_base_vol);
+        cfg.started_swaps = j.value("started_swaps", std::vector<std::string>{});
+        cfg.cancellable = j.value("cancellable", true);
+    }
+
+    void from_json(const nlohmann::json &j, taker_order_contents &cfg)
+    {
+        const auto &request = j.at("request");
+        request.at("uuid").get_to(cfg.uuid);
+        request.at("action").get_to(cfg.action);
+        cfg.base = antara::asset{st_symbol{request.at("base").get<std::string>()}};
+        cfg.rel = antara::asset{st_symbol{request.at("rel").get<std::string>()}};
+        request.at("base_amount").get_to(cfg.base_amount);
+        request.at("rel_amount").get_to(cfg.rel_amount);
+    }
+
+    void from_json(const nlohmann::json &j, my_orders_answer &cfg)
+    {
+        //! both are objects keyed by uuid.
+        for (auto &&[uuid, order] : j.at("result").at("maker_orders").items()) {
+            cfg.maker_orders.push_back(order.get<maker_order_contents>());
+        }
+        for (auto &&[uuid, order] : j.at("result").at("taker_orders").items()) {
+            cfg.taker_orders.push_back(order.get<taker_order_contents>());
+        }
+    }
+
+    void to_json(nlohmann::json &j, const my_recent_swaps_request &cfg)
+    {
+        j["limit"] = cfg.limit;
+        if (cfg.from_uuid.has_value()) {
+            j["from_uuid"] = cfg.from_uuid.value();
+        }
+    }
+
+    void from_json(const nlohmann::json &j, swap_contents &cfg)
+    {
+        j.at("uuid").get_to(cfg.uuid);
+        cfg.my_order_uuid = j.value("my_order_uuid", std::string{});
+        j.at("type").get_to(cfg.type);
+        const auto &my_info = j.at("my_info");
+        cfg.my_coin = antara::asset{st_symbol{my_info.at("my_coin").get<std::string>()}};
+        cfg.other_coin = antara::asset{st_symbol{my_info.at("other_coin").get<std::string>()}};
+        my_info.at("my_amount").get_to(cfg.my_amount);
+        my_info.at("other_amount").get_to(cfg.other_amount);
+        cfg.started_at = my_info.value("started_at", 0ll);
+        const auto error_events = j.value("error_events", std::vector<std::string>{});
+        cfg.finished = false;
+        cfg.failed = false;
+        for (auto &&event : j.at("events")) {
+            const auto type = event.at("event").at("type").get<std::string>();
+            cfg.finished = type == "Finished";
+            cfg.failed = cfg.failed || std::find(error_events.begin(), error_events.end(), type) != error_events.end();
+        }
+    }
+
+    void from_json(const nlohmann::json &j, my_recent_swaps_answer &cfg)
+    {
+        j.at("result").at("swaps").get_to(cfg.swaps);
+        cfg.total = j.at("result").value("total", cfg.swaps.size());
+    }
+}
+namespace
+{
+    constexpr std::chrono::milliseconds mm2_ready_timeout{10000};
+    constexpr std::chrono::milliseconds mm2_ready_poll_interval{20};
+    constexpr std::chrono::milliseconds coins_activation_timeout{60000};
+
+    antara::mmbot::metrics::histogram &rpc_latency(const char *method)
+    {
+        using namespace antara::mmbot;
+        return metrics::get_histogram("mmbot_mm2_rpc_latency_us", metrics::label("method", method));
+    }
 }
+
 namespace antara::mmbot
 {
-    mm2_client::mm2_client(bool should_enable_coins)
+    mm2_client::mm2_client(bool should_enable_coins, bool wait_for_coins)
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        using namespace std::literals;
-        std::array<std::string, 1> args = {(std::filesystem::current_path() / "assets/mm2").string()};
-        auto path = (std::filesystem::current_path() / "assets/").string();
-        auto ec = background_.start(args, nullptr, path.c_str());
-        if (ec) {
-            VLOG_SCOPE_F(loguru::Verbosity_ERROR, "error: %s", ec.message().c_str());
-        }
-        ec = background_.wait(5s);
-        if (ec != reproc::error::wait_timeout) {
-            VLOG_SCOPE_F(loguru::Verbosity_ERROR, "error: %s", ec.message().c_str());
+        if (get_mmbot_config().mm2_endpoint.has_value()) {
+            //! an mm2 already running (or the mock server), nothing to launch.
+            DVLOG_F(loguru::Verbosity_INFO, "using the mm2 listening on %s", endpoint_.c_str());
         } else {
-            VLOG_SCOPE_F(loguru::Verbosity_INFO, "mm2 successfully launched");
+            std::array<std::string, 1> args = {(std::filesystem::current_path() / "assets/mm2").string()};
+            auto path = (std::filesystem::current_path() / "assets/").string();
+            auto ec = background_.start(args, nullptr, path.c_str());
+            if (ec) {
+                VLOG_SCOPE_F(loguru::Verbosity_ERROR, "error: %s", ec.message().c_str());
+            }
+            sink_thread_ = std::thread(
+                    [this]() { this->background_.drain(reproc::stream::out, reproc::sink::discard()); });
+            if (wait_until_ready()) {
+                VLOG_SCOPE_F(loguru::Verbosity_INFO, "mm2 successfully launched");
+            }
+            launched_ = true;
         }
-        sink_thread_ = std::thread(
-                [this]() { this->background_.drain(reproc::stream::out, reproc::sink::discard()); });
         if (should_enable_coins) {
-            enable_tests_coins();
+            enable_coins(wait_for_coins);
         }
     }
 
     mm2_client::~mm2_client() noexcept
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        auto ec = background_.stop(reproc::cleanup::terminate, reproc::milliseconds(2000), reproc::cleanup::kill,
-                                   reproc::infinite);
-        if (ec) {
-            VLOG_SCOPE_F(loguru::Verbosity_ERROR, "error: %s", ec.message().c_str());
+        coin_activation_.stop();
+        rpc_workers_.stop();
+        if (launched_) {
+            auto ec = background_.stop(reproc::cleanup::terminate, reproc::milliseconds(2000), reproc::cleanup::kill,
+                                       reproc::infinite);
+            if (ec) {
+                VLOG_SCOPE_F(loguru::Verbosity_ERROR, "error: %s", ec.message().c_str());
+            }
+            sink_thread_.join();
         }
-        sink_thread_.join();
     }
 
-    mm2::electrum_answer mm2_client::rpc_electrum(mm2::electrum_request &&request)
+    bool mm2_client::wait_until_ready()
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < mm2_ready_timeout) {
+            if (auto ec = background_.wait(reproc::milliseconds(0)); ec != reproc::error::wait_timeout) {
+                VLOG_SCOPE_F(loguru::Verbosity_ERROR, "mm2 exited before being ready: %s", ec.message().c_str());
+                return false;
+            }
+            if (rpc_version().rpc_result_code == 200) {
+                DVLOG_F(loguru::Verbosity_INFO, "mm2 ready after %lld ms",
+                        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - start).count()));
+                return true;
+            }
+            std::this_thread::sleep_for(mm2_ready_poll_interval);
+        }
+        VLOG_SCOPE_F(loguru::Verbosity_ERROR, "mm2 not ready after %lld ms",
+                     static_cast<long long>(mm2_ready_timeout.count()));
+        return false;
+    }
+
+    mm2::electrum_answer mm2_client::rpc_electrum(mm2::electrum_request &&request)
+    {
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("electrum");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("electrum");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::electrum_answer>(resp);
     }
 
     mm2::orderbook_answer mm2_client::rpc_orderbook(mm2::orderbook_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("orderbook");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("orderbook");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
-        return rpc_process_call<mm2::orderbook_answer>(resp);
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
+        auto answer = rpc_process_call<mm2::orderbook_answer>(resp);
+        if (answer.rpc_result_code == 200) {
+            for (auto &&observer : orderbook_observers_) {
+                observer(answer);
+            }
+        }
+        return answer;
     }
 
     mm2::balance_answer mm2_client::rpc_balance(mm2::balance_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("my_balance");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("my_balance");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::balance_answer>(resp);
     }
 
-    bool mm2_client::enable_tests_coins()
+    bool mm2_client::enable_coins(bool wait_for_coins)
     {
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        bool res = true;
-        const auto &mmbot_config = get_mmbot_config();
-        for (auto&&[current_coin, current_coin_data] : mmbot_config.registry_additional_coin_infos) {
-            if (current_coin_data.is_mm2_compatible) {
-                if (current_coin_data.is_electrum_compatible && (current_coin == "RICK" || current_coin == "MORTY")) {
-                    std::vector<electrum_server> servers;
-                    std::copy(begin(current_coin_data.servers_electrum), end(current_coin_data.servers_electrum),
-                              std::back_inserter(servers));
-                    mm2::electrum_request request{current_coin, servers};
-                    auto answer = rpc_electrum(std::move(request));
-                    res &= answer.rpc_result_code == 200;
-                }
-            }
+        coin_activation_.activate(get_mmbot_config().coins_to_activate);
+        if (!wait_for_coins) {
+            return false;
         }
-        return res;
+        return coin_activation_.wait_until_settled(coins_activation_timeout);
+    }
+
+    const coin_activation_manager &mm2_client::get_coin_activation() const noexcept
+    {
+        return coin_activation_;
+    }
+
+    bool mm2_client::is_pair_ready(const antara::pair &pair) const
+    {
+        return coin_activation_.is_pair_ready(pair);
     }
 
     nlohmann::json mm2_client::template_request(std::string method_name) noexcept
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         return {{"method",   method_name},
                 {"userpass", get_mmbot_config().mm2_rpc_password}};
     }
 
     mm2::version_answer mm2_client::rpc_version()
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("version");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("version");
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::version_answer>(resp);
     }
 
     mm2::setprice_answer mm2_client::rpc_setprice(mm2::setprice_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("setprice");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("setprice");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::setprice_answer>(resp);
     }
 
     mm2::cancel_order_answer mm2_client::rpc_cancel_order(mm2::cancel_order_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("cancel_order");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("cancel_order");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::cancel_order_answer>(resp);
     }
 
     mm2::buy_answer mm2_client::rpc_buy(mm2::buy_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("buy");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("buy");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::buy_answer>(resp);
     }
 
     mm2::cancel_all_orders_answer mm2_client::rpc_cancel_all_orders(mm2::cancel_all_orders_request &&request)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("cancel_all_orders");
+        metrics::scoped_timer timer(latency);
         auto json_data = template_request("cancel_all_orders");
         mm2::to_json(json_data, request);
         DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
-        auto resp = RestClient::post(antara::mmbot::mm2_endpoint, "application/json", json_data.dump());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
         return rpc_process_call<mm2::cancel_all_orders_answer>(resp);
     }
+
+    mm2::my_orders_answer mm2_client::rpc_my_orders()
+    {
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("my_orders");
+        metrics::scoped_timer timer(latency);
+        auto json_data = template_request("my_orders");
+        DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
+        return rpc_process_call<mm2::my_orders_answer>(resp);
+    }
+
+    mm2::my_recent_swaps_answer mm2_client::rpc_my_recent_swaps(mm2::my_recent_swaps_request &&request)
+    {
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = rpc_latency("my_recent_swaps");
+        metrics::scoped_timer timer(latency);
+        auto json_data = template_request("my_recent_swaps");
+        mm2::to_json(json_data, request);
+        DVLOG_F(loguru::Verbosity_INFO, "request: %s", json_data.dump().c_str());
+        auto resp = RestClient::post(endpoint_, "application/json", json_data.dump());
+        return rpc_process_call<mm2::my_recent_swaps_answer>(resp);
+    }
+
+    RestClient::Response mm2_client::post_batch(const std::string &method, const nlohmann::json &batch)
+    {
+        MMBOT_TRACE_FUNCTION();
+        metrics::scoped_timer timer(metrics::get_histogram("mmbot_mm2_rpc_batch_latency_us",
+                                                           metrics::label("method", method)));
+        metrics::get_counter("mmbot_mm2_rpc_batched_total", metrics::label("method", method)).inc(batch.size());
+        auto body = batch.dump();
+        if (logging::should_log_payload()) {
+            DVLOG_F(loguru::Verbosity_INFO, "request: %s", body.c_str());
+        }
+        auto resp = RestClient::post(endpoint_, "application/json", body);
+        if (logging::should_log_payload()) {
+            DVLOG_F(loguru::Verbosity_INFO, "resp: %s", resp.body.c_str());
+        }
+        return resp;
+    }
+
+    void mm2_client::add_orderbook_observer(orderbook_observer observer)
+    {
+        orderbook_observers_.push_back(std::move(observer));
+    }
 }
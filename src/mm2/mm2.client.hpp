@@ -20,11 +20,15 @@
 #include <algorithm>
 #include <string>
 #include <thread>
+#include <functional>
 #include <restclient-cpp/restclient.h>
 #include <reproc++/reproc.hpp>
 #include <reproc++/sink.hpp>
 #include "http/http.endpoints.hpp"
+#include "logging/payload.sampler.hpp"
+#include "utils/antara.worker.pool.hpp"
 #include "config/config.hpp"
+#include "mm2/mm2.coin.activation.hpp"
 
 namespace antara::mmbot
 {
@@ -243,13 +247,87 @@ namespace antara::mmbot
         void to_json(nlohmann::json &j, const cancel_all_orders_request &cfg);
         void from_json(const nlohmann::json &j, cancel_all_orders_request &cfg);
         void from_json(const nlohmann::json &j, cancel_all_orders_answer &cfg);
+
+        struct maker_order_contents
+        {
+            std::string uuid;
+            antara::asset base;
+            antara::asset rel;
+            std::string price;
+            std::string max_base_vol;
+            std::string available_amount;
+            std::vector<std::string> started_swaps;
+            bool cancellable;
+        };
+
+        struct taker_order_contents
+        {
+            std::string uuid;
+            std::string action;
+            antara::asset base;
+            antara::asset rel;
+            std::string base_amount;
+            std::string rel_amount;
+        };
+
+        struct my_orders_answer
+        {
+            std::vector<maker_order_contents> maker_orders;
+            std::vector<taker_order_contents> taker_orders;
+            std::string result;
+            int rpc_result_code;
+        };
+
+        void from_json(const nlohmann::json &j, maker_order_contents &cfg);
+        void from_json(const nlohmann::json &j, taker_order_contents &cfg);
+        void from_json(const nlohmann::json &j, my_orders_answer &cfg);
+
+        struct my_recent_swaps_request
+        {
+            std::size_t limit{10};
+            std::optional<std::string> from_uuid{std::nullopt};
+        };
+
+        struct swap_contents
+        {
+            std::string uuid;
+            //! the maker or taker order the swap started from, empty with the mm2 versions that don't report it.
+            std::string my_order_uuid;
+            //! Maker or Taker.
+            std::string type;
+            antara::asset my_coin;
+            antara::asset other_coin;
+            std::string my_amount;
+            std::string other_amount;
+            long long started_at;
+            //! the last event is Finished.
+            bool finished;
+            //! one of the events is an error event.
+            bool failed;
+        };
+
+        struct my_recent_swaps_answer
+        {
+            std::vector<swap_contents> swaps;
+            std::size_t total;
+            std::string result;
+            int rpc_result_code;
+        };
+
+        void to_json(nlohmann::json &j, const my_recent_swaps_request &cfg);
+        void from_json(const nlohmann::json &j, swap_contents &cfg);
+        void from_json(const nlohmann::json &j, my_recent_swaps_answer &cfg);
     }
 
 
     class mm2_client
     {
     public:
-        explicit mm2_client(bool should_enable_coins = true);
+        using orderbook_observer = std::function<void(const mm2::orderbook_answer &)>;
+
+        //! launches assets/mm2 unless the config gives the mm2_endpoint of an already running one.
+        //! the coins_to_activate are activated in the background, the constructor waits for them unless told not to.
+        explicit mm2_client(bool should_enable_coins = true, bool wait_for_coins = true);
 
         ~mm2_client() noexcept;
 
@@ -269,17 +347,118 @@ namespace antara::mmbot
 
         mm2::version_answer rpc_version();
 
+        mm2::my_orders_answer rpc_my_orders();
+
+        mm2::my_recent_swaps_answer rpc_my_recent_swaps(mm2::my_recent_swaps_request &&request);
+
+        /**
+         * @brief Send all the `requests` of `method` in one JSON-RPC batch, one http round trip instead of one per
+         *        request. The answers are in the order of the requests, a failed request only fails its own answer.
+         *
+         *  Example:
+         *  @code{.cpp}
+         *   auto answers = client.rpc_batch<mm2::cancel_order_answer>("cancel_order", std::move(cancel_requests));
+         *  @endcode
+         */
+        template<typename RpcReturnType, typename RpcRequest>
+        std::vector<RpcReturnType> rpc_batch(const std::string &method, std::vector<RpcRequest> &&requests)
+        {
+            std::vector<RpcReturnType> answers(requests.size());
+            if (requests.empty()) {
+                return answers;
+            }
+            auto batch = nlohmann::json::array();
+            for (auto &&request : requests) {
+                auto json_data = template_request(method);
+                mm2::to_json(json_data, request);
+                batch.push_back(std::move(json_data));
+            }
+            auto resp = post_batch(method, batch);
+            nlohmann::json json_answers;
+            if (resp.code == 200) {
+                try {
+                    json_answers = nlohmann::json::parse(resp.body);
+                }
+                catch (const std::exception &error) {
+                    resp.code = -1;
+                    resp.body = error.what();
+                }
+            }
+            if (resp.code != 200 || !json_answers.is_array() || json_answers.size() != answers.size()) {
+                for (auto &&answer : answers) {
+                    answer.rpc_result_code = resp.code == 200 ? -1 : resp.code;
+                    answer.result = resp.body;
+                }
+                return answers;
+            }
+            for (std::size_t idx = 0; idx < answers.size(); ++idx) {
+                auto &answer = answers[idx];
+                const auto &json_answer = json_answers[idx];
+                answer.result = json_answer.dump();
+                if (json_answer.contains("error")) {
+                    answer.rpc_result_code = 500;
+                    continue;
+                }
+                try {
+                    mm2::from_json(json_answer, answer);
+                    answer.rpc_result_code = 200;
+                }
+                catch (const std::exception &error) {
+                    answer.rpc_result_code = -1;
+                    answer.result = error.what();
+                }
+            }
+            return answers;
+        }
+
+        //! called with every successful orderbook answer, must be added before the client is shared between threads.
+        void add_orderbook_observer(orderbook_observer observer);
+
+        //! per coin activation state, a pair can be traded as soon as both of its coins are active.
+        const coin_activation_manager &get_coin_activation() const noexcept;
+
+        bool is_pair_ready(const antara::pair &pair) const;
+
+        /**
+         * @brief Run the blocking `rpc` functor on the rpc worker pool and give its answer to `on_completion`
+         *        from that worker, the caller never waits on mm2.
+         *
+         *  Example:
+         *  @code{.cpp}
+         *   client.async_call([&client]() { return client.rpc_version(); }, [](auto &&answer) { ... });
+         *  @endcode
+         */
+        template<typename RpcFunctor, typename CompletionFunctor>
+        void async_call(RpcFunctor &&rpc, CompletionFunctor &&on_completion)
+        {
+            auto posted = rpc_workers_.post([rpc, on_completion]() mutable {
+                on_completion(rpc());
+            });
+            if (!posted) {
+                std::invoke_result_t<RpcFunctor> answer{};
+                answer.rpc_result_code = 503;
+                answer.result = "mm2 client is stopping";
+                on_completion(std::move(answer));
+            }
+        }
 
     private:
         nlohmann::json template_request(std::string method_name) noexcept;
 
-        bool enable_tests_coins();
+        RestClient::Response post_batch(const std::string &method, const nlohmann::json &batch);
+
+        bool enable_coins(bool wait_for_coins);
+
+        //! poll the launched mm2 until it answers, instead of waiting a fixed amount of time.
+        bool wait_until_ready();
 
         template<typename RpcReturnType>
         RpcReturnType rpc_process_call(const RestClient::Response &resp)
         {
             RpcReturnType answer;
-            DVLOG_F(loguru::Verbosity_INFO, "resp: %s", resp.body.c_str());
+            if (logging::should_log_payload()) {
+                DVLOG_F(loguru::Verbosity_INFO, "resp: %s", resp.body.c_str());
+            }
             if (resp.code != 200) {
                 answer.rpc_result_code = resp.code;
                 answer.result = resp.body;
@@ -301,8 +480,15 @@ namespace antara::mmbot
         }
 
     private:
+        std::string endpoint_{get_mmbot_config().mm2_endpoint.value_or(antara::mmbot::mm2_endpoint)};
+        bool launched_{false};
         reproc::process background_{reproc::cleanup::terminate, reproc::milliseconds(2000), reproc::cleanup::kill,
                                     reproc::infinite};
         std::thread sink_thread_;
+        std::vector<orderbook_observer> orderbook_observers_;
+        antara::worker_pool rpc_workers_{get_mmbot_config().mm2_rpc_thread_pool_size};
+        coin_activation_manager coin_activation_{[this](mm2::electrum_request &&request) {
+            return this->rpc_electrum(std::move(request));
+        }};
     };
 }
\ No newline at end of file
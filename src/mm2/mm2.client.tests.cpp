@@ -15,6 +15,7 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <future>
 #include <doctest/doctest.h>
 #include <restclient-cpp/restclient.h>
 #include "mm2.client.hpp"
@@ -43,6 +44,14 @@ namespace antara::mmbot::tests
             CHECK_EQ(500, answer.rpc_result_code);
         }
 
+        SUBCASE("mm2 rpc are completed asynchronously")
+        {
+            std::promise<int> version_code;
+            mm2.async_call([&mm2]() { return mm2.rpc_version(); },
+                           [&version_code](auto &&answer) { version_code.set_value(answer.rpc_result_code); });
+            CHECK_EQ(200, version_code.get_future().get());
+        }
+
         SUBCASE("mm2 rpc my_balance")
         {
             mm2::balance_request request({antara::asset{st_symbol{"RICK"}}});
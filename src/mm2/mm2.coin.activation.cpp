@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <loguru.hpp>
+#include "mm2/mm2.client.hpp"
+#include "mm2/mm2.coin.activation.hpp"
+
+namespace antara::mmbot
+{
+    const char *to_string(coin_activation_state state) noexcept
+    {
+        switch (state) {
+            case coin_activation_state::pending:
+                return "pending";
+            case coin_activation_state::activating:
+                return "activating";
+            case coin_activation_state::active:
+                return "active";
+            case coin_activation_state::failed:
+                return "failed";
+        }
+        return "unknown";
+    }
+
+    coin_activation_manager::coin_activation_manager(electrum_rpc rpc, coin_activation_options options) :
+            rpc_(std::move(rpc)), options_(options), workers_(std::max<std::size_t>(1, options.nb_workers))
+    {
+    }
+
+    coin_activation_manager::~coin_activation_manager() noexcept
+    {
+        stop();
+    }
+
+    void coin_activation_manager::activate(const std::vector<std::string> &coins)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        const auto cfg = get_mmbot_config_snapshot();
+        const auto &registry = cfg->registry_additional_coin_infos;
+        for (auto &&coin : coins) {
+            auto coin_info = registry.find(coin);
+            if (coin_info == registry.end() || !coin_info->second.is_mm2_compatible ||
+                !coin_info->second.is_electrum_compatible || coin_info->second.servers_electrum.empty()) {
+                DVLOG_F(loguru::Verbosity_ERROR, "%s has no electrum servers, it can't be activated", coin.c_str());
+                set_state(coin, coin_activation_state::failed);
+                continue;
+            }
+            set_state(coin, coin_activation_state::pending);
+            auto servers = coin_info->second.servers_electrum;
+            if (!workers_.post([this, coin, servers = std::move(servers)]() { activate_coin(coin, servers); })) {
+                set_state(coin, coin_activation_state::failed);
+            }
+        }
+    }
+
+    void coin_activation_manager::set_state_listener(state_listener listener)
+    {
+        listener_ = std::move(listener);
+    }
+
+    bool coin_activation_manager::wait_until_settled(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock lock(mutex_);
+        auto settled = [this]() {
+            return std::none_of(states_.begin(), states_.end(), [](auto &&coin_state) {
+                return coin_state.second == coin_activation_state::pending ||
+                       coin_state.second == coin_activation_state::activating;
+            });
+        };
+        cv_.wait_for(lock, timeout, settled);
+        return std::all_of(states_.begin(), states_.end(), [](auto &&coin_state) {
+            return coin_state.second == coin_activation_state::active;
+        });
+    }
+
+    coin_activation_state coin_activation_manager::get_state(const std::string &coin) const
+    {
+        std::scoped_lock lock(mutex_);
+        auto it = states_.find(coin);
+        return it == states_.end() ? coin_activation_state::pending : it->second;
+    }
+
+    bool coin_activation_manager::is_active(const std::string &coin) const
+    {
+        return get_state(coin) == coin_activation_state::active;
+    }
+
+    bool coin_activation_manager::is_pair_ready(const antara::pair &pair) const
+    {
+        return is_active(pair.base.symbol.value()) && is_active(pair.quote.symbol.value());
+    }
+
+    std::unordered_map<std::string, coin_activation_state> coin_activation_manager::get_states() const
+    {
+        std::scoped_lock lock(mutex_);
+        return states_;
+    }
+
+    void coin_activation_manager::stop() noexcept
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        workers_.stop();
+    }
+
+    void coin_activation_manager::activate_coin(const std::string &coin, std::vector<electrum_server> servers)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        auto backoff = options_.initial_backoff;
+        for (std::size_t attempt = 1; attempt <= options_.max_attempts; ++attempt) {
+            {
+                //! the coins still queued when stopping are drained without calling mm2.
+                std::scoped_lock lock(mutex_);
+                if (stopped_) {
+                    break;
+                }
+            }
+            set_state(coin, coin_activation_state::activating);
+            auto answer = rpc_(mm2::electrum_request{coin, servers});
+            if (answer.rpc_result_code == 200) {
+                DVLOG_F(loguru::Verbosity_INFO, "%s activated after %zu attempt(s)", coin.c_str(), attempt);
+                set_state(coin, coin_activation_state::active);
+                return;
+            }
+            DVLOG_F(loguru::Verbosity_WARNING, "%s activation attempt %zu failed: %s", coin.c_str(), attempt,
+                    answer.result.c_str());
+            if (attempt == options_.max_attempts) {
+                break;
+            }
+            std::rotate(servers.begin(), servers.begin() + 1, servers.end());
+            std::unique_lock lock(mutex_);
+            if (cv_.wait_for(lock, backoff, [this]() { return stopped_; })) {
+                break;
+            }
+            backoff = std::min(backoff * 2, options_.max_backoff);
+        }
+        set_state(coin, coin_activation_state::failed);
+    }
+
+    void coin_activation_manager::set_state(const std::string &coin, coin_activation_state state)
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            states_.insert_or_assign(coin, state);
+        }
+        cv_.notify_all();
+        if (listener_) {
+            listener_(coin, state);
+        }
+    }
+}
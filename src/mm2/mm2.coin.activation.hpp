@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/antara.worker.pool.hpp"
+#include "config/config.hpp"
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot
+{
+    namespace mm2
+    {
+        struct electrum_request;
+        struct electrum_answer;
+    }
+
+    enum class coin_activation_state
+    {
+        pending, activating, active, failed
+    };
+
+    const char *to_string(coin_activation_state state) noexcept;
+
+    struct coin_activation_options
+    {
+        std::size_t nb_workers{4};
+        std::size_t max_attempts{5};
+        std::chrono::milliseconds initial_backoff{500};
+        std::chrono::milliseconds max_backoff{8000};
+    };
+
+    /**
+     * @brief Activates electrum coins concurrently and tracks the state of each one. A failed activation is retried
+     *        with an exponential backoff, the next server of the coin being tried first, until max_attempts.
+     *        A pair is ready as soon as both of its coins are active, whatever the state of the other coins.
+     */
+    class coin_activation_manager
+    {
+    public:
+        using electrum_rpc = std::function<mm2::electrum_answer(mm2::electrum_request &&)>;
+        using state_listener = std::function<void(const std::string &, coin_activation_state)>;
+
+        explicit coin_activation_manager(electrum_rpc rpc, coin_activation_options options = {});
+
+        ~coin_activation_manager() noexcept;
+
+        coin_activation_manager(const coin_activation_manager &) = delete;
+
+        coin_activation_manager &operator=(const coin_activation_manager &) = delete;
+
+        //! queue the activation of the coins, the ones without electrum servers in the config fail right away.
+        void activate(const std::vector<std::string> &coins);
+
+        //! called on every state change from the activation threads, must be set before activate().
+        void set_state_listener(state_listener listener);
+
+        //! block until no coin is pending or activating, returns true if they are all active.
+        bool wait_until_settled(std::chrono::milliseconds timeout) const;
+
+        //! coins never given to activate() are pending.
+        [[nodiscard]] coin_activation_state get_state(const std::string &coin) const;
+
+        [[nodiscard]] bool is_active(const std::string &coin) const;
+
+        [[nodiscard]] bool is_pair_ready(const antara::pair &pair) const;
+
+        [[nodiscard]] std::unordered_map<std::string, coin_activation_state> get_states() const;
+
+        //! interrupt the backoffs and join the activation threads.
+        void stop() noexcept;
+
+    private:
+        void activate_coin(const std::string &coin, std::vector<electrum_server> servers);
+
+        void set_state(const std::string &coin, coin_activation_state state);
+
+        electrum_rpc rpc_;
+        coin_activation_options options_;
+        state_listener listener_;
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cv_;
+        std::unordered_map<std::string, coin_activation_state> states_;
+        bool stopped_{false};
+        antara::worker_pool workers_;
+    };
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <doctest/doctest.h>
+#include "config/config.hpp"
+#include "mm2/mm2.client.hpp"
+#include "mm2/mm2.coin.activation.hpp"
+
+namespace
+{
+    antara::mmbot::coin_activation_options fast_options()
+    {
+        antara::mmbot::coin_activation_options options;
+        options.initial_backoff = std::chrono::milliseconds{1};
+        options.max_backoff = std::chrono::milliseconds{4};
+        return options;
+    }
+
+    antara::mmbot::mm2::electrum_answer electrum_answer(int code)
+    {
+        antara::mmbot::mm2::electrum_answer answer;
+        answer.rpc_result_code = code;
+        return answer;
+    }
+}
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("coins are activated and retried until their servers answer")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        std::atomic_int nb_rick_calls{0};
+        std::vector<std::string> first_servers;
+        std::mutex first_servers_mutex;
+        coin_activation_manager manager([&](mm2::electrum_request &&request) {
+            if (request.coin_name == "RICK") {
+                {
+                    std::scoped_lock lock(first_servers_mutex);
+                    first_servers.push_back(request.servers.front().url);
+                }
+                return electrum_answer(++nb_rick_calls < 3 ? 500 : 200);
+            }
+            return electrum_answer(200);
+        }, fast_options());
+        manager.activate({"RICK", "MORTY"});
+        CHECK(manager.wait_until_settled(std::chrono::seconds{5}));
+        CHECK_EQ(3, nb_rick_calls.load());
+        CHECK(manager.is_active("RICK"));
+        CHECK(manager.is_active("MORTY"));
+        CHECK(manager.is_pair_ready(antara::pair::of("RICK", "MORTY")));
+        if (get_mmbot_config().registry_additional_coin_infos.at("RICK").servers_electrum.size() > 1) {
+            CHECK_NE(first_servers[0], first_servers[1]);
+        }
+    }
+
+    TEST_CASE ("a pair is ready as soon as its coins are active")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        coin_activation_manager manager([](mm2::electrum_request &&request) {
+            return electrum_answer(request.coin_name == "MORTY" ? 500 : 200);
+        }, fast_options());
+        std::vector<std::pair<std::string, coin_activation_state>> changes;
+        std::mutex changes_mutex;
+        manager.set_state_listener([&](const std::string &coin, coin_activation_state state) {
+            std::scoped_lock lock(changes_mutex);
+            changes.emplace_back(coin, state);
+        });
+        manager.activate({"RICK", "MORTY", "UNKNOWN_COIN"});
+        CHECK_FALSE(manager.wait_until_settled(std::chrono::seconds{5}));
+        CHECK_EQ(coin_activation_state::active, manager.get_state("RICK"));
+        CHECK_EQ(coin_activation_state::failed, manager.get_state("MORTY"));
+        CHECK_EQ(coin_activation_state::failed, manager.get_state("UNKNOWN_COIN"));
+        CHECK_EQ(coin_activation_state::pending, manager.get_state("KMD"));
+        CHECK_FALSE(manager.is_pair_ready(antara::pair::of("RICK", "MORTY")));
+        std::scoped_lock lock(changes_mutex);
+        CHECK(std::count(changes.begin(), changes.end(),
+                         std::make_pair(std::string("MORTY"), coin_activation_state::activating)) == 5);
+    }
+
+    TEST_CASE ("stopping interrupts the activation backoff")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        coin_activation_options options;
+        options.initial_backoff = std::chrono::seconds{30};
+        coin_activation_manager manager([](mm2::electrum_request &&) { return electrum_answer(500); }, options);
+        manager.activate({"RICK"});
+        auto start = std::chrono::steady_clock::now();
+        while (manager.get_state("RICK") == coin_activation_state::pending) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        manager.stop();
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{5});
+        CHECK_EQ(coin_activation_state::failed, manager.get_state("RICK"));
+    }
+
+    TEST_CASE ("the coins still queued when stopping don't call mm2")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        coin_activation_options options = fast_options();
+        options.nb_workers = 1;
+        std::atomic_bool released{false};
+        std::atomic_int nb_morty_calls{0};
+        coin_activation_manager manager([&](mm2::electrum_request &&request) {
+            if (request.coin_name == "MORTY") {
+                ++nb_morty_calls;
+                return electrum_answer(200);
+            }
+            while (!released) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return electrum_answer(200);
+        }, options);
+        manager.activate({"RICK", "MORTY"});
+        while (manager.get_state("RICK") != coin_activation_state::activating) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        std::thread stopping([&manager]() { manager.stop(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        released = true;
+        stopping.join();
+        CHECK_EQ(0, nb_morty_calls.load());
+        CHECK_EQ(coin_activation_state::active, manager.get_state("RICK"));
+        CHECK_EQ(coin_activation_state::failed, manager.get_state("MORTY"));
+    }
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <loguru.hpp>
+#include "mm2/mm2.mock.server.hpp"
+
+namespace
+{
+    std::atomic_bool stop_requested{false};
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        std::cerr << "usage: " << argv[0]
+                  << " [port] [latency_ms] [latency_jitter_ms] [error_rate] [orderbook_depth] [threads]\n"
+                  << "example: " << argv[0] << " 7783 20 10 0.01 50 4\n";
+        return 1;
+    }
+    antara::mmbot::mock_mm2_options options;
+    options.port = static_cast<unsigned short>(argc > 1 ? std::atoi(argv[1]) : 7783);
+    options.latency = std::chrono::milliseconds{argc > 2 ? std::atoi(argv[2]) : 0};
+    options.latency_jitter = std::chrono::milliseconds{argc > 3 ? std::atoi(argv[3]) : 0};
+    options.error_rate = argc > 4 ? std::atof(argv[4]) : 0.0;
+    options.orderbook_depth = static_cast<std::size_t>(argc > 5 ? std::atoi(argv[5]) : 20);
+    options.nb_threads = static_cast<std::size_t>(argc > 6 ? std::atoi(argv[6]) : 1);
+
+    std::signal(SIGINT, [](int) { stop_requested = true; });
+    std::signal(SIGTERM, [](int) { stop_requested = true; });
+    antara::mmbot::mock_mm2_server server(options);
+    server.start();
+    std::cerr << "mock mm2 listening on " << server.endpoint() << ", set \"mm2_endpoint\": \"" << server.endpoint()
+              << "\" in mmbot_config.json to use it" << std::endl;
+    while (!stop_requested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+    server.stop();
+    std::cerr << server.nb_requests() << " requests served" << std::endl;
+    return 0;
+}
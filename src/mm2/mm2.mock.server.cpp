@@ -0,0 +1,412 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <loguru.hpp>
+#include "mm2/mm2.mock.server.hpp"
+
+namespace
+{
+    nlohmann::json error_answer(const std::string &message)
+    {
+        return {{"error", message}};
+    }
+
+    long long now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::string multiply_amounts(const std::string &volume, const std::string &price)
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.8f", std::stod(volume) * std::stod(price));
+        return buffer;
+    }
+
+    void respond(const restinio::request_handle_t &req, const antara::mmbot::mock_mm2_reply &reply)
+    {
+        auto status = reply.status == 200 ? restinio::status_ok() : (reply.status == 400
+                                                                     ? restinio::status_bad_request()
+                                                                     : restinio::status_internal_server_error());
+        req->create_response(status).append_header(restinio::http_field::content_type, "application/json").set_body(
+                reply.body.dump()).done();
+    }
+}
+
+namespace antara::mmbot
+{
+    mock_mm2_server::mock_mm2_server(mock_mm2_options options) : options_(options), rng_(options.seed)
+    {
+    }
+
+    mock_mm2_server::~mock_mm2_server() noexcept
+    {
+        stop();
+    }
+
+    void mock_mm2_server::start()
+    {
+        server_ = std::make_unique<http_server>(restinio::own_io_context(), [this](auto &settings) {
+            settings.port(options_.port).address("127.0.0.1").request_handler(
+                    [this](auto req) { return this->on_request(std::move(req)); });
+        });
+        server_->open_sync();
+        for (std::size_t idx = 0; idx < std::max<std::size_t>(1, options_.nb_threads); ++idx) {
+            threads_.emplace_back([this]() { this->server_->io_context().run(); });
+        }
+        DVLOG_F(loguru::Verbosity_INFO, "mock mm2 listening on %s", endpoint().c_str());
+    }
+
+    void mock_mm2_server::stop() noexcept
+    {
+        if (server_ == nullptr) {
+            return;
+        }
+        try {
+            server_->close_sync();
+        }
+        catch (const std::exception &error) {
+            DVLOG_F(loguru::Verbosity_ERROR, "err: %s", error.what());
+        }
+        server_->io_context().stop();
+        for (auto &&thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+        server_.reset();
+    }
+
+    std::string mock_mm2_server::endpoint() const
+    {
+        return "http://127.0.0.1:" + std::to_string(options_.port);
+    }
+
+    std::size_t mock_mm2_server::nb_requests() const noexcept
+    {
+        return nb_requests_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t mock_mm2_server::nb_live_orders() const
+    {
+        std::scoped_lock lock(mutex_);
+        return orders_.size();
+    }
+
+    void mock_mm2_server::set_orderbook(const std::string &base, const std::string &rel, nlohmann::json orderbook)
+    {
+        std::scoped_lock lock(mutex_);
+        orderbooks_.insert_or_assign(base + "/" + rel, std::move(orderbook));
+    }
+
+    restinio::request_handling_status_t mock_mm2_server::on_request(restinio::request_handle_t req)
+    {
+        mock_mm2_reply reply{400, error_answer("invalid json")};
+        try {
+            reply = handle(nlohmann::json::parse(req->body()));
+        }
+        catch (const nlohmann::json::exception &error) {
+            reply.body = error_answer(error.what());
+        }
+        const auto delay = next_latency();
+        if (delay.count() == 0) {
+            respond(req, reply);
+            return restinio::request_accepted();
+        }
+        auto timer = std::make_shared<restinio::asio_ns::steady_timer>(server_->io_context(), delay);
+        timer->async_wait([timer, req, reply = std::move(reply)](const auto &) { respond(req, reply); });
+        return restinio::request_accepted();
+    }
+
+    std::chrono::microseconds mock_mm2_server::next_latency()
+    {
+        if (options_.latency_jitter.count() == 0) {
+            return options_.latency;
+        }
+        std::scoped_lock lock(mutex_);
+        std::uniform_int_distribution<std::int64_t> jitter(0, options_.latency_jitter.count());
+        return options_.latency + std::chrono::microseconds{jitter(rng_)};
+    }
+
+    std::string mock_mm2_server::next_uuid()
+    {
+        std::uniform_int_distribution<std::uint64_t> dist;
+        const auto high = dist(rng_);
+        const auto low = dist(rng_);
+        char buffer[37];
+        std::snprintf(buffer, sizeof(buffer), "%08llx-%04llx-4%03llx-a%03llx-%012llx",
+                      static_cast<unsigned long long>(high >> 32u),
+                      static_cast<unsigned long long>((high >> 16u) & 0xffffu),
+                      static_cast<unsigned long long>(high & 0xfffu),
+                      static_cast<unsigned long long>(low >> 52u),
+                      static_cast<unsigned long long>(low & 0xffffffffffffull));
+        return buffer;
+    }
+
+    nlohmann::json mock_mm2_server::make_orderbook(const std::string &base, const std::string &rel) const
+    {
+        auto make_level = [&base](double price) {
+            return nlohmann::json{{"coin",      base},
+                                  {"address",   "RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd"},
+                                  {"price",     price},
+                                  {"numutxos",  3},
+                                  {"avevolume", 10.0},
+                                  {"maxvolume", 30.0},
+                                  {"depth",     0.0},
+                                  {"pubkey",    "02b3f4e6a7b8c9d0e1f2a3b4c5d6e7f8a9b0c1d2e3f4a5b6c7d8e9f0a1b2c3d4e5"},
+                                  {"age",       10},
+                                  {"zcredits",  0}};
+        };
+        nlohmann::json orderbook{{"askdepth",  0},
+                                 {"biddepth",  0},
+                                 {"netid",     9999},
+                                 {"numasks",   options_.orderbook_depth},
+                                 {"numbids",   options_.orderbook_depth},
+                                 {"timestamp", std::chrono::duration_cast<std::chrono::seconds>(
+                                         std::chrono::system_clock::now().time_since_epoch()).count()},
+                                 {"base",      base},
+                                 {"rel",       rel},
+                                 {"asks",      nlohmann::json::array()},
+                                 {"bids",      nlohmann::json::array()}};
+        for (std::size_t idx = 1; idx <= options_.orderbook_depth; ++idx) {
+            const auto offset = options_.orderbook_mid * 0.001 * static_cast<double>(idx);
+            orderbook["asks"].push_back(make_level(options_.orderbook_mid + offset));
+            orderbook["bids"].push_back(make_level(options_.orderbook_mid - offset));
+        }
+        return orderbook;
+    }
+
+    std::string mock_mm2_server::start_swap(const std::string &uuid)
+    {
+        std::scoped_lock lock(mutex_);
+        auto it = orders_.find(uuid);
+        if (it == orders_.end()) {
+            return {};
+        }
+        auto swap_uuid = next_uuid();
+        it->second.started_swaps.push_back(swap_uuid);
+        swaps_.push_back(swap{swap_uuid, uuid, it->second, now_ms(), false});
+        return swap_uuid;
+    }
+
+    void mock_mm2_server::finish_swap(const std::string &swap_uuid)
+    {
+        std::scoped_lock lock(mutex_);
+        auto it = std::find_if(swaps_.begin(), swaps_.end(), [&swap_uuid](auto &&s) { return s.uuid == swap_uuid; });
+        if (it == swaps_.end()) {
+            return;
+        }
+        it->finished = true;
+        orders_.erase(it->order_uuid);
+    }
+
+    std::string mock_mm2_server::fill_order(const std::string &uuid)
+    {
+        auto swap_uuid = start_swap(uuid);
+        finish_swap(swap_uuid);
+        return swap_uuid;
+    }
+
+    nlohmann::json mock_mm2_server::make_my_orders() const
+    {
+        nlohmann::json maker_orders = nlohmann::json::object();
+        nlohmann::json taker_orders = nlohmann::json::object();
+        for (auto &&[uuid, o] : orders_) {
+            if (o.maker) {
+                maker_orders[uuid] = {{"base",             o.base},
+                                      {"rel",              o.rel},
+                                      {"price",            o.price},
+                                      {"max_base_vol",     o.volume},
+                                      {"min_base_vol",     "0"},
+                                      {"available_amount", o.started_swaps.empty() ? o.volume : "0"},
+                                      {"cancellable",      o.started_swaps.empty()},
+                                      {"created_at",       now_ms()},
+                                      {"matches",          nlohmann::json::object()},
+                                      {"started_swaps",    o.started_swaps},
+                                      {"uuid",             uuid}};
+            } else {
+                taker_orders[uuid] = {{"created_at",  now_ms()},
+                                      {"cancellable", o.started_swaps.empty()},
+                                      {"matches",     nlohmann::json::object()},
+                                      {"request",     {{"action",      "Buy"},
+                                                       {"base",        o.base},
+                                                       {"rel",         o.rel},
+                                                       {"base_amount", o.volume},
+                                                       {"rel_amount",  multiply_amounts(o.volume, o.price)},
+                                                       {"uuid",        uuid}}}};
+            }
+        }
+        return {{"result", {{"maker_orders", maker_orders}, {"taker_orders", taker_orders}}}};
+    }
+
+    nlohmann::json mock_mm2_server::make_swap(const swap &s) const
+    {
+        //! a maker sells base for rel, a taker (buy) sells rel for base.
+        const auto &o = s.order;
+        const auto counter_amount = multiply_amounts(o.volume, o.price);
+        auto events = nlohmann::json::array();
+        events.push_back({{"timestamp", s.started_at}, {"event", {{"type", "Started"}, {"data", nlohmann::json::object()}}}});
+        if (s.finished) {
+            events.push_back({{"timestamp", s.started_at}, {"event", {{"type", "Finished"}}}});
+        }
+        return {{"uuid",           s.uuid},
+                {"my_order_uuid",  s.order_uuid},
+                {"type",           o.maker ? "Maker" : "Taker"},
+                {"my_info",        {{"my_coin",      o.maker ? o.base : o.rel},
+                                    {"other_coin",   o.maker ? o.rel : o.base},
+                                    {"my_amount",    o.maker ? o.volume : counter_amount},
+                                    {"other_amount", o.maker ? counter_amount : o.volume},
+                                    {"started_at",   s.started_at / 1000}}},
+                {"events",         events},
+                {"success_events", {"Started", "Finished"}},
+                {"error_events",   {"StartFailed", "NegotiateFailed", "MakerPaymentRefunded"}}};
+    }
+
+    mock_mm2_reply mock_mm2_server::handle(const nlohmann::json &request)
+    {
+        nb_requests_.fetch_add(1, std::memory_order_relaxed);
+        std::scoped_lock lock(mutex_);
+        if (!request.is_array()) {
+            return handle_call(request);
+        }
+        //! a batch always succeeds, the failed calls answer an error object at their position.
+        auto answers = nlohmann::json::array();
+        for (auto &&call : request) {
+            answers.push_back(handle_call(call).body);
+        }
+        return {200, answers};
+    }
+
+    mock_mm2_reply mock_mm2_server::handle_call(const nlohmann::json &request)
+    {
+        const auto method = request.value("method", std::string{});
+        if (options_.error_rate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < options_.error_rate) {
+            return {500, error_answer("mock mm2: injected error on " + method)};
+        }
+        if (method == "electrum" || method == "enable") {
+            return {200, {{"address", "RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd"},
+                          {"balance", "7.77"},
+                          {"coin",    request.value("coin", std::string{})},
+                          {"result",  "success"}}};
+        }
+        if (method == "orderbook") {
+            const auto base = request.value("base", std::string{});
+            const auto rel = request.value("rel", std::string{});
+            auto canned = orderbooks_.find(base + "/" + rel);
+            return {200, canned != orderbooks_.end() ? canned->second : make_orderbook(base, rel)};
+        }
+        if (method == "my_balance") {
+            return {200, {{"address",         "RDbAXLCmQ2EN7daEZZp7CC9xzkcN8DfAZd"},
+                          {"balance",         "7.77"},
+                          {"locked_by_swaps", "0"},
+                          {"coin",            request.value("coin", std::string{})}}};
+        }
+        if (method == "version") {
+            return {200, {{"result", "mock_mm2"}}};
+        }
+        if (method == "setprice" || method == "buy") {
+            const auto base = request.value("base", std::string{});
+            const auto rel = request.value("rel", std::string{});
+            const auto price = request.value("price", std::string{"0"});
+            const auto volume = request.value("volume", std::string{"0"});
+            if (method == "setprice" && request.value("cancel_previous", true)) {
+                for (auto it = orders_.begin(); it != orders_.end();) {
+                    it = it->second.base == base && it->second.rel == rel ? orders_.erase(it) : std::next(it);
+                }
+            }
+            const auto uuid = next_uuid();
+            orders_.emplace(uuid, live_order{base, rel, price, volume, method == "setprice", {}});
+            if (method == "buy") {
+                return {200, {{"result", {{"action",        "Buy"},
+                                          {"base",          base},
+                                          {"rel",           rel},
+                                          {"base_amount",   volume},
+                                          {"rel_amount",    volume},
+                                          {"method",        "request"},
+                                          {"dest_pub_key",  "0000000000000000000000000000000000000000000000000000000000000000"},
+                                          {"sender_pubkey", "02b3f4e6a7b8c9d0e1f2a3b4c5d6e7f8a9b0c1d2e3f4a5b6c7d8e9f0a1b2c3d4e5"},
+                                          {"uuid",          uuid}}}}};
+            }
+            return {200, {{"result", {{"base",          base},
+                                      {"rel",           rel},
+                                      {"price",         price},
+                                      {"max_base_vol",  volume},
+                                      {"min_base_vol",  "0"},
+                                      {"created_at",    std::chrono::duration_cast<std::chrono::seconds>(
+                                              std::chrono::system_clock::now().time_since_epoch()).count()},
+                                      {"matches",       nlohmann::json::object()},
+                                      {"started_swaps", nlohmann::json::array()},
+                                      {"uuid",          uuid}}}}};
+        }
+        if (method == "cancel_order") {
+            const auto uuid = request.value("uuid", std::string{});
+            auto it = orders_.find(uuid);
+            if (it == orders_.end()) {
+                return {500, error_answer("Order with uuid " + uuid + " is not found")};
+            }
+            if (!it->second.started_swaps.empty()) {
+                return {500, error_answer("Order " + uuid + " is being matched now, can't cancel")};
+            }
+            orders_.erase(it);
+            return {200, {{"result", "success"}}};
+        }
+        if (method == "cancel_all_orders") {
+            const auto &cancel_by = request.at("cancel_by");
+            const bool by_pair = cancel_by.value("type", std::string{}) == "Pair";
+            std::vector<std::string> cancelled;
+            std::vector<std::string> currently_matching;
+            for (auto it = orders_.begin(); it != orders_.end();) {
+                if (by_pair && (it->second.base != cancel_by.at("data").value("base", std::string{}) ||
+                                it->second.rel != cancel_by.at("data").value("rel", std::string{}))) {
+                    ++it;
+                } else if (!it->second.started_swaps.empty()) {
+                    currently_matching.push_back(it->first);
+                    ++it;
+                } else {
+                    cancelled.push_back(it->first);
+                    it = orders_.erase(it);
+                }
+            }
+            return {200, {{"result", {{"cancelled", cancelled}, {"currently_matching", currently_matching}}}}};
+        }
+        if (method == "my_orders") {
+            return {200, make_my_orders()};
+        }
+        if (method == "my_recent_swaps") {
+            const auto limit = request.value("limit", std::size_t{10});
+            const auto from_uuid = request.value("from_uuid", std::string{});
+            auto swaps = nlohmann::json::array();
+            bool skipping = !from_uuid.empty();
+            std::size_t skipped = 0;
+            for (auto it = swaps_.rbegin(); it != swaps_.rend() && swaps.size() < limit; ++it) {
+                if (skipping) {
+                    skipping = it->uuid != from_uuid;
+                    ++skipped;
+                    continue;
+                }
+                swaps.push_back(make_swap(*it));
+            }
+            return {200, {{"result", {{"swaps",     swaps},
+                                      {"from_uuid", from_uuid.empty() ? nlohmann::json{} : nlohmann::json(from_uuid)},
+                                      {"limit",     limit},
+                                      {"skipped",   skipped},
+                                      {"total",     swaps_.size()}}}}};
+        }
+        return {500, error_answer("mock mm2: unknown method " + method)};
+    }
+}
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <restinio/all.hpp>
+
+namespace antara::mmbot
+{
+    struct mock_mm2_options
+    {
+        unsigned short port{7783};
+        std::size_t nb_threads{1};
+        //! every answer is delayed by latency plus a uniform jitter, without blocking the server threads.
+        std::chrono::microseconds latency{0};
+        std::chrono::microseconds latency_jitter{0};
+        //! probability (0..1) that a call fails with an mm2 error answer.
+        double error_rate{0.0};
+        //! levels on each side of the generated orderbooks.
+        std::size_t orderbook_depth{20};
+        double orderbook_mid{1.0};
+        std::uint64_t seed{42};
+    };
+
+    struct mock_mm2_reply
+    {
+        int status;
+        nlohmann::json body;
+    };
+
+    /**
+     * @brief mm2 compatible JSON-RPC stand-in: answers electrum/enable, orderbook, my_balance, version, setprice,
+     *        buy, cancel_order, cancel_all_orders, my_orders and my_recent_swaps with the shapes mm2_client decodes,
+     *        and batches of them. It keeps the placed orders and their swaps so cancels and fills behave.
+     *        Point mm2_client at it through the mm2_endpoint config key.
+     */
+    class mock_mm2_server
+    {
+    public:
+        explicit mock_mm2_server(mock_mm2_options options = {});
+
+        ~mock_mm2_server() noexcept;
+
+        mock_mm2_server(const mock_mm2_server &) = delete;
+
+        mock_mm2_server &operator=(const mock_mm2_server &) = delete;
+
+        //! bind the port and serve from the option's number of threads.
+        void start();
+
+        void stop() noexcept;
+
+        //! answer one call or a batch (an array of calls), what the server does for every request before the latency
+        //! is applied.
+        mock_mm2_reply handle(const nlohmann::json &request);
+
+        //! a maker swap starts on the order `uuid`: it can't be cancelled anymore until the swap finishes.
+        //! @return the uuid of the swap, empty if the order is unknown.
+        std::string start_swap(const std::string &uuid);
+
+        //! the swap finishes and the order it started on leaves the book fully filled.
+        void finish_swap(const std::string &swap_uuid);
+
+        //! start_swap then finish_swap, i.e. a taker matched the whole order.
+        std::string fill_order(const std::string &uuid);
+
+        //! serve `orderbook` as the answer to orderbook calls of base/rel instead of a generated book.
+        void set_orderbook(const std::string &base, const std::string &rel, nlohmann::json orderbook);
+
+        [[nodiscard]] std::string endpoint() const;
+
+        [[nodiscard]] std::size_t nb_requests() const noexcept;
+
+        [[nodiscard]] std::size_t nb_live_orders() const;
+
+    private:
+        using http_server = restinio::http_server_t<restinio::default_traits_t>;
+
+        struct live_order
+        {
+            std::string base;
+            std::string rel;
+            std::string price;
+            std::string volume;
+            bool maker;
+            std::vector<std::string> started_swaps;
+        };
+
+        struct swap
+        {
+            std::string uuid;
+            std::string order_uuid;
+            live_order order;
+            long long started_at;
+            bool finished;
+        };
+
+        restinio::request_handling_status_t on_request(restinio::request_handle_t req);
+
+        mock_mm2_reply handle_call(const nlohmann::json &request);
+
+        nlohmann::json make_my_orders() const;
+
+        nlohmann::json make_swap(const swap &s) const;
+
+        std::chrono::microseconds next_latency();
+
+        nlohmann::json make_orderbook(const std::string &base, const std::string &rel) const;
+
+        std::string next_uuid();
+
+        mock_mm2_options options_;
+        mutable std::mutex mutex_;
+        std::mt19937_64 rng_;
+        std::unordered_map<std::string, live_order> orders_;
+        std::unordered_map<std::string, nlohmann::json> orderbooks_;
+        //! oldest first, my_recent_swaps answers the newest first.
+        std::vector<swap> swaps_;
+        std::atomic_size_t nb_requests_{0};
+        std::unique_ptr<http_server> server_;
+        std::vector<std::thread> threads_;
+    };
+}
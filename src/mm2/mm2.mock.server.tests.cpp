@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+#include "config/config.hpp"
+#include "mm2/mm2.client.hpp"
+#include "mm2/mm2.mock.server.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("mock mm2 answers decode as mm2 answers")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        mock_mm2_options options;
+        options.orderbook_depth = 5;
+        mock_mm2_server server(options);
+
+        auto reply = server.handle({{"method", "version"}});
+        CHECK_EQ(200, reply.status);
+        mm2::version_answer version;
+        mm2::from_json(reply.body, version);
+        CHECK_EQ("mock_mm2", version.version);
+
+        reply = server.handle({{"method", "orderbook"}, {"base", "RICK"}, {"rel", "MORTY"}});
+        CHECK_EQ(200, reply.status);
+        mm2::orderbook_answer orderbook;
+        mm2::from_json(reply.body, orderbook);
+        CHECK_EQ(5, orderbook.asks.size());
+        CHECK_EQ(5, orderbook.bids.size());
+        CHECK_EQ("RICK", orderbook.base.symbol.value());
+
+        nlohmann::json setprice_request;
+        mm2::to_json(setprice_request, mm2::setprice_request{{st_symbol{"RICK"}}, {st_symbol{"MORTY"}}, "1", "1"});
+        setprice_request["method"] = "setprice";
+        reply = server.handle(setprice_request);
+        CHECK_EQ(200, reply.status);
+        mm2::setprice_answer setprice;
+        mm2::from_json(reply.body, setprice);
+        CHECK_EQ(1, server.nb_live_orders());
+
+        nlohmann::json buy_request;
+        mm2::to_json(buy_request, mm2::buy_request{{st_symbol{"RICK"}}, {st_symbol{"MORTY"}}, "1", "1"});
+        buy_request["method"] = "buy";
+        reply = server.handle(buy_request);
+        mm2::buy_answer buy;
+        mm2::from_json(reply.body, buy);
+        REQUIRE(buy.result_buy.has_value());
+        CHECK_EQ(2, server.nb_live_orders());
+
+        nlohmann::json cancel_request;
+        mm2::to_json(cancel_request, mm2::cancel_order_request{setprice.result_setprice.uuid});
+        cancel_request["method"] = "cancel_order";
+        CHECK_EQ(200, server.handle(cancel_request).status);
+        CHECK_EQ(500, server.handle(cancel_request).status);
+
+        nlohmann::json cancel_all_request;
+        mm2::to_json(cancel_all_request, mm2::cancel_all_orders_request{"Pair", mm2::cancel_all_orders_data{
+                {st_symbol{"RICK"}}, {st_symbol{"MORTY"}}}});
+        cancel_all_request["method"] = "cancel_all_orders";
+        reply = server.handle(cancel_all_request);
+        mm2::cancel_all_orders_answer cancel_all;
+        mm2::from_json(reply.body, cancel_all);
+        CHECK_EQ(std::vector<std::string>{buy.result_buy.value().uuid}, cancel_all.cancelled);
+        CHECK_EQ(0, server.nb_live_orders());
+        CHECK_EQ(500, server.handle({{"method", "unknown"}}).status);
+        CHECK_EQ(8, server.nb_requests());
+    }
+
+    TEST_CASE ("mock mm2 answers batches, my_orders and my_recent_swaps")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        mock_mm2_server server;
+        auto batch = nlohmann::json::array();
+        for (auto &&price : {"1", "2"}) {
+            nlohmann::json setprice_request;
+            mm2::to_json(setprice_request, mm2::setprice_request{{st_symbol{"RICK"}}, {st_symbol{"MORTY"}}, price, "3",
+                                                                 std::nullopt, false});
+            setprice_request["method"] = "setprice";
+            batch.push_back(setprice_request);
+        }
+        batch.push_back({{"method", "unknown"}});
+        auto reply = server.handle(batch);
+        CHECK_EQ(200, reply.status);
+        REQUIRE_EQ(3, reply.body.size());
+        CHECK(reply.body[2].contains("error"));
+        CHECK_EQ(1, server.nb_requests());
+        mm2::setprice_answer first;
+        mm2::from_json(reply.body[0], first);
+        mm2::setprice_answer second;
+        mm2::from_json(reply.body[1], second);
+
+        mm2::my_orders_answer my_orders;
+        mm2::from_json(server.handle({{"method", "my_orders"}}).body, my_orders);
+        CHECK_EQ(2, my_orders.maker_orders.size());
+        CHECK(my_orders.taker_orders.empty());
+
+        auto matching_swap = server.start_swap(first.result_setprice.uuid);
+        auto finished_swap = server.fill_order(second.result_setprice.uuid);
+        CHECK(server.start_swap("unknown").empty());
+        mm2::my_recent_swaps_answer swaps;
+        mm2::from_json(server.handle({{"method", "my_recent_swaps"}, {"limit", 10}}).body, swaps);
+        REQUIRE_EQ(2, swaps.swaps.size());
+        CHECK_EQ(finished_swap, swaps.swaps[0].uuid);
+        CHECK_EQ(second.result_setprice.uuid, swaps.swaps[0].my_order_uuid);
+        CHECK(swaps.swaps[0].finished);
+        CHECK_EQ("Maker", swaps.swaps[0].type);
+        CHECK_EQ("RICK", swaps.swaps[0].my_coin.symbol.value());
+        CHECK_EQ("6.00000000", swaps.swaps[0].other_amount);
+        CHECK_FALSE(swaps.swaps[1].finished);
+        mm2::my_recent_swaps_answer older;
+        mm2::from_json(server.handle({{"method", "my_recent_swaps"}, {"limit", 10}, {"from_uuid", finished_swap}}).body,
+                       older);
+        REQUIRE_EQ(1, older.swaps.size());
+        CHECK_EQ(matching_swap, older.swaps[0].uuid);
+
+        nlohmann::json cancel_request;
+        mm2::to_json(cancel_request, mm2::cancel_order_request{first.result_setprice.uuid});
+        cancel_request["method"] = "cancel_order";
+        CHECK_EQ(500, server.handle(cancel_request).status);
+        reply = server.handle({{"method", "cancel_all_orders"}, {"cancel_by", {{"type", "All"}}}});
+        mm2::cancel_all_orders_answer cancel_all;
+        mm2::from_json(reply.body, cancel_all);
+        CHECK(cancel_all.cancelled.empty());
+        CHECK_EQ(std::vector<std::string>{first.result_setprice.uuid}, cancel_all.currently_matching);
+    }
+
+    TEST_CASE ("mock mm2 injects errors")
+    {
+        mock_mm2_options options;
+        options.error_rate = 1.0;
+        mock_mm2_server server(options);
+        auto reply = server.handle({{"method", "version"}});
+        CHECK_EQ(500, reply.status);
+        CHECK(reply.body.contains("error"));
+    }
+
+    TEST_CASE ("mm2 client against the mock mm2 server")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        mock_mm2_options options;
+        options.port = 7790;
+        options.latency = std::chrono::milliseconds{5};
+        mock_mm2_server server(options);
+        server.start();
+        auto cfg = get_mmbot_config();
+        cfg.mm2_endpoint = server.endpoint();
+        set_mmbot_config(cfg);
+        {
+            mm2_client client;
+            auto version = client.rpc_version();
+            CHECK_EQ(200, version.rpc_result_code);
+            CHECK_EQ("mock_mm2", version.version);
+            auto orderbook = client.rpc_orderbook(mm2::orderbook_request{
+                    antara::pair{{st_symbol{"MORTY"}}, {st_symbol{"RICK"}}}});
+            CHECK_EQ(200, orderbook.rpc_result_code);
+            CHECK_EQ(options.orderbook_depth, orderbook.asks.size());
+        }
+        server.stop();
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+}
@@ -0,0 +1,209 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fstream>
+#include <loguru.hpp>
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
+#include "utils/pretty_function.hpp"
+#include "mm2/mm2.swap.feed.hpp"
+
+namespace
+{
+    bool is_done(const antara::mmbot::mm2::swap_contents &swap) noexcept
+    {
+        return swap.finished || swap.failed;
+    }
+}
+
+namespace antara::mmbot
+{
+    void to_json(nlohmann::json &j, const mm2_swap_cursor &cursor)
+    {
+        j["watermark"] = cursor.watermark;
+        j["published"] = cursor.published;
+    }
+
+    void from_json(const nlohmann::json &j, mm2_swap_cursor &cursor)
+    {
+        j.at("watermark").get_to(cursor.watermark);
+        cursor.published = j.at("published").get<std::unordered_set<std::string>>();
+    }
+
+    mm2_swap_feed::mm2_swap_feed(mm2_client &client, mm2_swap_feed_options options) :
+            client_(client), options_(std::move(options))
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        if (!options_.cursor_path.has_value() || !std::filesystem::exists(options_.cursor_path.value())) {
+            return;
+        }
+        try {
+            std::ifstream ifs(options_.cursor_path.value());
+            cursor_ = nlohmann::json::parse(ifs).get<mm2_swap_cursor>();
+            has_cursor_ = true;
+            DVLOG_F(loguru::Verbosity_INFO, "resuming the swaps after %s", cursor_.watermark.c_str());
+        }
+        catch (const std::exception &error) {
+            VLOG_F(loguru::Verbosity_ERROR, "invalid swap cursor %s: %s",
+                   options_.cursor_path.value().string().c_str(), error.what());
+        }
+    }
+
+    mm2_swap_feed::~mm2_swap_feed() noexcept
+    {
+        stop();
+    }
+
+    void mm2_swap_feed::add_listener(swap_listener listener)
+    {
+        listeners_.push_back(std::move(listener));
+    }
+
+    void mm2_swap_feed::start()
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    void mm2_swap_feed::stop() noexcept
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void mm2_swap_feed::run()
+    {
+        loguru::set_thread_name("mm2 swap feed");
+        std::unique_lock lock(mutex_);
+        while (!cv_.wait_for(lock, options_.poll_interval, [this]() { return stopped_; })) {
+            lock.unlock();
+            poll();
+            lock.lock();
+        }
+    }
+
+    std::size_t mm2_swap_feed::poll()
+    {
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = metrics::get_histogram("mmbot_mm2_swap_feed_poll_latency_us");
+        static auto &published = metrics::get_counter("mmbot_mm2_swap_feed_published_total");
+        metrics::scoped_timer timer(latency);
+        auto swaps = read_since_watermark();
+        if (!swaps.has_value()) {
+            return 0;
+        }
+        const bool skip_history = !has_cursor_;
+        has_cursor_ = true;
+        bool changed = skip_history;
+        std::size_t nb_published = 0;
+        for (auto it = swaps->rbegin(); it != swaps->rend(); ++it) {
+            if (!is_done(*it)) {
+                if (running_.insert(it->uuid).second) {
+                    publish(*it);
+                }
+                continue;
+            }
+            running_.erase(it->uuid);
+            if (!cursor_.published.insert(it->uuid).second) {
+                continue;
+            }
+            changed = true;
+            if (skip_history) {
+                continue;
+            }
+            publish(*it);
+            ++nb_published;
+        }
+        //! the watermark moves over the oldest swaps as long as they are done.
+        for (auto it = swaps->rbegin(); it != swaps->rend() && is_done(*it); ++it) {
+            cursor_.published.erase(it->uuid);
+            cursor_.watermark = it->uuid;
+            changed = true;
+        }
+        if (changed) {
+            save_cursor();
+        }
+        published.inc(nb_published);
+        return nb_published;
+    }
+
+    void mm2_swap_feed::publish(const mm2::swap_contents &swap)
+    {
+        for (auto &&listener : listeners_) {
+            listener(swap);
+        }
+    }
+
+    std::optional<std::vector<mm2::swap_contents>> mm2_swap_feed::read_since_watermark()
+    {
+        std::vector<mm2::swap_contents> swaps;
+        auto page = client_.rpc_my_recent_swaps(mm2::my_recent_swaps_request{options_.page_size});
+        for (std::size_t nb_pages = 1;; ++nb_pages) {
+            if (page.rpc_result_code != 200) {
+                VLOG_F(loguru::Verbosity_WARNING, "mm2 my_recent_swaps failed: %s", page.result.c_str());
+                return std::nullopt;
+            }
+            for (auto &&swap : page.swaps) {
+                if (swap.uuid == cursor_.watermark) {
+                    return swaps;
+                }
+                swaps.push_back(std::move(swap));
+            }
+            if (page.swaps.size() < options_.page_size) {
+                return swaps;
+            }
+            if (nb_pages == options_.max_pages) {
+                if (!cursor_.watermark.empty()) {
+                    VLOG_F(loguru::Verbosity_WARNING, "%zu swaps read without reaching %s, the older are skipped",
+                           swaps.size(), cursor_.watermark.c_str());
+                }
+                return swaps;
+            }
+            page = client_.rpc_my_recent_swaps(mm2::my_recent_swaps_request{options_.page_size, swaps.back().uuid});
+        }
+    }
+
+    void mm2_swap_feed::save_cursor() const
+    {
+        if (!options_.cursor_path.has_value()) {
+            return;
+        }
+        //! written aside then renamed, a crash never leaves half a cursor.
+        const auto &path = options_.cursor_path.value();
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream ofs(tmp_path, std::ios::trunc);
+            ofs << nlohmann::json(cursor_).dump();
+            if (!ofs) {
+                VLOG_F(loguru::Verbosity_ERROR, "can't write the swap cursor %s", tmp_path.string().c_str());
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            VLOG_F(loguru::Verbosity_ERROR, "can't save the swap cursor %s: %s", path.string().c_str(),
+                   ec.message().c_str());
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "mm2/mm2.client.hpp"
+
+namespace antara::mmbot
+{
+    struct mm2_swap_feed_options
+    {
+        std::chrono::milliseconds poll_interval{100};
+        //! my_recent_swaps page size, and the number of pages read at most by a poll.
+        std::size_t page_size{50};
+        std::size_t max_pages{10};
+        //! where the cursor is saved after every change, a restart resumes from it instead of skipping the history.
+        std::optional<std::filesystem::path> cursor_path{std::nullopt};
+    };
+
+    //! where the feed is in the swaps of mm2: every swap up to the watermark is finished (or failed) and was
+    //! published, `published` are the finished swaps started after it.
+    struct mm2_swap_cursor
+    {
+        std::string watermark;
+        std::unordered_set<std::string> published;
+    };
+
+    void to_json(nlohmann::json &j, const mm2_swap_cursor &cursor);
+
+    void from_json(const nlohmann::json &j, mm2_swap_cursor &cursor);
+
+    /**
+     * @brief Tails my_recent_swaps on its own thread and publishes each swap when it is first seen running, then
+     *        once when it finishes or fails. A poll only reads the swaps started after the watermark, so its cost
+     *        follows the running swaps and not the history. Without a saved cursor the swaps finished before the
+     *        first poll are not published.
+     */
+    class mm2_swap_feed
+    {
+    public:
+        using swap_listener = std::function<void(const mm2::swap_contents &swap)>;
+
+        explicit mm2_swap_feed(mm2_client &client, mm2_swap_feed_options options = {});
+
+        ~mm2_swap_feed() noexcept;
+
+        mm2_swap_feed(const mm2_swap_feed &) = delete;
+
+        mm2_swap_feed &operator=(const mm2_swap_feed &) = delete;
+
+        //! must be added before start, called from the feed thread.
+        void add_listener(swap_listener listener);
+
+        //! poll every poll_interval on the feed thread.
+        void start();
+
+        void stop() noexcept;
+
+        //! one poll on the calling thread, for the callers driving the feed themselves instead of starting it.
+        //! @return the number of finished or failed swaps published.
+        std::size_t poll();
+
+        [[nodiscard]] const mm2_swap_cursor &get_cursor() const noexcept
+        {
+            return cursor_;
+        }
+
+    private:
+        //! the swaps started after the watermark, the newest first.
+        std::optional<std::vector<mm2::swap_contents>> read_since_watermark();
+
+        void publish(const mm2::swap_contents &swap);
+
+        void save_cursor() const;
+
+        void run();
+
+        mm2_client &client_;
+        mm2_swap_feed_options options_;
+        std::vector<swap_listener> listeners_;
+        mm2_swap_cursor cursor_;
+        bool has_cursor_{false};
+        //! published as running, not persisted: they are published again after a restart.
+        std::unordered_set<std::string> running_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopped_{false};
+        std::thread thread_;
+    };
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+#include "config/config.hpp"
+#include "mm2/mm2.mock.server.hpp"
+#include "mm2/mm2.swap.feed.hpp"
+
+namespace antara::mmbot::tests
+{
+    namespace
+    {
+        std::string place_ask(mm2_client &client)
+        {
+            return client.rpc_setprice(mm2::setprice_request{{st_symbol{"RICK"}}, {st_symbol{"MORTY"}}, "1", "1",
+                                                             std::nullopt, false}).result_setprice.uuid;
+        }
+    }
+
+    TEST_CASE ("mm2 swap feed publishes a swap when it starts and once when it finishes")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        mock_mm2_options options;
+        options.port = 7795;
+        mock_mm2_server server(options);
+        server.start();
+        auto cfg = get_mmbot_config();
+        cfg.mm2_endpoint = server.endpoint();
+        set_mmbot_config(cfg);
+        {
+            mm2_client client(false);
+            mm2_swap_feed feed(client);
+            std::vector<mm2::swap_contents> published;
+            feed.add_listener([&published](const mm2::swap_contents &swap) { published.push_back(swap); });
+
+            auto history = server.fill_order(place_ask(client));
+            CHECK_EQ(0, feed.poll());
+            CHECK(published.empty());
+            CHECK_EQ(history, feed.get_cursor().watermark);
+
+            auto swap = server.start_swap(place_ask(client));
+            CHECK_EQ(0, feed.poll());
+            REQUIRE_EQ(1, published.size());
+            CHECK_FALSE(published[0].finished);
+            CHECK_EQ(0, feed.poll());
+            CHECK_EQ(1, published.size());
+
+            auto later = server.fill_order(place_ask(client));
+            CHECK_EQ(1, feed.poll());
+            REQUIRE_EQ(2, published.size());
+            CHECK_EQ(later, published[1].uuid);
+            //! the running swap holds the watermark back.
+            CHECK_EQ(history, feed.get_cursor().watermark);
+            CHECK_EQ(1, feed.get_cursor().published.count(later));
+
+            server.finish_swap(swap);
+            CHECK_EQ(1, feed.poll());
+            REQUIRE_EQ(3, published.size());
+            CHECK_EQ(swap, published[2].uuid);
+            CHECK(published[2].finished);
+            CHECK_EQ(later, feed.get_cursor().watermark);
+            CHECK(feed.get_cursor().published.empty());
+            CHECK_EQ(0, feed.poll());
+        }
+        server.stop();
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+
+    TEST_CASE ("mm2 swap feed resumes from its saved cursor")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        mock_mm2_options options;
+        options.port = 7796;
+        mock_mm2_server server(options);
+        server.start();
+        auto cfg = get_mmbot_config();
+        cfg.mm2_endpoint = server.endpoint();
+        set_mmbot_config(cfg);
+        const auto cursor_path = std::filesystem::temp_directory_path() / "mmbot.swap.feed.tests.cursor.json";
+        std::filesystem::remove(cursor_path);
+        {
+            mm2_client client(false);
+            mm2_swap_feed_options feed_options;
+            feed_options.cursor_path = cursor_path;
+            feed_options.page_size = 2;
+            {
+                mm2_swap_feed feed(client, feed_options);
+                server.fill_order(place_ask(client));
+                CHECK_EQ(0, feed.poll());
+            }
+            //! finished while the feed was down, more than a page.
+            std::vector<std::string> missed;
+            for (int idx = 0; idx < 3; ++idx) {
+                missed.push_back(server.fill_order(place_ask(client)));
+            }
+            mm2_swap_feed feed(client, feed_options);
+            std::vector<std::string> published;
+            feed.add_listener([&published](const mm2::swap_contents &swap) { published.push_back(swap.uuid); });
+            CHECK_EQ(3, feed.poll());
+            CHECK_EQ(missed, published);
+            CHECK_EQ(missed.back(), feed.get_cursor().watermark);
+        }
+        std::filesystem::remove(cursor_path);
+        server.stop();
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+}
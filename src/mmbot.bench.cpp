@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <loguru.hpp>
+#include <restclient-cpp/restclient.h>
+#include "config/config.hpp"
+#include "logging/async.file.sink.hpp"
+
+//! Benchmarks run with the same log sink as the bot so the logging cost of the hot paths is part of the numbers.
+//! Results are also written as json to mmbot.bench.json unless --benchmark_out is given, to compare releases.
+int main(int argc, char **argv)
+{
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+    antara::mmbot::logging::async_file_sink_options log_options;
+    log_options.truncate = true;
+    antara::mmbot::logging::async_file_sink log("logs/mmbot.bench.log", log_options);
+    log.install(loguru::Verbosity_MAX);
+    antara::mmbot::load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+
+    std::vector<char *> args(argv, argv + argc);
+    std::string out_arg = "--benchmark_out=mmbot.bench.json";
+    std::string out_format_arg = "--benchmark_out_format=json";
+    bool has_out = false;
+    for (int idx = 1; idx < argc; ++idx) {
+        has_out = has_out || std::string(argv[idx]).rfind("--benchmark_out=", 0) == 0;
+    }
+    if (!has_out) {
+        args.push_back(out_arg.data());
+        args.push_back(out_format_arg.data());
+    }
+    int nb_args = static_cast<int>(args.size());
+    benchmark::Initialize(&nb_args, args.data());
+    if (benchmark::ReportUnrecognizedArguments(nb_args, args.data())) {
+        return 1;
+    }
+    RestClient::init();
+    benchmark::RunSpecifiedBenchmarks();
+    RestClient::disable();
+    return 0;
+}
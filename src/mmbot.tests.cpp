@@ -14,5 +14,16 @@
  *                                                                            *
  ******************************************************************************/
 
-#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
-#include <doctest/doctest.h>
\ No newline at end of file
+#define DOCTEST_CONFIG_IMPLEMENT
+#include <doctest/doctest.h>
+#include <restclient-cpp/restclient.h>
+
+int main(int argc, char **argv)
+{
+    RestClient::init();
+    doctest::Context context;
+    context.applyCommandLine(argc, argv);
+    int res = context.run();
+    RestClient::disable();
+    return res;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "cex/cex.simulated.hpp"
+#include "dex/dex.simulated.hpp"
+#include "order_manager/order.manager.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot;
+
+    const antara::pair bench_pair{antara::asset{st_symbol{"RICK"}}, antara::asset{st_symbol{"MORTY"}}};
+
+    //! levels far enough from each other that nothing crosses, every order stays live.
+    orders::order_group make_group(std::size_t nb_levels)
+    {
+        orders::order_group group{bench_pair, {}};
+        group.levels.reserve(nb_levels);
+        for (std::size_t idx = 0; idx < nb_levels; ++idx) {
+            group.levels.push_back(orders::order_level{st_price{100000 + idx}, st_quantity{1.0}, antara::side::sell});
+        }
+        return group;
+    }
+
+    void BM_order_manager_place_order_group(benchmark::State &state)
+    {
+        const auto group = make_group(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            state.PauseTiming();
+            simulation::matching_engine engine;
+            simulated_dex dex(engine);
+            simulated_cex cex;
+            order_manager om(dex, cex);
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(om.place_order(group));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_order_manager_poll(benchmark::State &state)
+    {
+        simulation::matching_engine engine;
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex);
+        om.place_order(make_group(static_cast<std::size_t>(state.range(0))));
+        for (auto _ : state) {
+            om.poll();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_order_manager_cancel_orders(benchmark::State &state)
+    {
+        const auto group = make_group(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            state.PauseTiming();
+            simulation::matching_engine engine;
+            simulated_dex dex(engine);
+            simulated_cex cex;
+            order_manager om(dex, cex);
+            om.place_order(group);
+            state.ResumeTiming();
+            benchmark::DoNotOptimize(om.cancel_orders(bench_pair));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+BENCHMARK(BM_order_manager_place_order_group)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_order_manager_poll)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_order_manager_cancel_orders)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
@@ -16,9 +16,11 @@
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
 #include <loguru.hpp>
 #include <unordered_set>
 
+#include "metrics/metrics.hpp"
 #include "order.manager.hpp"
 
 namespace antara::mmbot
@@ -36,9 +38,31 @@ namespace antara::mmbot
         ids.emplace(id);
     }
 
+    orders::orders_by_id::iterator order_manager::archive_order(orders::orders_by_id::iterator it)
+    {
+        auto &o = it->second;
+        {
+            std::scoped_lock lock(executions_mutex_);
+            for (auto &&current_id : o.execution_ids) {
+                executions_.erase(current_id);
+            }
+        }
+        if (auto pair_it = orders_by_pair_.find(o.pair); pair_it != orders_by_pair_.end()) {
+            pair_it->second.erase(o.id);
+        }
+        archive_.push(std::move(o));
+        return orders_.erase(it);
+    }
+
     const orders::order &order_manager::get_order(const st_order_id &id) const
     {
-        return orders_.at(id);
+        if (auto it = orders_.find(id); it != orders_.end()) {
+            return it->second;
+        }
+        if (auto archived = archive_.find(id); archived != nullptr) {
+            return *archived;
+        }
+        throw std::out_of_range("unknown order: " + id);
     }
 
     void order_manager::add_orders(const std::vector<orders::order> &orders)
@@ -51,7 +75,9 @@ namespace antara::mmbot
 
     void order_manager::add_executions(const std::vector<orders::execution> &executions)
     {
+        std::scoped_lock lock(executions_mutex_);
         for (const auto &e : executions) {
+            remember_execution(e.id);
             executions_.emplace(e.id, e);
         }
     }
@@ -68,68 +94,84 @@ namespace antara::mmbot
         }
 
         auto exs = dex_.get_executions(order_ids);
+        std::scoped_lock lock(executions_mutex_);
         for (const auto &ex : exs) {
+            remember_execution(ex.id);
             executions_.emplace(ex.id, ex);
         }
     }
 
     void order_manager::poll()
     {
+        static auto &latency = metrics::get_histogram("mmbot_order_manager_poll_latency_us");
+        metrics::scoped_timer timer(latency);
         // update the orders we know about
-        for (const auto&[id, o] : orders_) {
-            auto order = dex_.get_order_status(st_order_id{id});
-            orders_.emplace(id, order);
+        for (auto &&[id, o] : orders_) {
+            auto latest = dex_.get_order_status(st_order_id{id});
+            o.filled = latest.filled;
+            o.execution_ids.insert(latest.execution_ids.begin(), latest.execution_ids.end());
+            if (!o.change_status(orders::order_status_change{id, latest.status})) {
+                VLOG_F(loguru::Verbosity_WARNING, "order %s: ignoring the transition from %s to %s", id.c_str(),
+                       orders::to_string(o.status), orders::to_string(latest.status));
+            }
         }
 
         // add new orders
         update_from_live();
 
-        // get all their executions
-        auto order_ids = std::unordered_set<st_order_id>();
-        for (const auto&[id, o] : orders_) {
-            order_ids.emplace(id);
+        // only the executions since the last poll, the ones pushed by the dex are already mirrored
+        for (const auto &ex : dex_.get_recent_executions()) {
+            record_execution(ex);
         }
 
-        auto live_executions = dex_.get_executions(order_ids);
-        auto recent_executions = dex_.get_recent_executions();
-        auto all_executions = std::unordered_map<st_execution_id, orders::execution>();
-
-        for (const auto &e : live_executions) {
-            all_executions.emplace(e.id, e);
+        // when an order is finished, remove it's executions and archive it
+        for (auto it = orders_.begin(); it != orders_.end();) {
+            it = it->second.finished() ? archive_order(it) : std::next(it);
         }
+    }
 
-        for (const auto &e : recent_executions) {
-            all_executions.emplace(e.id, e);
-        }
+    void order_manager::on_execution(const orders::execution &ex)
+    {
+        record_execution(ex);
+    }
 
-        for (const auto& [id, ex] : all_executions) {
-            if (executions_.find(id) == executions_.end()) {
-                // can't find the exection, it's new
-                // for any that aren't in the ex object
-                // make a call to cex
-                cex_.mirror(ex);
+    void order_manager::record_execution(const orders::execution &ex)
+    {
+        {
+            std::scoped_lock lock(executions_mutex_);
+            if (!remember_execution(ex.id)) {
+                return;
             }
+            executions_.emplace(ex.id, ex);
         }
+        //! the id is claimed, the hedge goes to the cex without holding up the swap feed and poll.
+        cex_.mirror(ex);
+    }
 
-        // when an order is finished, remove it's executions
-        for (auto&&[id, order] : orders_) {
-            if (order.finished()) {
-                auto ex_ids = order.execution_ids;
-                for (auto &&current_id : ex_ids) {
-                    executions_.erase(current_id);
-                }
-                orders_.erase(order.id);
-            }
+    bool order_manager::remember_execution(const st_execution_id &id)
+    {
+        if (!known_executions_.insert(id).second) {
+            return false;
+        }
+        known_executions_order_.push_back(id);
+        if (known_executions_order_.size() > known_executions_capacity) {
+            known_executions_.erase(known_executions_order_.front());
+            known_executions_order_.pop_front();
         }
+        return true;
     }
 
     void order_manager::update_from_live()
     {
         auto live = dex_.get_live_orders();
-        std::transform(live.begin(), live.end(), std::inserter(orders_, orders_.end()),
-                       [](const auto &o) {
-                           return std::make_pair(o.id, o);
-                       });
+        for (auto &&o : live) {
+            //! an order cancelled by us can still be on the book for a moment, it stays archived.
+            if (orders_.count(o.id) > 0 || archive_.find(o.id) != nullptr) {
+                continue;
+            }
+            add_order_to_pair_map(o);
+            orders_.emplace(o.id, std::move(o));
+        }
     }
 
     st_order_id order_manager::place_order(const orders::order_level &ol)
@@ -146,35 +188,50 @@ namespace antara::mmbot
     std::unordered_set<st_order_id> order_manager::place_order(const orders::order_group &os)
     {
         auto order_ids = std::unordered_set<st_order_id>();
-        for (const auto &ol : os.levels) {
-            auto &order = dex_.place(ol);
+        for (auto &&order : dex_.place(os.pair, os.levels)) {
             order_ids.emplace(order.id);
+            add_order_to_pair_map(order);
+            auto id = order.id;
+            orders_.emplace(std::move(id), std::move(order));
         }
 
         return order_ids;
     }
 
-    std::unordered_set<st_order_id> order_manager::cancel_orders(antara::pair pair)
+    std::unordered_set<st_order_id> order_manager::reconcile(cancel_result &&result)
     {
-        auto ids = orders_by_pair_.at(pair);
-        std::unordered_set<st_order_id> cancelled_orders;
-        for (const auto &id : ids) {
-            auto result = dex_.cancel(id);
-            if (result) {
-                cancelled_orders.emplace(id);
+        if (!result.currently_matching.empty()) {
+            VLOG_F(loguru::Verbosity_INFO, "%zu order(s) are matching and can't be cancelled",
+                   result.currently_matching.size());
+        }
+        for (auto &&id : result.cancelled) {
+            auto it = orders_.find(id);
+            if (it == orders_.end()) {
+                continue;
             }
+            if (!it->second.change_status(orders::order_status_change{id, orders::order_status::cancelled})) {
+                VLOG_F(loguru::Verbosity_WARNING, "order %s: cancelled while %s", id.c_str(),
+                       orders::to_string(it->second.status));
+            }
+            archive_order(it);
         }
+        return std::move(result.cancelled);
+    }
 
-        for (const auto &id : cancelled_orders) {
-            ids.erase(id);
-            auto &order = orders_.at(id);
-            auto ex_ids = order.execution_ids;
-            for (auto &&current_id : ex_ids) {
-                executions_.erase(current_id);
-            }
-            orders_.erase(order.id);
+    std::unordered_set<st_order_id> order_manager::cancel_orders(antara::pair pair)
+    {
+        auto pair_it = orders_by_pair_.find(pair);
+        if (pair_it == orders_by_pair_.end() || pair_it->second.empty()) {
+            return {};
         }
+        return reconcile(dex_.cancel_all(pair));
+    }
 
-        return cancelled_orders;
+    std::unordered_set<st_order_id> order_manager::cancel_orders(const std::unordered_set<st_order_id> &ids)
+    {
+        if (ids.empty()) {
+            return {};
+        }
+        return reconcile(dex_.cancel_all(ids));
     }
 }
@@ -16,13 +16,17 @@
 
 #pragma once
 
+#include <deque>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <loguru.hpp>
 
 #include <utils/pretty_function.hpp>
 #include "utils/mmbot_strong_types.hpp"
 #include "orders/orders.hpp"
+#include "orders/order.archive.hpp"
 #include "dex/dex.hpp"
 #include "cex/cex.hpp"
 
@@ -44,18 +48,25 @@ namespace antara::mmbot
 
         virtual void update_from_live() = 0;
 
+        //! an execution pushed by the dex as it happens, instead of waiting for the next poll.
+        virtual void on_execution(const orders::execution &ex) = 0;
+
         virtual st_order_id place_order(const orders::order_level &ol) = 0;
         virtual std::unordered_set<st_order_id> place_order(const orders::order_group &os) = 0;
 
         virtual std::unordered_set<st_order_id> cancel_orders(antara::pair pair) = 0;
+        virtual std::unordered_set<st_order_id> cancel_orders(const std::unordered_set<st_order_id> &ids) = 0;
     };
 
     class order_manager : public abstract_om
     {
     public:
-        order_manager(abstract_dex& dex, abstract_cex& cex) : dex_(dex), cex_(cex)
+        //! the last `archive_capacity` finished orders are kept in the archive, the older ones are forgotten.
+        order_manager(abstract_dex& dex, abstract_cex& cex, std::size_t archive_capacity = 1024) :
+                dex_(dex), cex_(cex), archive_(archive_capacity)
         {}
 
+        //! the archived orders are found too.
         [[nodiscard]] const orders::order &get_order(const st_order_id &id) const override;
         [[nodiscard]] const orders::orders_by_id &get_all_orders() const override
         {
@@ -70,20 +81,51 @@ namespace antara::mmbot
 
         void update_from_live() override;
 
+        //! thread safe: mirrored on the cex right away, at most once per execution whoever finds it first.
+        void on_execution(const orders::execution &ex) override;
+
         st_order_id place_order(const orders::order_level &ol) override;
         std::unordered_set<st_order_id> place_order(const orders::order_group &os) override;
 
+        //! a single bulk cancel on the dex, returns the cancelled orders.
         std::unordered_set<st_order_id> cancel_orders(antara::pair pair) override;
+        std::unordered_set<st_order_id> cancel_orders(const std::unordered_set<st_order_id> &ids) override;
+
+        [[nodiscard]] const orders::order_archive &get_archive() const noexcept
+        {
+            return archive_;
+        }
 
     private:
         abstract_dex& dex_;
         abstract_cex& cex_;
 
         orders::orders_by_id orders_;
+        //! guards executions_ and the mirroring, shared with the dex threads pushing executions.
+        std::mutex executions_mutex_;
         orders::executions_by_id executions_;
+        //! the ids of the executions mirrored or already known, they outlive the archiving of their order: a push
+        //! delayed past it must not mirror the execution again. Bounded, the oldest are forgotten first.
+        static constexpr std::size_t known_executions_capacity = 16384;
+        std::unordered_set<st_execution_id> known_executions_;
+        std::deque<st_execution_id> known_executions_order_;
 
         std::unordered_map<antara::pair, std::unordered_set<st_order_id>> orders_by_pair_;
 
+        orders::order_archive archive_;
+
         void add_order_to_pair_map(const orders::order &o);
+
+        //! archive the cancelled orders, the currently matching ones stay until poll sees them filled.
+        std::unordered_set<st_order_id> reconcile(cancel_result &&result);
+
+        //! mirror `ex` unless it is already known.
+        void record_execution(const orders::execution &ex);
+
+        //! with executions_mutex_ held, false if `id` was already known.
+        bool remember_execution(const st_execution_id &id);
+
+        //! remove the executions of `it` and move it to the archive, returns the next order.
+        orders::orders_by_id::iterator archive_order(orders::orders_by_id::iterator it);
     };
 }
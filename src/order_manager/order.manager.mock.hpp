@@ -39,10 +39,12 @@ namespace antara::mmbot
         MAKE_MOCK0(poll, void(), override);
 
         MAKE_MOCK0(update_from_live, void(), override);
+        MAKE_MOCK1(on_execution, void(const orders::execution&), override);
 
         MAKE_MOCK1(place_order, st_order_id(const orders::order_level&), override);
         MAKE_MOCK1(place_order, std::unordered_set<st_order_id>(const orders::order_group&), override);
 
         MAKE_MOCK1(cancel_orders, std::unordered_set<st_order_id>(antara::pair pair), override);
+        MAKE_MOCK1(cancel_orders, std::unordered_set<st_order_id>(const std::unordered_set<st_order_id>&), override);
     };
 }
@@ -21,6 +21,8 @@
 #include <utils/mmbot_strong_types.hpp>
 #include <dex/dex.mock.hpp>
 #include <cex/cex.mock.hpp>
+#include <cex/cex.simulated.hpp>
+#include <dex/dex.simulated.hpp>
 
 #include "order.manager.hpp"
 
@@ -133,18 +135,7 @@ namespace antara::mmbot::tests
         REQUIRE_CALL(dex, get_live_orders())
             .RETURN(live_orders);
 
-        // Each order has one execution
-        std::unordered_set<st_order_id> live_order_ids;
-        live_order_ids.emplace(o1_id);
-        live_order_ids.emplace(o2_id);
-
-        std::vector<orders::execution> live_executions;
-        live_executions.push_back(e1);
-        live_executions.push_back(e2);
-
-        REQUIRE_CALL(dex, get_executions(live_order_ids))
-            .RETURN(live_executions);
-
+        // Only the executions since the last poll are asked for
         std::vector<orders::execution> recent;
         recent.push_back(e1);
         recent.push_back(e2);
@@ -161,6 +152,59 @@ namespace antara::mmbot::tests
         om.poll();
     }
 
+    TEST_CASE ("an execution pushed by the dex is mirrored once")
+    {
+        auto pair = antara::pair::of("A", "B");
+        orders::execution ex = {st_execution_id{"e_id"}, pair, st_price(10), st_quantity(10), antara::side::buy, true};
+
+        dex_mock dex;
+        cex_mock cex;
+
+        auto om = order_manager(dex, cex);
+
+        REQUIRE_CALL(cex, mirror(ex));
+        om.on_execution(ex);
+        om.on_execution(ex);
+
+        // the next poll finds it again in the recent executions
+        REQUIRE_CALL(dex, get_live_orders())
+            .RETURN(std::vector<orders::order>{});
+        REQUIRE_CALL(dex, get_recent_executions())
+            .RETURN(std::vector<orders::execution>{ex});
+        om.poll();
+    }
+
+    TEST_CASE ("an execution pushed after its order is archived is not mirrored again")
+    {
+        auto pair = antara::pair::of("A", "B");
+        auto o_id = st_order_id{"id_1"};
+        orders::order o = orders::order_builder(o_id, pair).quantity(st_quantity(10)).build();
+        orders::execution ex = {st_execution_id{"e_id"}, pair, st_price(10), st_quantity(10), antara::side::buy, true};
+        orders::order filled = orders::order_builder(o_id, pair).quantity(st_quantity(10)).filled(st_quantity(10))
+                .status(orders::order_status::filled).build();
+        filled.add_execution_id(ex.id);
+
+        dex_mock dex;
+        cex_mock cex;
+        auto om = order_manager(dex, cex);
+        om.add_orders({o});
+
+        // the dex feed thread has pushed the swap to the next sync but not yet called its listeners: the poll finds
+        // the execution first, the order is finished and archived with it.
+        REQUIRE_CALL(cex, mirror(ex));
+        REQUIRE_CALL(dex, get_order_status(o_id))
+            .RETURN(filled);
+        REQUIRE_CALL(dex, get_live_orders())
+            .RETURN(std::vector<orders::order>{});
+        REQUIRE_CALL(dex, get_recent_executions())
+            .RETURN(std::vector<orders::execution>{ex});
+        om.poll();
+        REQUIRE(om.get_all_orders().empty());
+
+        // then the delayed push arrives
+        om.on_execution(ex);
+    }
+
     TEST_CASE ("orders can be cancelled by pair")
     {
         auto pair = antara::pair::of("A", "B");
@@ -179,8 +223,9 @@ namespace antara::mmbot::tests
         ALLOW_CALL(dex, place(ol))
             .LR_RETURN(std::ref(o));
 
-        REQUIRE_CALL(dex, cancel(o_id))
-            .RETURN(true);
+        REQUIRE_CALL(dex, cancel_all(pair))
+            .RETURN(cancel_result{{o_id}, {}});
+        FORBID_CALL(dex, cancel(_));
 
         om.place_order(ol);
         CHECK_EQ(1, om.get_all_orders().size());
@@ -191,5 +236,72 @@ namespace antara::mmbot::tests
         CHECK_EQ(1, ids.count(o_id));
 
         CHECK_EQ(0, om.get_all_orders().size());
+        CHECK_EQ(orders::order_status::cancelled, om.get_order(o_id).status);
+    }
+
+    TEST_CASE ("the orders currently matching stay known after a bulk cancel")
+    {
+        auto pair = antara::pair::of("A", "B");
+        orders::order_level bid_level = {st_price(9), st_quantity(10), antara::side::buy};
+        orders::order_level ask_level = {st_price(11), st_quantity(10), antara::side::sell};
+        orders::order bid = orders::order_builder(st_order_id{"bid"}, pair).price(st_price{9}).build();
+        orders::order ask = orders::order_builder(st_order_id{"ask"}, pair).price(st_price{11}).build();
+
+        dex_mock dex;
+        cex_mock cex;
+        auto om = order_manager(dex, cex);
+
+        ALLOW_CALL(dex, place(pair, bid_level))
+            .LR_RETURN(std::ref(bid));
+        ALLOW_CALL(dex, place(pair, ask_level))
+            .LR_RETURN(std::ref(ask));
+        om.place_order(orders::order_group{pair, {bid_level, ask_level}});
+
+        std::unordered_set<st_order_id> both{bid.id, ask.id};
+        REQUIRE_CALL(dex, cancel_all(both))
+            .RETURN(cancel_result{{bid.id}, {ask.id}});
+
+        auto ids = om.cancel_orders(both);
+        CHECK_EQ(std::unordered_set<st_order_id>{bid.id}, ids);
+        REQUIRE_EQ(1, om.get_all_orders().size());
+        CHECK_EQ(1, om.get_all_orders().count(ask.id));
+        CHECK_EQ(1, om.get_archive().size());
+    }
+
+    TEST_CASE ("finished orders move to the bounded archive")
+    {
+        auto pair = antara::pair::of("A", "B");
+        simulation::matching_engine engine;
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex, 2);
+
+        auto ids = om.place_order(orders::order_group{pair, {{st_price{90}, st_quantity{10}, antara::side::buy},
+                                                             {st_price{110}, st_quantity{10}, antara::side::sell}}});
+        REQUIRE_EQ(2, ids.size());
+        CHECK_EQ(2, om.get_all_orders().size());
+
+        engine.take(pair, antara::side::buy, st_price{110}, st_quantity{10});
+        engine.take(pair, antara::side::sell, st_price{90}, st_quantity{4});
+        om.poll();
+        REQUIRE_EQ(1, om.get_all_orders().size());
+        const auto &bid = om.get_all_orders().begin()->second;
+        CHECK_EQ(orders::order_status::partially_filled, bid.status);
+        CHECK_EQ(st_quantity{4}, bid.filled);
+        REQUIRE_EQ(1, om.get_archive().size());
+        auto bid_id = bid.id;
+        ids.erase(bid_id);
+        CHECK_EQ(orders::order_status::filled, om.get_order(*ids.begin()).status);
+
+        CHECK_EQ(1, om.cancel_orders(pair).size());
+        CHECK(om.get_all_orders().empty());
+        CHECK_EQ(orders::order_status::cancelled, om.get_order(bid_id).status);
+        CHECK_EQ(2, om.get_archive().size());
+        CHECK_THROWS_AS(static_cast<void>(om.get_order(st_order_id{"unknown"})), std::out_of_range);
+
+        om.place_order(orders::order_group{pair, {{st_price{80}, st_quantity{1}, antara::side::buy}}});
+        om.cancel_orders(pair);
+        CHECK_EQ(2, om.get_archive().size());
+        CHECK_EQ(1, om.get_archive().nb_evicted());
     }
 }
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include "orders/order.archive.hpp"
+
+namespace antara::mmbot::orders
+{
+    order_archive::order_archive(std::size_t capacity) : slots_(capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("the order archive needs a capacity");
+        }
+    }
+
+    void order_archive::push(order &&finished_order)
+    {
+        if (size_ < slots_.size()) {
+            slots_[(first_ + size_) % slots_.size()] = std::move(finished_order);
+            ++size_;
+            return;
+        }
+        slots_[first_] = std::move(finished_order);
+        first_ = (first_ + 1) % slots_.size();
+        ++nb_evicted_;
+    }
+
+    const order *order_archive::find(const st_order_id &id) const noexcept
+    {
+        for (std::size_t idx = size_; idx > 0; --idx) {
+            const auto &slot = slots_[(first_ + idx - 1) % slots_.size()];
+            if (slot->id == id) {
+                return &slot.value();
+            }
+        }
+        return nullptr;
+    }
+}
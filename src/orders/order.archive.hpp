@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include "orders/orders.hpp"
+
+namespace antara::mmbot::orders
+{
+    /**
+     * @brief Last finished orders, in a ring allocated once: when it is full the oldest order is overwritten, so the
+     *        memory of the order manager does not grow with the uptime.
+     */
+    class order_archive
+    {
+    public:
+        explicit order_archive(std::size_t capacity);
+
+        void push(order &&finished_order);
+
+        //! linear, the archive is only read to answer the late status requests.
+        [[nodiscard]] const order *find(const st_order_id &id) const noexcept;
+
+        //! from the oldest to the newest.
+        template<typename Functor>
+        void for_each(Functor &&functor) const
+        {
+            for (std::size_t idx = 0; idx < size_; ++idx) {
+                functor(*slots_[(first_ + idx) % slots_.size()]);
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return slots_.size();
+        }
+
+        //! number of orders overwritten since the creation of the archive.
+        [[nodiscard]] std::size_t nb_evicted() const noexcept
+        {
+            return nb_evicted_;
+        }
+
+    private:
+        std::vector<std::optional<order>> slots_;
+        std::size_t first_{0};
+        std::size_t size_{0};
+        std::size_t nb_evicted_{0};
+    };
+}
@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "orders/order.archive.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("the order archive keeps the last finished orders")
+    {
+        CHECK_THROWS_AS(orders::order_archive(0), std::invalid_argument);
+
+        orders::order_archive archive(3);
+        auto pair = antara::pair::of("A", "B");
+        for (int idx = 0; idx < 5; ++idx) {
+            archive.push(orders::order_builder(st_order_id{"id_" + std::to_string(idx)}, pair)
+                                 .status(orders::order_status::filled)
+                                 .build());
+        }
+        CHECK_EQ(3, archive.size());
+        CHECK_EQ(3, archive.capacity());
+        CHECK_EQ(2, archive.nb_evicted());
+        CHECK_EQ(nullptr, archive.find(st_order_id{"id_1"}));
+        REQUIRE_NE(nullptr, archive.find(st_order_id{"id_4"}));
+        CHECK_EQ(orders::order_status::filled, archive.find(st_order_id{"id_4"})->status);
+
+        std::vector<st_order_id> ids;
+        archive.for_each([&ids](const orders::order &o) { ids.push_back(o.id); });
+        CHECK_EQ(std::vector<st_order_id>({"id_2", "id_3", "id_4"}), ids);
+    }
+}
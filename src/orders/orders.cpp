@@ -81,14 +81,37 @@ namespace antara::mmbot::orders
 
     // Order
 
+    const char *to_string(order_status status) noexcept
+    {
+        switch (status) {
+            case order_status::pending:
+                return "pending";
+            case order_status::live:
+                return "live";
+            case order_status::partially_filled:
+                return "partially_filled";
+            case order_status::filled:
+                return "filled";
+            case order_status::cancelled:
+                return "cancelled";
+            case order_status::rejected:
+                return "rejected";
+        }
+        return "unknown";
+    }
+
     bool order::finished() const
     {
-        return (status == orders::order_status::cancelled);
+        return is_terminal(status);
     }
 
-    void order::change_status(const order_status_change &osc)
+    bool order::change_status(const order_status_change &osc)
     {
+        if (!can_transition(status, osc.status)) {
+            return false;
+        }
         status = osc.status;
+        return true;
     }
 
     execution order::create_execution(const st_execution_id &execution_id, const st_quantity &q, const maker &maker) const
@@ -99,6 +122,12 @@ namespace antara::mmbot::orders
     void order::execute(const execution &ex)
     {
         this->filled = this->filled + ex.quantity;
+        if (finished()) {
+            return;
+        }
+        constexpr const double quantity_epsilon = 1e-12;
+        status = quantity.value() - filled.value() <= quantity_epsilon ? order_status::filled
+                                                                       : order_status::partially_filled;
     }
 
     void order::add_execution_id(const st_execution_id &e_id)
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <utility>
 #include <vector>
 #include <unordered_set>
@@ -46,9 +47,38 @@ namespace antara::mmbot::orders
 
     enum class order_status
     {
-        live, cancelled, filled
+        pending, live, partially_filled, filled, cancelled, rejected
     };
 
+    const char *to_string(order_status status) noexcept;
+
+    namespace details
+    {
+        constexpr std::size_t g_nb_order_status = 6;
+
+        //! g_order_transitions[from][to], in the order of order_status, an order can always stay in its status.
+        constexpr bool g_order_transitions[g_nb_order_status][g_nb_order_status] = {
+                {true,  true,  true,  true,  true,  true},  //! pending
+                {false, true,  true,  true,  true,  false}, //! live
+                {false, false, true,  true,  true,  false}, //! partially_filled
+                {false, false, false, true,  false, false}, //! filled
+                {false, false, false, false, true,  false}, //! cancelled
+                {false, false, false, false, false, true},  //! rejected
+        };
+    }
+
+    constexpr bool can_transition(order_status from, order_status to) noexcept
+    {
+        return details::g_order_transitions[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)];
+    }
+
+    //! filled, cancelled and rejected orders never change again.
+    constexpr bool is_terminal(order_status status) noexcept
+    {
+        return status == order_status::filled || status == order_status::cancelled ||
+               status == order_status::rejected;
+    }
+
     struct order_status_change
     {
         st_order_id id;
@@ -95,11 +125,13 @@ namespace antara::mmbot::orders
 
         [[nodiscard]] bool finished() const;
 
-        void change_status(const order_status_change &osc);
+        //! false and unchanged if the order can't go from its status to osc.status.
+        bool change_status(const order_status_change &osc);
 
         [[nodiscard]] execution
         create_execution(const st_execution_id &execution_id, const st_quantity &quantity, const maker &maker) const;
 
+        //! add the quantity of `ex` to filled, the order becomes partially_filled or filled unless it is finished.
         void execute(const execution &ex);
 
         void add_execution_id(const st_execution_id &e_id);
@@ -87,4 +87,39 @@ namespace antara::mmbot::tests
 
         CHECK_EQ(st_quantity{3}, order.filled);
     }
+
+    TEST_CASE ("orders follow the lifecycle state machine")
+    {
+        using orders::order_status;
+        CHECK(orders::can_transition(order_status::pending, order_status::rejected));
+        CHECK(orders::can_transition(order_status::live, order_status::partially_filled));
+        CHECK(orders::can_transition(order_status::partially_filled, order_status::cancelled));
+        CHECK(orders::can_transition(order_status::filled, order_status::filled));
+        CHECK_FALSE(orders::can_transition(order_status::live, order_status::pending));
+        CHECK_FALSE(orders::can_transition(order_status::live, order_status::rejected));
+        CHECK_FALSE(orders::can_transition(order_status::filled, order_status::cancelled));
+        CHECK_FALSE(orders::can_transition(order_status::cancelled, order_status::live));
+        CHECK_FALSE(orders::is_terminal(order_status::partially_filled));
+        CHECK(orders::is_terminal(order_status::rejected));
+
+        auto pair = antara::pair::of("A", "B");
+        auto order = orders::order_builder(st_order_id{"ID"}, pair)
+                .price(st_price{5})
+                .quantity(st_quantity{10})
+                .status(order_status::pending)
+                .build();
+        CHECK(order.change_status({order.id, order_status::live}));
+        CHECK_FALSE(order.finished());
+
+        order.execute(order.create_execution(st_execution_id{"e1"}, st_quantity{4}, true));
+        CHECK_EQ(order_status::partially_filled, order.status);
+        CHECK_FALSE(order.change_status({order.id, order_status::live}));
+        CHECK_EQ(order_status::partially_filled, order.status);
+
+        order.execute(order.create_execution(st_execution_id{"e2"}, st_quantity{6}, true));
+        CHECK_EQ(order_status::filled, order.status);
+        CHECK(order.finished());
+        CHECK_FALSE(order.change_status({order.id, order_status::cancelled}));
+        CHECK_EQ(std::string("filled"), orders::to_string(order.status));
+    }
 }
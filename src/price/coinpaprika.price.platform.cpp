@@ -19,13 +19,19 @@
 #include <restclient-cpp/restclient.h>
 #include <thread>
 #include "utils/antara.utils.hpp"
+#include "logging/payload.sampler.hpp"
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
 #include "coinpaprika.price.platform.hpp"
 
 namespace antara::mmbot
 {
     st_price coinpaprika_price_platform::get_price(antara::pair currency_pair, std::size_t nb_try_in_a_row) const
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        static auto &latency = metrics::get_histogram("mmbot_price_platform_latency_us",
+                                                      metrics::label("platform", "coinpaprika"));
+        metrics::scoped_timer timer(latency);
         if (this->coin_id_translation_.find(currency_pair.base.symbol.value()) != this->coin_id_translation_.end() &&
             this->coin_id_translation_.find(currency_pair.quote.symbol.value()) != this->coin_id_translation_.end()) {
             std::string path =
@@ -33,11 +39,16 @@ namespace antara::mmbot
                     this->coin_id_translation_.at(currency_pair.base.symbol.value()) +
                     "&quote_currency_id=" + this->coin_id_translation_.at(currency_pair.quote.symbol.value()) +
                     "&amount=1";
-            const auto &mmbot_config = get_mmbot_config();
+            //! held across the http round trip.
+            const auto mmbot_config_snapshot = get_mmbot_config_snapshot();
+            const auto &mmbot_config = *mmbot_config_snapshot;
             auto final_uri = mmbot_config.price_registry.at("coinpaprika").price_endpoint.value() + path;
             DVLOG_F(loguru::Verbosity_INFO, "request: %s", final_uri.c_str());
             auto response = RestClient::get(final_uri);
-            DVLOG_F(loguru::Verbosity_INFO, "response: %s\nstatus: %d", response.body.c_str(), response.code);
+            if (logging::should_log_payload()) {
+                DVLOG_F(loguru::Verbosity_INFO, "response: %s", response.body.c_str());
+            }
+            DVLOG_F(loguru::Verbosity_INFO, "status: %d", response.code);
             if (response.code == 200) {
                 antara::my_json_sax sx;
                 nlohmann::json::sax_parse(response.body, &sx);
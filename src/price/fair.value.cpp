@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include "price/fair.value.hpp"
+
+namespace
+{
+    antara::st_price to_price(long double value) noexcept
+    {
+        auto rounded = std::round(value);
+        return antara::st_price{rounded > 0 ? absl::uint128(rounded) : absl::uint128(0)};
+    }
+
+    long double to_long_double(antara::st_price price) noexcept
+    {
+        return static_cast<long double>(absl::Uint128High64(price.value())) * 18446744073709551616.0L +
+               static_cast<long double>(absl::Uint128Low64(price.value()));
+    }
+
+    template<typename Levels>
+    std::optional<std::pair<long double, long double>> weighted_side(const Levels &levels, std::size_t nb_levels)
+    {
+        long double notional = 0;
+        long double quantity = 0;
+        std::size_t idx = 0;
+        for (auto it = levels.begin(); it != levels.end() && idx < nb_levels; ++it, ++idx) {
+            notional += to_long_double(antara::st_price{it->first}) * it->second;
+            quantity += it->second;
+        }
+        if (quantity <= 0) {
+            return std::nullopt;
+        }
+        return std::make_pair(notional / quantity, quantity);
+    }
+}
+
+namespace antara::mmbot
+{
+    fair_value_estimator::fair_value_estimator(fair_value_options options) noexcept : options_(options)
+    {
+    }
+
+    void fair_value_estimator::update_level(antara::side side, st_price price, st_quantity quantity)
+    {
+        auto apply = [&price, &quantity](auto &levels) {
+            if (quantity.value() <= 0) {
+                levels.erase(price.value());
+            } else {
+                levels.insert_or_assign(price.value(), quantity.value());
+            }
+        };
+        if (side == antara::side::buy) {
+            apply(bids_);
+        } else {
+            apply(asks_);
+        }
+        recompute_book();
+    }
+
+    template<typename Levels>
+    std::size_t
+    fair_value_estimator::apply_side(Levels &levels, const std::vector<tickstore::book_level> &snapshot)
+    {
+        //! the mm2 book has one entry per order, the levels aggregate the orders of the same price.
+        std::vector<std::pair<absl::uint128, double>> aggregated;
+        aggregated.reserve(snapshot.size());
+        for (auto &&level : snapshot) {
+            aggregated.emplace_back(level.price.value(), level.quantity.value());
+        }
+        const auto compare = levels.key_comp();
+        std::sort(aggregated.begin(), aggregated.end(),
+                  [&compare](auto &&lhs, auto &&rhs) { return compare(lhs.first, rhs.first); });
+
+        //! merge the two sorted sides, only the levels that differ are touched.
+        std::size_t nb_changed = 0;
+        auto level = levels.begin();
+        for (auto it = aggregated.begin(); it != aggregated.end();) {
+            const auto price = it->first;
+            double quantity = 0;
+            for (; it != aggregated.end() && it->first == price; ++it) {
+                quantity += it->second;
+            }
+            while (level != levels.end() && compare(level->first, price)) {
+                level = levels.erase(level);
+                ++nb_changed;
+            }
+            if (level != levels.end() && level->first == price) {
+                if (level->second != quantity) {
+                    level->second = quantity;
+                    ++nb_changed;
+                }
+                ++level;
+            } else {
+                levels.emplace_hint(level, price, quantity);
+                ++nb_changed;
+            }
+        }
+        while (level != levels.end()) {
+            level = levels.erase(level);
+            ++nb_changed;
+        }
+        return nb_changed;
+    }
+
+    std::size_t fair_value_estimator::apply_book(const tickstore::book_snapshot &snapshot)
+    {
+        auto nb_changed = apply_side(bids_, snapshot.bids) + apply_side(asks_, snapshot.asks);
+        if (nb_changed > 0) {
+            recompute_book();
+        }
+        return nb_changed;
+    }
+
+    void fair_value_estimator::update_reference(st_price price)
+    {
+        snapshot_.reference = price;
+        recompute_fair_value();
+    }
+
+    void fair_value_estimator::on_execution(st_price price, clock::time_point when)
+    {
+        const auto value = to_long_double(price);
+        if (!execution_ewma_.has_value()) {
+            execution_ewma_ = value;
+        } else {
+            //! time decayed: an execution half_life after the previous one weighs as much as all the history.
+            const auto elapsed = std::chrono::duration<long double>(when - last_execution_).count();
+            const auto half_life = std::chrono::duration<long double>(options_.execution_half_life).count();
+            const auto alpha = half_life > 0 ? 1.0L - std::exp2(-std::max(elapsed, 0.0L) / half_life) : 1.0L;
+            execution_ewma_ = alpha * value + (1.0L - alpha) * execution_ewma_.value();
+        }
+        last_execution_ = when;
+        snapshot_.execution_ewma = to_price(execution_ewma_.value());
+        recompute_fair_value();
+    }
+
+    void fair_value_estimator::recompute_book() noexcept
+    {
+        snapshot_.best_bid.reset();
+        snapshot_.best_ask.reset();
+        snapshot_.mid.reset();
+        snapshot_.microprice.reset();
+        snapshot_.depth_weighted_mid.reset();
+        if (!bids_.empty()) {
+            snapshot_.best_bid = st_price{bids_.begin()->first};
+        }
+        if (!asks_.empty()) {
+            snapshot_.best_ask = st_price{asks_.begin()->first};
+        }
+        if (!bids_.empty() && !asks_.empty()) {
+            const auto bid = to_long_double(snapshot_.best_bid.value());
+            const auto ask = to_long_double(snapshot_.best_ask.value());
+            const long double bid_quantity = bids_.begin()->second;
+            const long double ask_quantity = asks_.begin()->second;
+            snapshot_.mid = to_price((bid + ask) / 2);
+            //! the side with more quantity pushes the price toward the other one.
+            snapshot_.microprice = to_price((bid * ask_quantity + ask * bid_quantity) / (bid_quantity + ask_quantity));
+            auto bid_side = weighted_side(bids_, options_.depth_levels);
+            auto ask_side = weighted_side(asks_, options_.depth_levels);
+            if (bid_side && ask_side) {
+                auto &&[bid_vwap, bid_depth] = bid_side.value();
+                auto &&[ask_vwap, ask_depth] = ask_side.value();
+                snapshot_.depth_weighted_mid = to_price(
+                        (bid_vwap * ask_depth + ask_vwap * bid_depth) / (bid_depth + ask_depth));
+            }
+        }
+        recompute_fair_value();
+    }
+
+    void fair_value_estimator::recompute_fair_value() noexcept
+    {
+        const std::optional<st_price> *book_value = &snapshot_.microprice;
+        switch (options_.book_source) {
+            case book_estimator::mid:
+                book_value = &snapshot_.mid;
+                break;
+            case book_estimator::microprice:
+                book_value = &snapshot_.microprice;
+                break;
+            case book_estimator::depth_weighted_mid:
+                book_value = &snapshot_.depth_weighted_mid;
+                break;
+        }
+        long double sum = 0;
+        long double weights = 0;
+        auto add = [&sum, &weights](const std::optional<st_price> &value, double weight) {
+            if (value.has_value() && weight > 0) {
+                sum += to_long_double(value.value()) * weight;
+                weights += weight;
+            }
+        };
+        add(snapshot_.reference, options_.reference_weight);
+        add(*book_value, options_.book_weight);
+        add(snapshot_.execution_ewma, options_.execution_weight);
+        snapshot_.fair_value = weights > 0 ? std::optional<st_price>(to_price(sum / weights)) : std::nullopt;
+    }
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "config/config.hpp"
+#include "dex/dex.mm2.hpp"
+#include "orders/orders.hpp"
+#include "tickstore/tick.recorder.hpp"
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot
+{
+    enum class book_estimator
+    {
+        mid, microprice, depth_weighted_mid
+    };
+
+    struct fair_value_options
+    {
+        book_estimator book_source{book_estimator::microprice};
+        //! levels of each side in the depth weighted mid.
+        std::size_t depth_levels{5};
+        double reference_weight{1.0};
+        double book_weight{1.0};
+        double execution_weight{0.5};
+        std::chrono::milliseconds execution_half_life{30000};
+    };
+
+    struct fair_value_snapshot
+    {
+        std::optional<st_price> best_bid;
+        std::optional<st_price> best_ask;
+        std::optional<st_price> mid;
+        std::optional<st_price> microprice;
+        std::optional<st_price> depth_weighted_mid;
+        std::optional<st_price> reference;
+        std::optional<st_price> execution_ewma;
+        //! weighted mean of the reference, of the book_source estimate and of the executions, the missing ones apart.
+        std::optional<st_price> fair_value;
+    };
+
+    /**
+     * @brief Fair value of one pair from the reference price, the local orderbook and the recent executions.
+     *        The book is kept sorted and the estimates are recomputed from the best depth_levels when it changes, so
+     *        reading them is free. update_level applies a level delta in O(log n). mm2 only answers full orderbooks,
+     *        so apply_book sorts the snapshot, O(n log n) in its number of orders, and merges it with the book,
+     *        writing only the levels that changed. mm2 books are a few hundred orders at most and come at the rpc
+     *        rate, so the sort is small next to the rpc itself.
+     */
+    class fair_value_estimator
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit fair_value_estimator(fair_value_options options = {}) noexcept;
+
+        //! a zero quantity removes the level.
+        void update_level(antara::side side, st_price price, st_quantity quantity);
+
+        //! replace the book by the full `snapshot`, returns the number of levels that changed.
+        std::size_t apply_book(const tickstore::book_snapshot &snapshot);
+
+        void update_reference(st_price price);
+
+        void on_execution(st_price price, clock::time_point when = clock::now());
+
+        [[nodiscard]] const fair_value_snapshot &get() const noexcept
+        {
+            return snapshot_;
+        }
+
+    private:
+        using bid_levels = std::map<absl::uint128, double, std::greater<>>;
+        using ask_levels = std::map<absl::uint128, double>;
+
+        template<typename Levels>
+        static std::size_t apply_side(Levels &levels, const std::vector<tickstore::book_level> &snapshot);
+
+        void recompute_book() noexcept;
+
+        void recompute_fair_value() noexcept;
+
+        fair_value_options options_;
+        bid_levels bids_;
+        ask_levels asks_;
+        std::optional<long double> execution_ewma_;
+        clock::time_point last_execution_{};
+        fair_value_snapshot snapshot_;
+    };
+
+    /**
+     * @brief Fair value of every pair, fed by the orderbook answers of the mm2 client, the prices of the price thread
+     *        and the executions. get_price() has the signature of the price service so the strategy manager can quote
+     *        around the fair value instead of the reference price, with no additional rpc.
+     */
+    template<typename TPriceService>
+    class fair_value_service
+    {
+    public:
+        explicit fair_value_service(TPriceService &price_service, fair_value_options options = {}) noexcept :
+                price_service_(price_service), options_(options)
+        {
+        }
+
+        //! the reference price is always asked to the price service, the last fair value is used if it fails.
+        st_price get_price(antara::pair pair) const
+        {
+            try {
+                auto reference = price_service_.get_price(pair);
+                std::scoped_lock lock(mutex_);
+                auto &estimator = get_estimator(pair);
+                estimator.update_reference(reference);
+                return estimator.get().fair_value.value_or(reference);
+            }
+            catch (...) {
+                std::scoped_lock lock(mutex_);
+                if (auto it = estimators_.find(pair); it != estimators_.end() && it->second.get().fair_value) {
+                    return it->second.get().fair_value.value();
+                }
+                throw;
+            }
+        }
+
+        std::optional<fair_value_snapshot> get_snapshot(const antara::pair &pair) const
+        {
+            std::scoped_lock lock(mutex_);
+            auto it = estimators_.find(pair);
+            return it == estimators_.end() ? std::nullopt : std::optional<fair_value_snapshot>(it->second.get());
+        }
+
+        void on_orderbook(const antara::pair &pair, const tickstore::book_snapshot &book)
+        {
+            std::scoped_lock lock(mutex_);
+            get_estimator(pair).apply_book(book);
+        }
+
+        void on_reference_price(const antara::pair &pair, st_price price)
+        {
+            std::scoped_lock lock(mutex_);
+            get_estimator(pair).update_reference(price);
+        }
+
+        void on_execution(const orders::execution &execution,
+                          fair_value_estimator::clock::time_point when = fair_value_estimator::clock::now())
+        {
+            std::scoped_lock lock(mutex_);
+            get_estimator(execution.pair).on_execution(execution.price, when);
+        }
+
+        //! follow the orderbooks answered to `client` and the prices computed by the price thread.
+        void attach(mm2_client &client, price_service_platform &price_platform)
+        {
+            client.add_orderbook_observer([this](const mm2::orderbook_answer &answer) {
+                on_orderbook(antara::pair{answer.rel, answer.base},
+                             tickstore::to_book_snapshot(get_mmbot_config(), answer));
+            });
+            price_platform.add_price_observer([this](const antara::pair &pair, st_price price) {
+                on_reference_price(pair, price);
+            });
+        }
+
+        //! follow the executions of the orders of `dex`, from its feed thread, before its feed starts.
+        void attach(mm2_dex &dex)
+        {
+            dex.add_execution_listener([this](const orders::execution &execution) { on_execution(execution); });
+        }
+
+    private:
+        fair_value_estimator &get_estimator(const antara::pair &pair) const
+        {
+            auto it = estimators_.find(pair);
+            if (it == estimators_.end()) {
+                it = estimators_.emplace(pair, fair_value_estimator{options_}).first;
+            }
+            return it->second;
+        }
+
+        TPriceService &price_service_;
+        fair_value_options options_;
+        mutable std::mutex mutex_;
+        mutable std::unordered_map<antara::pair, fair_value_estimator> estimators_;
+    };
+}
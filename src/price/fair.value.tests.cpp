@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <doctest/doctest.h>
+#include "price/fair.value.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot;
+
+    tickstore::book_snapshot make_book(std::vector<std::pair<unsigned long long, double>> bids,
+                                       std::vector<std::pair<unsigned long long, double>> asks)
+    {
+        tickstore::book_snapshot book;
+        for (auto &&[price, quantity] : bids) {
+            book.bids.push_back({st_price{price}, st_quantity{quantity}});
+        }
+        for (auto &&[price, quantity] : asks) {
+            book.asks.push_back({st_price{price}, st_quantity{quantity}});
+        }
+        return book;
+    }
+
+    struct reference_price_service
+    {
+        st_price get_price(const antara::pair &) const
+        {
+            if (fail) {
+                throw std::runtime_error("price not available");
+            }
+            return price;
+        }
+
+        st_price price{1000};
+        bool fail{false};
+    };
+}
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("fair value book estimates")
+    {
+        fair_value_options options;
+        options.depth_levels = 2;
+        fair_value_estimator estimator(options);
+        CHECK_FALSE(estimator.get().fair_value.has_value());
+
+        //! two orders at 99 are one level.
+        CHECK_EQ(5, estimator.apply_book(make_book({{99, 1.0}, {98, 4.0}, {99, 2.0}, {90, 10.0}}, {{101, 1.0}, {103, 1.0}})));
+        const auto &snapshot = estimator.get();
+        CHECK_EQ(st_price{99}, snapshot.best_bid.value());
+        CHECK_EQ(st_price{101}, snapshot.best_ask.value());
+        CHECK_EQ(st_price{100}, snapshot.mid.value());
+        //! (99 * 1 + 101 * 3) / 4
+        CHECK_EQ(st_price{101}, snapshot.microprice.value());
+        //! bids: vwap 98.43 on 7, asks: vwap 102 on 2 -> (98.43 * 2 + 102 * 7) / 9
+        CHECK_EQ(st_price{101}, snapshot.depth_weighted_mid.value());
+        CHECK_EQ(st_price{101}, snapshot.fair_value.value());
+
+        CHECK_EQ(0, estimator.apply_book(make_book({{99, 1.0}, {98, 4.0}, {99, 2.0}, {90, 10.0}}, {{101, 1.0}, {103, 1.0}})));
+        CHECK_EQ(2, estimator.apply_book(make_book({{99, 3.0}, {98, 4.0}}, {{101, 3.0}, {103, 1.0}})));
+        CHECK_EQ(st_price{100}, estimator.get().microprice.value());
+
+        estimator.update_level(antara::side::sell, st_price{101}, st_quantity{0});
+        CHECK_EQ(st_price{103}, estimator.get().best_ask.value());
+        estimator.update_level(antara::side::buy, st_price{100}, st_quantity{1});
+        CHECK_EQ(st_price{100}, estimator.get().best_bid.value());
+    }
+
+    TEST_CASE ("fair value combines the reference, the book and the executions")
+    {
+        fair_value_options options;
+        options.book_source = book_estimator::mid;
+        options.reference_weight = 1.0;
+        options.book_weight = 1.0;
+        options.execution_weight = 2.0;
+        options.execution_half_life = std::chrono::seconds{10};
+        fair_value_estimator estimator(options);
+
+        estimator.update_reference(st_price{1000});
+        CHECK_EQ(st_price{1000}, estimator.get().fair_value.value());
+        estimator.apply_book(make_book({{1090, 1.0}}, {{1110, 1.0}}));
+        CHECK_EQ(st_price{1050}, estimator.get().fair_value.value());
+
+        auto now = fair_value_estimator::clock::now();
+        estimator.on_execution(st_price{1200}, now);
+        CHECK_EQ(st_price{1200}, estimator.get().execution_ewma.value());
+        CHECK_EQ(st_price{1125}, estimator.get().fair_value.value());
+        //! one half life later the new execution weighs half.
+        estimator.on_execution(st_price{1000}, now + std::chrono::seconds{10});
+        CHECK_EQ(st_price{1100}, estimator.get().execution_ewma.value());
+    }
+
+    TEST_CASE ("fair value service quotes around the fair value and survives the reference failures")
+    {
+        reference_price_service reference;
+        fair_value_service<reference_price_service> service(reference);
+        auto pair = antara::pair::of("MORTY", "RICK");
+        CHECK_FALSE(service.get_snapshot(pair).has_value());
+        CHECK_EQ(st_price{1000}, service.get_price(pair));
+
+        service.on_orderbook(pair, make_book({{1190, 1.0}}, {{1210, 1.0}}));
+        CHECK_EQ(st_price{1100}, service.get_price(pair));
+        CHECK_EQ(st_price{1200}, service.get_snapshot(pair)->microprice.value());
+
+        reference.fail = true;
+        CHECK_EQ(st_price{1100}, service.get_price(pair));
+        CHECK_THROWS_AS(static_cast<void>(service.get_price(antara::pair::of("KMD", "RICK"))), std::runtime_error);
+    }
+}
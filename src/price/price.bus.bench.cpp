@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "price/price.bus.hpp"
+
+namespace
+{
+    using namespace antara;
+
+    const std::filesystem::path bench_bus_path = "mmbot.bench.price.bus";
+
+    void BM_price_bus_publish(benchmark::State &state)
+    {
+        mmbot::price_bus_writer writer(bench_bus_path);
+        const auto pair = pair::of("BTC", "KMD");
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(writer.publish(pair, st_price{42u}));
+        }
+    }
+
+    void BM_price_bus_get_by_slot(benchmark::State &state)
+    {
+        mmbot::price_bus_writer writer(bench_bus_path);
+        const auto pair = pair::of("BTC", "KMD");
+        writer.publish(pair, st_price{42u});
+        mmbot::price_bus_reader reader(bench_bus_path);
+        const auto slot = reader.find(pair).value();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(reader.get(slot));
+        }
+    }
+
+    void BM_price_bus_get_by_pair(benchmark::State &state)
+    {
+        mmbot::price_bus_writer writer(bench_bus_path);
+        const auto pair = pair::of("BTC", "KMD");
+        writer.publish(pair, st_price{42u});
+        mmbot::price_bus_reader reader(bench_bus_path);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(reader.get(pair));
+        }
+    }
+}
+
+BENCHMARK(BM_price_bus_publish);
+BENCHMARK(BM_price_bus_get_by_slot);
+BENCHMARK(BM_price_bus_get_by_pair);
@@ -0,0 +1,255 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <loguru.hpp>
+#include "utils/exceptions.hpp"
+#include "price.bus.hpp"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MMBOT_HAS_MMAP 1
+#endif
+
+namespace
+{
+    using namespace antara::mmbot;
+
+    std::size_t segment_size(std::size_t capacity) noexcept
+    {
+        return sizeof(price_bus_layout::header) + capacity * sizeof(price_bus_layout::slot);
+    }
+
+    bool copy_symbol(const std::string &symbol, std::array<char, 16> &destination) noexcept
+    {
+        if (symbol.empty() || symbol.size() >= destination.size()) {
+            return false;
+        }
+        std::copy(begin(symbol), end(symbol), begin(destination));
+        return true;
+    }
+
+    std::system_error bus_error(int error, const std::filesystem::path &path)
+    {
+        return std::system_error(error, std::generic_category(), "price bus " + path.string());
+    }
+
+    void write_price(price_bus_layout::slot &slot, antara::st_price price) noexcept
+    {
+        const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.price_high.store(absl::Uint128High64(price.value()), std::memory_order_relaxed);
+        slot.price_low.store(absl::Uint128Low64(price.value()), std::memory_order_relaxed);
+        slot.updated_at_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+}
+
+namespace antara::mmbot
+{
+    price_bus_writer::price_bus_writer(std::filesystem::path path, std::size_t capacity) :
+            path_(std::move(path)), size_(segment_size(capacity))
+    {
+        if (capacity == 0 || capacity > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("the price bus needs a capacity");
+        }
+#ifdef MMBOT_HAS_MMAP
+        //! the readers of a previous writer keep their mapping, they see it closed and open the new one.
+        ::unlink(path_.c_str());
+        int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0) {
+            throw bus_error(errno, path_);
+        }
+        void *addr = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(size_)) == 0) {
+            addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        auto error = errno;
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            ::unlink(path_.c_str());
+            throw bus_error(error, path_);
+        }
+        header_ = new(addr) price_bus_layout::header{};
+        slots_ = reinterpret_cast<price_bus_layout::slot *>(static_cast<std::byte *>(addr) +
+                                                           sizeof(price_bus_layout::header));
+        for (std::size_t idx = 0; idx < capacity; ++idx) {
+            new(slots_ + idx) price_bus_layout::slot{};
+        }
+        header_->version = price_bus_layout::version;
+        header_->capacity = static_cast<std::uint32_t>(capacity);
+        header_->magic.store(price_bus_layout::magic, std::memory_order_release);
+        VLOG_F(loguru::Verbosity_INFO, "price bus of %zu pairs published on %s", capacity, path_.string().c_str());
+#else
+        throw errors::not_implemented("the price bus needs mmap");
+#endif
+    }
+
+    price_bus_writer::~price_bus_writer() noexcept
+    {
+#ifdef MMBOT_HAS_MMAP
+        if (header_ != nullptr) {
+            header_->closed.store(1, std::memory_order_release);
+            ::munmap(header_, size_);
+            ::unlink(path_.c_str());
+        }
+#endif
+    }
+
+    bool price_bus_writer::publish(const antara::pair &pair, st_price price)
+    {
+        std::scoped_lock lock(mutex_);
+        if (auto slot = slot_of_.find(pair); slot != slot_of_.end()) {
+            write_price(slots_[slot->second], price);
+            return true;
+        }
+        const auto id = header_->nb_slots.load(std::memory_order_relaxed);
+        if (id == header_->capacity || !copy_symbol(pair.base.symbol.value(), slots_[id].base) ||
+            !copy_symbol(pair.quote.symbol.value(), slots_[id].quote)) {
+            VLOG_F(loguru::Verbosity_WARNING, "%s/%s has no slot on the price bus (%u pairs)",
+                   pair.base.symbol.value().c_str(), pair.quote.symbol.value().c_str(), id);
+            if (id < header_->capacity) {
+                slots_[id].base = {};
+                slots_[id].quote = {};
+            }
+            return false;
+        }
+        auto &slot = slots_[id];
+        //! a slot is visible with its first price already written.
+        write_price(slot, price);
+        header_->nb_slots.store(id + 1, std::memory_order_release);
+        slot_of_.emplace(pair, id);
+        return true;
+    }
+
+    std::size_t price_bus_writer::nb_pairs() const noexcept
+    {
+        return header_->nb_slots.load(std::memory_order_relaxed);
+    }
+
+    price_bus_reader::price_bus_reader(const std::filesystem::path &path)
+    {
+#ifdef MMBOT_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw bus_error(errno, path);
+        }
+        struct stat st{};
+        void *addr = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(price_bus_layout::header)) {
+            size_ = static_cast<std::size_t>(st.st_size);
+            addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        auto error = errno;
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw bus_error(error == 0 ? EINVAL : error, path);
+        }
+        header_ = static_cast<const price_bus_layout::header *>(addr);
+        if (header_->magic.load(std::memory_order_acquire) != price_bus_layout::magic ||
+            header_->version != price_bus_layout::version || size_ < segment_size(header_->capacity)) {
+            ::munmap(addr, size_);
+            header_ = nullptr;
+            throw bus_error(EPROTO, path);
+        }
+        slots_ = reinterpret_cast<const price_bus_layout::slot *>(static_cast<const std::byte *>(addr) +
+                                                                 sizeof(price_bus_layout::header));
+#else
+        throw errors::not_implemented("the price bus needs mmap");
+#endif
+    }
+
+    price_bus_reader::~price_bus_reader() noexcept
+    {
+#ifdef MMBOT_HAS_MMAP
+        if (header_ != nullptr) {
+            ::munmap(const_cast<price_bus_layout::header *>(header_), size_);
+        }
+#endif
+    }
+
+    std::optional<price_bus_reader::slot_id> price_bus_reader::find(const antara::pair &pair)
+    {
+        const auto nb_slots = std::min(header_->nb_slots.load(std::memory_order_acquire), header_->capacity);
+        for (; nb_interned_ < nb_slots; ++nb_interned_) {
+            const auto &slot = slots_[nb_interned_];
+            slot_of_.emplace(antara::pair{asset{st_symbol{std::string(slot.quote.data())}},
+                                          asset{st_symbol{std::string(slot.base.data())}}}, nb_interned_);
+        }
+        if (auto slot = slot_of_.find(pair); slot != slot_of_.end()) {
+            return slot->second;
+        }
+        return std::nullopt;
+    }
+
+    price_bus_quote price_bus_reader::get(slot_id slot) const noexcept
+    {
+        if (slot >= header_->capacity || slot >= header_->nb_slots.load(std::memory_order_acquire)) {
+            return price_bus_quote{st_price{0u}, {}};
+        }
+        const auto &cur_slot = slots_[slot];
+        for (std::size_t nb_tries = 0;; ++nb_tries) {
+            const auto before = cur_slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) == 0) {
+                const auto high = cur_slot.price_high.load(std::memory_order_relaxed);
+                const auto low = cur_slot.price_low.load(std::memory_order_relaxed);
+                const auto updated_at_ns = cur_slot.updated_at_ns.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (cur_slot.sequence.load(std::memory_order_relaxed) == before) {
+                    return price_bus_quote{st_price{absl::MakeUint128(high, low)},
+                                           std::chrono::system_clock::time_point{
+                                                   std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                                           std::chrono::nanoseconds{updated_at_ns})}};
+                }
+            }
+            //! the writer was preempted in the middle of this slot.
+            if (nb_tries > 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::optional<price_bus_quote> price_bus_reader::get(const antara::pair &pair)
+    {
+        if (auto slot = find(pair); slot.has_value()) {
+            return get(slot.value());
+        }
+        return std::nullopt;
+    }
+
+    bool price_bus_reader::is_live() const noexcept
+    {
+        return header_->closed.load(std::memory_order_acquire) == 0;
+    }
+
+    std::size_t price_bus_reader::nb_pairs() const noexcept
+    {
+        return header_->nb_slots.load(std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot
+{
+    //! memory layout of the price bus, shared by the writer and the readers of every process.
+    namespace price_bus_layout
+    {
+        inline constexpr std::uint64_t magic = 0x7375626d6d626f74ull;
+        inline constexpr std::uint32_t version = 1;
+
+        struct alignas(64) header
+        {
+            //! written last by the writer, a reader opening the bus before sees 0.
+            std::atomic<std::uint64_t> magic{0};
+            std::uint32_t version{0};
+            std::uint32_t capacity{0};
+            //! the slots below are interned, their symbols never change.
+            std::atomic<std::uint32_t> nb_slots{0};
+            //! set when the writer is destroyed, the readers should open the bus again.
+            std::atomic<std::uint32_t> closed{0};
+        };
+
+        //! one pair on its own cache line, guarded by a seqlock: `sequence` is odd while the price is written.
+        struct alignas(64) slot
+        {
+            std::atomic<std::uint64_t> sequence{0};
+            std::array<char, 16> base{};
+            std::array<char, 16> quote{};
+            std::atomic<std::uint64_t> price_high{0};
+            std::atomic<std::uint64_t> price_low{0};
+            std::atomic<std::int64_t> updated_at_ns{0};
+        };
+
+        static_assert(sizeof(slot) == 64, "a slot is one cache line");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the bus is shared between processes");
+    }
+
+    struct price_bus_quote
+    {
+        st_price price;
+        std::chrono::system_clock::time_point updated_at;
+    };
+
+    /**
+     * @brief Publishes the latest price of each pair in a shared memory segment, so the local processes read them
+     *        without http nor json. A pair gets a slot the first time it is published and keeps it, symbols are at
+     *        most 15 characters. The segment at `path` is replaced when the writer starts and removed when it stops,
+     *        e.g. /dev/shm/mmbot.prices on linux.
+     */
+    class price_bus_writer
+    {
+    public:
+        explicit price_bus_writer(std::filesystem::path path, std::size_t capacity = 1024);
+
+        ~price_bus_writer() noexcept;
+
+        price_bus_writer(const price_bus_writer &) = delete;
+
+        price_bus_writer &operator=(const price_bus_writer &) = delete;
+
+        //! false when the pair can't get a slot: the bus is full or a symbol is too long.
+        bool publish(const antara::pair &pair, st_price price);
+
+        [[nodiscard]] std::size_t nb_pairs() const noexcept;
+
+    private:
+        std::filesystem::path path_;
+        std::size_t size_{0};
+        price_bus_layout::header *header_{nullptr};
+        price_bus_layout::slot *slots_{nullptr};
+        std::mutex mutex_;
+        std::unordered_map<antara::pair, std::uint32_t> slot_of_;
+    };
+
+    /**
+     * @brief Reads the price bus of another process. Looking a pair up hashes it, the readers polling the same pairs
+     *        keep the slot id of `find` and `get` it, which only spins while the writer updates that very slot.
+     *        A reader is not thread safe, each thread has its own.
+     */
+    class price_bus_reader
+    {
+    public:
+        using slot_id = std::uint32_t;
+
+        //! throws std::system_error when the bus can't be mapped, or isn't a price bus ready to be read.
+        explicit price_bus_reader(const std::filesystem::path &path);
+
+        ~price_bus_reader() noexcept;
+
+        price_bus_reader(const price_bus_reader &) = delete;
+
+        price_bus_reader &operator=(const price_bus_reader &) = delete;
+
+        //! std::nullopt while the pair has never been published.
+        [[nodiscard]] std::optional<slot_id> find(const antara::pair &pair);
+
+        //! a price of 0 for a slot not published yet, e.g. an id that doesn't come from `find`.
+        [[nodiscard]] price_bus_quote get(slot_id slot) const noexcept;
+
+        [[nodiscard]] std::optional<price_bus_quote> get(const antara::pair &pair);
+
+        //! false once the writer is gone, the prices are then frozen.
+        [[nodiscard]] bool is_live() const noexcept;
+
+        [[nodiscard]] std::size_t nb_pairs() const noexcept;
+
+    private:
+        std::size_t size_{0};
+        const price_bus_layout::header *header_{nullptr};
+        const price_bus_layout::slot *slots_{nullptr};
+        std::unordered_map<antara::pair, slot_id> slot_of_;
+        slot_id nb_interned_{0};
+    };
+}
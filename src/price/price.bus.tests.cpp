@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <atomic>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <doctest/doctest.h>
+#include "price/price.bus.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("price bus readers see the latest price of each pair")
+    {
+        const std::filesystem::path path = "mmbot.tests.price.bus";
+        const auto kmd_btc = antara::pair::of("BTC", "KMD");
+        const auto rick_morty = antara::pair::of("MORTY", "RICK");
+        CHECK_THROWS_AS(price_bus_writer(path, 0), std::invalid_argument);
+        {
+            std::optional<price_bus_writer> bus;
+            auto &writer = bus.emplace(path, 2);
+            price_bus_reader reader(path);
+            CHECK(reader.is_live());
+            CHECK_FALSE(reader.get(kmd_btc).has_value());
+            CHECK_EQ(st_price{0u}, reader.get(price_bus_reader::slot_id{0}).price);
+            CHECK_EQ(st_price{0u}, reader.get(price_bus_reader::slot_id{1000}).price);
+
+            CHECK(writer.publish(kmd_btc, st_price{100u}));
+            auto slot = reader.find(kmd_btc);
+            REQUIRE(slot.has_value());
+            CHECK_EQ(st_price{100u}, reader.get(slot.value()).price);
+            CHECK(writer.publish(kmd_btc, st_price{absl::MakeUint128(1, 2)}));
+            CHECK_EQ(st_price{absl::MakeUint128(1, 2)}, reader.get(slot.value()).price);
+            CHECK_LE(reader.get(slot.value()).updated_at, std::chrono::system_clock::now());
+
+            CHECK_FALSE(writer.publish(antara::pair::of("BTC", "SIXTEEN_CHARS_XX"), st_price{1u}));
+            CHECK(writer.publish(rick_morty, st_price{7u}));
+            CHECK_FALSE(writer.publish(antara::pair::of("BTC", "DOGE"), st_price{1u}));
+            CHECK_EQ(2, reader.nb_pairs());
+            CHECK_EQ(st_price{7u}, reader.get(rick_morty).value().price);
+            CHECK_EQ(slot, reader.find(kmd_btc));
+
+            price_bus_reader late_reader(path);
+            CHECK_EQ(st_price{7u}, late_reader.get(rick_morty).value().price);
+
+            bus.reset();
+            CHECK_FALSE(reader.is_live());
+            CHECK_EQ(st_price{7u}, reader.get(rick_morty).value().price);
+            CHECK_FALSE(std::filesystem::exists(path));
+        }
+        CHECK_THROWS_AS(price_bus_reader{path}, std::system_error);
+        {
+            std::ofstream ofs(path);
+            ofs << std::string(sizeof(price_bus_layout::header), 'x');
+        }
+        CHECK_THROWS_AS(price_bus_reader{path}, std::system_error);
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE ("price bus reads are never torn by a concurrent writer")
+    {
+        const std::filesystem::path path = "mmbot.tests.price.bus";
+        const auto kmd_btc = antara::pair::of("BTC", "KMD");
+        price_bus_writer writer(path);
+        writer.publish(kmd_btc, st_price{absl::MakeUint128(0, 0)});
+        std::atomic_bool stopped{false};
+        std::thread publisher([&writer, &stopped, &kmd_btc]() {
+            for (std::uint64_t idx = 1; !stopped; ++idx) {
+                writer.publish(kmd_btc, st_price{absl::MakeUint128(idx, idx)});
+            }
+        });
+        price_bus_reader reader(path);
+        const auto slot = reader.find(kmd_btc).value();
+        std::size_t nb_torn = 0;
+        for (int idx = 0; idx < 200000; ++idx) {
+            auto price = reader.get(slot).price.value();
+            nb_torn += absl::Uint128High64(price) != absl::Uint128Low64(price) ? 1 : 0;
+        }
+        stopped = true;
+        publisher.join();
+        CHECK_EQ(0, nb_torn);
+    }
+}
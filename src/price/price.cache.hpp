@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include <utils/mmbot_strong_types.hpp>
+
+namespace antara::mmbot
+{
+    struct price_cache_stats
+    {
+        std::size_t hits{0};
+        std::size_t misses{0};
+        std::size_t coalesced{0};
+    };
+
+    inline void to_json(nlohmann::json &j, const price_cache_stats &stats)
+    {
+        j["hits"] = stats.hits;
+        j["misses"] = stats.misses;
+        j["coalesced"] = stats.coalesced;
+    }
+
+    /**
+     * @brief TTL cache in front of a price service. Concurrent requests for a pair that is being fetched wait for the
+     *        same upstream call instead of issuing their own (single-flight). Failures are not cached, every waiter of
+     *        the failed call gets the exception. The pairs come from the http clients, so at most `max_entries` are
+     *        kept: the expired ones are evicted when it is reached, and the pairs beyond it are fetched uncached.
+     */
+    template<typename TPriceService>
+    class price_cache
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit price_cache(TPriceService &price_service,
+                             std::chrono::milliseconds ttl = std::chrono::milliseconds{5000},
+                             std::size_t max_entries = 4096) noexcept :
+                price_service_(price_service), ttl_(ttl), max_entries_(max_entries)
+        {
+        }
+
+        st_price get_price(const antara::pair &currency_pair)
+        {
+            std::promise<st_price> promise;
+            {
+                std::unique_lock lock(mutex_);
+                auto found = entries_.find(currency_pair);
+                if (found == entries_.end()) {
+                    if (entries_.size() >= max_entries_) {
+                        evict_expired();
+                    }
+                    if (entries_.size() >= max_entries_) {
+                        ++stats_.misses;
+                        lock.unlock();
+                        return price_service_.get_price(currency_pair);
+                    }
+                    found = entries_.try_emplace(currency_pair).first;
+                }
+                auto &entry = found->second;
+                if (entry.has_value && clock::now() < entry.expiry) {
+                    ++stats_.hits;
+                    return entry.value;
+                }
+                if (entry.in_flight.valid()) {
+                    ++stats_.coalesced;
+                    auto in_flight = entry.in_flight;
+                    lock.unlock();
+                    return in_flight.get();
+                }
+                ++stats_.misses;
+                entry.in_flight = promise.get_future().share();
+            }
+
+            try {
+                auto price = price_service_.get_price(currency_pair);
+                {
+                    std::scoped_lock lock(mutex_);
+                    auto &entry = entries_.at(currency_pair);
+                    entry.value = price;
+                    entry.has_value = true;
+                    entry.expiry = clock::now() + ttl_;
+                    entry.in_flight = {};
+                }
+                promise.set_value(price);
+                return price;
+            }
+            catch (...) {
+                {
+                    //! the entry is in flight, nothing else erases it, unknown pairs don't stay in the map.
+                    std::scoped_lock lock(mutex_);
+                    entries_.erase(currency_pair);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+        }
+
+        price_cache_stats get_stats() const
+        {
+            std::scoped_lock lock(mutex_);
+            return stats_;
+        }
+
+        void invalidate()
+        {
+            std::scoped_lock lock(mutex_);
+            for (auto &&[pair, entry] : entries_) {
+                entry.has_value = false;
+            }
+        }
+
+        std::size_t size() const
+        {
+            std::scoped_lock lock(mutex_);
+            return entries_.size();
+        }
+
+    private:
+        struct cache_entry
+        {
+            st_price value{0};
+            bool has_value{false};
+            clock::time_point expiry{};
+            std::shared_future<st_price> in_flight{};
+        };
+
+        //! called with the lock held, the entries being fetched are kept for their waiters.
+        void evict_expired()
+        {
+            const auto now = clock::now();
+            for (auto it = entries_.begin(); it != entries_.end();) {
+                if (!it->second.in_flight.valid() && (!it->second.has_value || it->second.expiry <= now)) {
+                    it = entries_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        TPriceService &price_service_;
+        std::chrono::milliseconds ttl_;
+        std::size_t max_entries_;
+        mutable std::mutex mutex_;
+        std::unordered_map<antara::pair, cache_entry> entries_;
+        price_cache_stats stats_;
+    };
+}
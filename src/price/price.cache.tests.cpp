@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "price.cache.hpp"
+#include "exceptions.price.platform.hpp"
+
+namespace antara::mmbot::tests
+{
+    struct slow_price_service
+    {
+        st_price get_price(const antara::pair &currency_pair)
+        {
+            ++nb_calls;
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            if (currency_pair.base.symbol.value() == "NONEXISTENT") {
+                throw errors::pair_not_available();
+            }
+            return st_price{42};
+        }
+
+        std::atomic_size_t nb_calls{0};
+    };
+
+    TEST_CASE ("price cache serves repeated requests from one upstream call until the ttl expires")
+    {
+        slow_price_service service;
+        auto pair = antara::pair::of("EUR", "KMD");
+        price_cache<slow_price_service> cache(service, std::chrono::milliseconds{200});
+        CHECK_EQ(st_price{42}, cache.get_price(pair));
+        CHECK_EQ(st_price{42}, cache.get_price(pair));
+        CHECK_EQ(1, service.nb_calls);
+        CHECK_EQ(1, cache.get_stats().hits);
+        CHECK_EQ(1, cache.get_stats().misses);
+
+        cache.invalidate();
+        CHECK_EQ(st_price{42}, cache.get_price(pair));
+        CHECK_EQ(2, service.nb_calls);
+    }
+
+    TEST_CASE ("price cache coalesces concurrent requests for the same pair")
+    {
+        slow_price_service service;
+        auto pair = antara::pair::of("EUR", "KMD");
+        price_cache<slow_price_service> cache(service);
+        std::vector<std::thread> clients;
+        std::atomic_size_t nb_good_answers{0};
+        for (int idx = 0; idx < 8; ++idx) {
+            clients.emplace_back([&cache, &pair, &nb_good_answers]() {
+                if (cache.get_price(pair) == st_price{42}) {
+                    ++nb_good_answers;
+                }
+            });
+        }
+        for (auto &&client : clients) {
+            client.join();
+        }
+        CHECK_EQ(8, nb_good_answers);
+        CHECK_EQ(1, service.nb_calls);
+        auto stats = cache.get_stats();
+        CHECK_EQ(8, stats.hits + stats.misses + stats.coalesced);
+        CHECK_EQ(1, stats.misses);
+    }
+
+    TEST_CASE ("price cache doesn't keep failures")
+    {
+        slow_price_service service;
+        auto pair = antara::pair::of("EUR", "NONEXISTENT");
+        price_cache<slow_price_service> cache(service);
+        CHECK_THROWS_AS(cache.get_price(pair), errors::pair_not_available);
+        CHECK_THROWS_AS(cache.get_price(pair), errors::pair_not_available);
+        CHECK_EQ(2, service.nb_calls);
+        CHECK_EQ(0, cache.size());
+    }
+
+    TEST_CASE ("price cache keeps at most max entries and evicts the expired ones first")
+    {
+        slow_price_service service;
+        price_cache<slow_price_service> cache(service, std::chrono::milliseconds{100}, 2);
+        CHECK_EQ(st_price{42}, cache.get_price(antara::pair::of("EUR", "KMD")));
+        CHECK_EQ(st_price{42}, cache.get_price(antara::pair::of("USD", "KMD")));
+        CHECK_EQ(st_price{42}, cache.get_price(antara::pair::of("GBP", "KMD")));
+        CHECK_EQ(2, cache.size());
+        CHECK_EQ(3, service.nb_calls);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{150});
+        CHECK_EQ(st_price{42}, cache.get_price(antara::pair::of("GBP", "KMD")));
+        CHECK_EQ(1, cache.size());
+        CHECK_EQ(st_price{42}, cache.get_price(antara::pair::of("GBP", "KMD")));
+        CHECK_EQ(4, service.nb_calls);
+    }
+}
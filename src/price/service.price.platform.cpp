@@ -18,26 +18,69 @@
 #include <fmt/format.h>
 #include "utils/antara.utils.hpp"
 #include "utils/antara.algorithm.hpp"
+#include "metrics/metrics.hpp"
+#include "tracing/tracing.hpp"
 #include "exceptions.price.platform.hpp"
 #include "service.price.platform.hpp"
 
 namespace antara::mmbot
 {
-    price_service_platform::price_service_platform() noexcept
+    price_service_platform::price_service_platform() noexcept :
+            registry_platform_price_(create_platforms(get_mmbot_config().price_registry)),
+            config_subscription_(subscribe_mmbot_config([this](const config &previous, const config &current) {
+                on_config_changed(previous, current);
+            }))
     {
-        const auto &cfg = antara::mmbot::get_mmbot_config();
         VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-        for (auto[platform_name, platform_cfg]: cfg.price_registry) {
+    }
+
+    price_service_platform::price_service_platform(price_platform_ptr platform) noexcept :
+            registry_platform_price_([&platform]() {
+                registry_platform_price platforms;
+                platforms.emplace("fixed", std::move(platform));
+                return platforms;
+            }()),
+            fixed_platform_(true),
+            config_subscription_(subscribe_mmbot_config([this](const config &previous, const config &current) {
+                on_config_changed(previous, current);
+            }))
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+    }
+
+    price_service_platform::registry_platform_price
+    price_service_platform::create_platforms(const config::price_infos_registry &price_registry)
+    {
+        registry_platform_price platforms;
+        for (auto &&[platform_name, platform_cfg]: price_registry) {
             auto current_price_platform_ptr = factory_price_platform::create(platform_name);
             if (current_price_platform_ptr != nullptr) {
-                registry_platform_price_.emplace(platform_name, std::move(current_price_platform_ptr));
+                platforms.emplace(platform_name, std::move(current_price_platform_ptr));
             }
         }
+        return platforms;
+    }
+
+    void price_service_platform::on_config_changed(const config &previous, const config &current)
+    {
+        if (!fixed_platform_ && previous.price_registry != current.price_registry) {
+            DVLOG_F(loguru::Verbosity_INFO, "price providers changed, %zu configured", current.price_registry.size());
+            registry_platform_price_.publish(create_platforms(current.price_registry));
+        }
+        if (previous.price_poll_interval_ms != current.price_poll_interval_ms) {
+            std::scoped_lock lock(price_service_mutex_);
+            price_service_cv_.notify_all();
+        }
     }
 
     st_price price_service_platform::get_price(antara::pair currency_pair) const
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
+        //! not labelled by pair: the pairs come from the http clients, the per provider latency is labelled.
+        static auto &requests = metrics::get_counter("mmbot_price_requests_total");
+        static auto &latency = metrics::get_histogram("mmbot_price_latency_us");
+        requests.inc();
+        metrics::scoped_timer timer(latency);
         struct TransformResult
         {
             absl::uint128 price = 0;
@@ -45,9 +88,12 @@ namespace antara::mmbot
         };
         TransformResult result{};
 
+        //! held, the providers answer over the network and may be replaced meanwhile.
+        const auto platforms_snapshot = registry_platform_price_.load();
+        const auto &platforms = *platforms_snapshot;
         tf::Taskflow taskflow;
         taskflow.transform_reduce(
-                begin(registry_platform_price_), end(registry_platform_price_), result,
+                begin(platforms), end(platforms), result,
 
                 // reduce
                 [](TransformResult a, TransformResult b) {
@@ -69,7 +115,7 @@ namespace antara::mmbot
                 }
         );
 
-        tf::Executor{}.run(taskflow).wait();
+        executor_.run(taskflow).wait();
 
         if (result.calls_succeeded == 0) {
             throw errors::pair_not_available();
@@ -79,18 +125,34 @@ namespace antara::mmbot
 
     nlohmann::json price_service_platform::get_all_price_pairs_of_given_coin(const antara::asset &asset)
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         nlohmann::json json_data = nlohmann::json::object();
         json_data[asset.symbol.value()] = nlohmann::json::array();
-        auto functor = [&asset, this, &json_data](auto &&current_coin) {
+        //! held while the prices of every coin are fetched.
+        const auto mmbot_config_snapshot = get_mmbot_config_snapshot();
+        const auto &mmbot_config = *mmbot_config_snapshot;
+        const auto asset_id = mmbot_config.coin_scales.get_id(asset.symbol.value());
+        auto functor = [&asset, asset_id, &mmbot_config, this, &json_data](auto &&current_coin) {
             if (current_coin != asset.symbol.value()) {
                 nlohmann::json current_data = nlohmann::json::object();
                 antara::pair current_pair{antara::asset{st_symbol{current_coin}}, asset};
+                if (this->pair_filter_ && !this->pair_filter_(current_pair)) {
+                    return;
+                }
                 try {
                     auto current_price = this->get_price(current_pair);
-                    auto current_price_str = antara::get_price_as_string_decimal(get_mmbot_config(), asset.symbol,
-                                                                                 current_pair.quote.symbol,
-                                                                                 current_price);
+                    for (auto &&observer : this->price_observers_) {
+                        observer(current_pair, current_price);
+                    }
+                    const auto current_coin_id = mmbot_config.coin_scales.get_id(current_coin);
+                    if (asset_id == coin_scale_table::invalid_coin_id ||
+                        current_coin_id == coin_scale_table::invalid_coin_id) {
+                        VLOG_F(loguru::Verbosity_WARNING, "no decimals registered for %s/%s",
+                               asset.symbol.value().c_str(), current_coin.c_str());
+                        return;
+                    }
+                    auto current_price_str = antara::get_price_as_string_decimal(mmbot_config, asset_id,
+                                                                                 current_coin_id, current_price);
 
                     current_data[asset.symbol.value() + "/" + current_coin] = current_price_str;
                     json_data[asset.symbol.value()].push_back(current_data);
@@ -107,7 +169,7 @@ namespace antara::mmbot
 
     nlohmann::json price_service_platform::fetch_all_price()
     {
-        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        MMBOT_TRACE_FUNCTION();
         nlohmann::json json_data = nlohmann::json::array();
         std::for_each(begin(coins_to_track_), end(coins_to_track_), [&json_data, this](auto &&current_asset) {
             json_data.push_back(get_all_price_pairs_of_given_coin(antara::asset{st_symbol{current_asset}}));
@@ -118,7 +180,12 @@ namespace antara::mmbot
 
     price_service_platform::~price_service_platform() noexcept
     {
-        this->keep_thread_alive_ = false;
+        unsubscribe_mmbot_config(config_subscription_);
+        {
+            std::scoped_lock lock(price_service_mutex_);
+            this->keep_thread_alive_ = false;
+        }
+        price_service_cv_.notify_all();
 
         if (price_service_fetcher_.joinable()) {
             price_service_fetcher_.join();
@@ -129,21 +196,36 @@ namespace antara::mmbot
     {
         price_service_fetcher_ = std::thread([this]() {
             loguru::set_thread_name("price sv thread");
+            tracing::set_thread_name("price sv thread");
             VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
-            using namespace std::literals;
             DVLOG_F(loguru::Verbosity_INFO, "%s", "fetching price begin");
+            auto last_fetch = std::chrono::steady_clock::now();
             auto json_data = this->fetch_all_price();
             {
                 std::scoped_lock lock(this->price_service_mutex_);
                 this->price_registry_ = json_data;
+                ++this->price_registry_version_;
             }
             DVLOG_F(loguru::Verbosity_INFO, "%s", "fetching price finished");
-            while(this->keep_thread_alive_) {
-                std::this_thread::sleep_for(30s);
+            while (this->keep_thread_alive_) {
+                {
+                    //! a reload changing the interval wakes the thread up, the next fetch is then rescheduled.
+                    std::unique_lock lock(this->price_service_mutex_);
+                    const auto interval = get_mmbot_config().price_poll_interval_ms;
+                    auto interrupted = [this, interval]() {
+                        return !this->keep_thread_alive_ || get_mmbot_config().price_poll_interval_ms != interval;
+                    };
+                    if (this->price_service_cv_.wait_until(lock, last_fetch + std::chrono::milliseconds{interval},
+                                                           interrupted)) {
+                        continue;
+                    }
+                }
                 DVLOG_F(loguru::Verbosity_INFO, "%s", "fetching price begin");
+                last_fetch = std::chrono::steady_clock::now();
                 json_data = this->fetch_all_price();
                 std::scoped_lock lock(this->price_service_mutex_);
                 this->price_registry_ = json_data;
+                ++this->price_registry_version_;
                 DVLOG_F(loguru::Verbosity_INFO, "%s", "fetching price finished");
             }
         });
@@ -156,4 +238,18 @@ namespace antara::mmbot
         return copy_json;
     }
 
-}
\ No newline at end of file
+    std::uint64_t price_service_platform::get_price_registry_version() const noexcept
+    {
+        return this->price_registry_version_.load();
+    }
+
+    void price_service_platform::add_price_observer(price_observer observer)
+    {
+        this->price_observers_.push_back(std::move(observer));
+    }
+
+    void price_service_platform::set_pair_filter(price_pair_filter filter)
+    {
+        this->pair_filter_ = std::move(filter);
+    }
+}
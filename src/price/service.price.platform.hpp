@@ -17,6 +17,8 @@
 #pragma once
 
 #include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <atomic>
 #include <thread>
 #include <algorithm>
@@ -24,32 +26,58 @@
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
+#include <taskflow/taskflow.hpp>
+#include "utils/antara.atomic.snapshot.hpp"
 #include "factory.price.platform.hpp"
 #include "abstract.price.platform.hpp"
 
 namespace antara::mmbot
 {
     using registry_price_result = std::unordered_map<antara::pair, st_price>;
+    using price_observer = std::function<void(const antara::pair &, st_price)>;
+    using price_pair_filter = std::function<bool(const antara::pair &)>;
 
     class price_service_platform
     {
     public:
         explicit price_service_platform() noexcept;
+        //! the prices come only from `platform`, e.g. the price feed of a shard coordinator, whatever the price
+        //! providers of the config are.
+        explicit price_service_platform(price_platform_ptr platform) noexcept;
         ~price_service_platform() noexcept;
         st_price get_price(antara::pair currency_pair) const;
         void enable_price_service_thread();
         nlohmann::json get_all_price_pairs_of_given_coin(const antara::asset &asset);
         nlohmann::json fetch_all_price();
         nlohmann::json get_price_registry() noexcept;
+        //! changes every time the price registry is replaced, read it before get_price_registry to cache the latter.
+        std::uint64_t get_price_registry_version() const noexcept;
+        //! called for every price computed by the price thread, must be added before the thread is enabled.
+        void add_price_observer(price_observer observer);
+        //! only the pairs accepted by `filter` are fetched by the price thread, must be set before it is enabled.
+        void set_pair_filter(price_pair_filter filter);
 
     private:
         using registry_platform_price = std::unordered_map<price_platform_name, price_platform_ptr>;
+
+        static registry_platform_price create_platforms(const config::price_infos_registry &price_registry);
+
+        void on_config_changed(const config &previous, const config &current);
+
         std::unordered_set<std::string> coins_to_track_{"BTC", "BCH", "DASH", "LTC", "DOGE", "QTUM", "DGB", "RVN",
                                                         "ETH", "USDC", "BAT", "KMD", "RFOX", "ZILLA", "VRSC"};
-        registry_platform_price registry_platform_price_{};
+        //! replaced when the price providers of the config change, get_price reads it without locking.
+        antara::atomic_snapshot<registry_platform_price> registry_platform_price_;
+        bool fixed_platform_{false};
+        std::size_t config_subscription_;
+        mutable tf::Executor executor_;
         std::thread price_service_fetcher_;
         std::atomic_bool keep_thread_alive_{true};
         std::mutex price_service_mutex_;
+        std::condition_variable price_service_cv_;
         nlohmann::json price_registry_;
+        std::atomic<std::uint64_t> price_registry_version_{0};
+        std::vector<price_observer> price_observers_;
+        price_pair_filter pair_filter_;
     };
 }
@@ -20,6 +20,18 @@
 
 namespace antara::mmbot::tests
 {
+    namespace
+    {
+        class fixed_price_platform final : public abstract_price_platform
+        {
+        public:
+            st_price get_price(antara::pair, std::size_t) const final
+            {
+                return st_price{42u};
+            }
+        };
+    }
+
     //! BDD
     SCENARIO("price service functionnality") {
         GIVEN("a price service with a good configuration") {
@@ -59,6 +71,24 @@ namespace antara::mmbot::tests
                 CHECK(price_service.get_price_registry().empty());
             }
         }
+        GIVEN("a price service with its own price platform") {
+            load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+            price_service_platform price_service{std::make_unique<fixed_price_platform>()};
+            antara::pair currency_pair{{st_symbol{"BTC"}},
+                                       {st_symbol{"KMD"}}};
+            THEN("the prices come from this platform whatever the price providers of the config") {
+                CHECK_EQ(42, price_service.get_price(currency_pair).value());
+                config cfg = get_mmbot_config();
+                cfg.price_registry.clear();
+                set_mmbot_config(cfg);
+                CHECK_EQ(42, price_service.get_price(currency_pair).value());
+            }
+            AND_THEN("the pairs rejected by the pair filter are not fetched") {
+                price_service.set_pair_filter([](const antara::pair &) { return false; });
+                auto json_result = price_service.get_all_price_pairs_of_given_coin(antara::asset{st_symbol{"KMD"}});
+                CHECK(json_result["KMD"].empty());
+            }
+        }
         GIVEN("a price service with a wrong configuration (bad endpoint)") {
             config cfg{};
             cfg.price_registry["coinpaprika"] = price_config{st_endpoint{"wrong"}};
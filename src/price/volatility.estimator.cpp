@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include "price/volatility.estimator.hpp"
+
+namespace
+{
+    using seconds = std::chrono::duration<double>;
+
+    double log_of(antara::st_price price) noexcept
+    {
+        return std::log(static_cast<double>(absl::Uint128High64(price.value())) * 18446744073709551616.0 +
+                        static_cast<double>(absl::Uint128Low64(price.value())));
+    }
+
+    void accumulate(std::optional<double> &average, double sample, double weight) noexcept
+    {
+        average = average.has_value() ? average.value() + weight * (sample - average.value()) : sample;
+    }
+}
+
+namespace antara::mmbot
+{
+    volatility_estimator::volatility_estimator(volatility_options options) noexcept : options_(options)
+    {
+    }
+
+    double volatility_estimator::weight_of(clock::duration elapsed) const noexcept
+    {
+        return 1.0 - std::exp2(-seconds(elapsed).count() / seconds(options_.half_life).count());
+    }
+
+    void volatility_estimator::on_price(st_price price, clock::time_point when) noexcept
+    {
+        if (price.value() == 0) {
+            return;
+        }
+        const auto log_price = log_of(price);
+        ++snapshot_.nb_ticks;
+        if (!last_log_price_.has_value()) {
+            last_log_price_ = log_price;
+            last_tick_ = when;
+            window_start_ = when;
+            window_high_ = window_low_ = log_price;
+            return;
+        }
+
+        //! two ticks at the same time count as one microsecond apart, the weight makes up for the large rate.
+        const auto elapsed = std::max<clock::duration>(when - last_tick_, std::chrono::microseconds{1});
+        const auto log_return = log_price - last_log_price_.value();
+        accumulate(ewma_variance_rate_, log_return * log_return / seconds(elapsed).count(), weight_of(elapsed));
+        last_log_price_ = log_price;
+        last_tick_ = std::max(when, last_tick_);
+
+        window_high_ = std::max(window_high_, log_price);
+        window_low_ = std::min(window_low_, log_price);
+        if (const auto window = when - window_start_; window >= options_.range_window) {
+            //! Parkinson: E[(ln H - ln L)^2] = 4 ln(2) variance.
+            const auto range = window_high_ - window_low_;
+            accumulate(range_variance_rate_, range * range / (4.0 * std::log(2.0)) / seconds(window).count(),
+                       weight_of(window));
+            window_start_ = when;
+            window_high_ = window_low_ = log_price;
+        }
+        update_snapshot();
+    }
+
+    void volatility_estimator::update_snapshot() noexcept
+    {
+        const auto horizon = seconds(options_.horizon).count();
+        auto to_volatility = [horizon](const std::optional<double> &variance_rate) -> std::optional<double> {
+            if (!variance_rate.has_value()) {
+                return std::nullopt;
+            }
+            return std::sqrt(variance_rate.value() * horizon);
+        };
+        snapshot_.ewma = to_volatility(ewma_variance_rate_);
+        snapshot_.range = to_volatility(range_variance_rate_);
+        if (snapshot_.ewma.has_value() && snapshot_.range.has_value()) {
+            snapshot_.volatility = (snapshot_.ewma.value() + snapshot_.range.value()) / 2.0;
+        } else {
+            snapshot_.volatility = snapshot_.ewma.has_value() ? snapshot_.ewma : snapshot_.range;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot
+{
+    struct volatility_options
+    {
+        //! half life of the exponentially weighted variances.
+        std::chrono::milliseconds half_life{300000};
+        //! duration of the high / low windows of the range estimate.
+        std::chrono::milliseconds range_window{60000};
+        //! the volatilities are expressed over this horizon.
+        std::chrono::milliseconds horizon{60000};
+    };
+
+    struct volatility_snapshot
+    {
+        //! standard deviation of the log returns over the horizon, from the squared returns.
+        std::optional<double> ewma;
+        //! same from the high / low range of the closed windows (Parkinson).
+        std::optional<double> range;
+        //! mean of the available estimates.
+        std::optional<double> volatility;
+        std::size_t nb_ticks{0};
+    };
+
+    /**
+     * @brief Realized volatility of one pair updated in O(1) on each price tick.
+     *        The squared log returns are divided by the time elapsed since the previous tick before being averaged,
+     *        so the estimate does not depend on how often the price is sampled, repeated prices included.
+     */
+    class volatility_estimator
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit volatility_estimator(volatility_options options = {}) noexcept;
+
+        //! a zero price is ignored.
+        void on_price(st_price price, clock::time_point when = clock::now()) noexcept;
+
+        [[nodiscard]] const volatility_snapshot &get() const noexcept
+        {
+            return snapshot_;
+        }
+
+    private:
+        [[nodiscard]] double weight_of(clock::duration elapsed) const noexcept;
+
+        void update_snapshot() noexcept;
+
+        volatility_options options_;
+        std::optional<double> last_log_price_;
+        clock::time_point last_tick_{};
+        //! variances per second.
+        std::optional<double> ewma_variance_rate_;
+        std::optional<double> range_variance_rate_;
+        clock::time_point window_start_{};
+        double window_high_{0};
+        double window_low_{0};
+        volatility_snapshot snapshot_;
+    };
+}
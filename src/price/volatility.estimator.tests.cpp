@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <cmath>
+#include <doctest/doctest.h>
+#include "price/volatility.estimator.hpp"
+
+namespace antara::mmbot::tests
+{
+    using namespace std::chrono_literals;
+
+    TEST_CASE ("volatility of a constant price is zero")
+    {
+        volatility_estimator estimator;
+        auto now = volatility_estimator::clock::now();
+        CHECK_FALSE(estimator.get().volatility.has_value());
+        estimator.on_price(st_price{1000}, now);
+        CHECK_FALSE(estimator.get().volatility.has_value());
+        for (int idx = 1; idx <= 120; ++idx) {
+            estimator.on_price(st_price{1000}, now + idx * 1s);
+        }
+        CHECK_EQ(121, estimator.get().nb_ticks);
+        CHECK_EQ(doctest::Approx(0.0), estimator.get().ewma.value());
+        CHECK_EQ(doctest::Approx(0.0), estimator.get().range.value());
+        CHECK_EQ(doctest::Approx(0.0), estimator.get().volatility.value());
+        estimator.on_price(st_price{0}, now + 121s);
+        CHECK_EQ(121, estimator.get().nb_ticks);
+    }
+
+    TEST_CASE ("volatility from the squared returns does not depend on the sampling")
+    {
+        volatility_options options;
+        options.horizon = 1s;
+        const double log_return = std::log(1.01);
+        auto now = volatility_estimator::clock::now();
+
+        volatility_estimator every_second(options);
+        for (int idx = 0; idx <= 600; ++idx) {
+            every_second.on_price(st_price{idx % 2 == 0 ? 10000u : 10100u}, now + idx * 1s);
+        }
+        CHECK_EQ(doctest::Approx(log_return), every_second.get().ewma.value());
+
+        //! the same prices polled every 250ms, three samples out of four are repeated.
+        volatility_estimator every_quarter(options);
+        for (int idx = 0; idx <= 2400; ++idx) {
+            every_quarter.on_price(st_price{(idx / 4) % 2 == 0 ? 10000u : 10100u}, now + idx * 250ms);
+        }
+        CHECK_EQ(doctest::Approx(log_return).epsilon(0.05), every_quarter.get().ewma.value());
+    }
+
+    TEST_CASE ("volatility from the high / low ranges")
+    {
+        volatility_options options;
+        options.range_window = 10s;
+        options.horizon = 10s;
+        auto now = volatility_estimator::clock::now();
+        volatility_estimator estimator(options);
+        for (int idx = 0; idx < 10; ++idx) {
+            estimator.on_price(st_price{idx % 2 == 0 ? 10000u : 10100u}, now + idx * 1s);
+        }
+        CHECK_FALSE(estimator.get().range.has_value());
+        estimator.on_price(st_price{10000}, now + 10s);
+        CHECK_EQ(doctest::Approx(std::log(1.01) / std::sqrt(4.0 * std::log(2.0))), estimator.get().range.value());
+        const auto &snapshot = estimator.get();
+        CHECK_EQ(doctest::Approx((snapshot.ewma.value() + snapshot.range.value()) / 2.0), snapshot.volatility.value());
+    }
+}
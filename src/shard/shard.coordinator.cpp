@@ -0,0 +1,311 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <filesystem>
+#include <future>
+#include <restclient-cpp/connection.h>
+#include <restclient-cpp/restclient.h>
+#include "http/http.server.hpp"
+#include "metrics/metrics.hpp"
+#include "shard.coordinator.hpp"
+
+namespace
+{
+    //! how often the coordinator looks for exited workers, also the shortest delay before one is launched again.
+    constexpr std::chrono::milliseconds worker_check_interval{1000};
+
+    //! a stopped or hung worker costs at most this much to the http requests that scrape it, in seconds.
+    constexpr int worker_scrape_timeout_s{1};
+
+    //! GET `route` on every worker at once, the answers are in the order of the workers.
+    std::vector<RestClient::Response> scrape_workers(const antara::mmbot::config &cfg, const std::string &route)
+    {
+        std::vector<std::future<RestClient::Response>> scrapes;
+        scrapes.reserve(cfg.shard.nb_workers);
+        for (std::size_t idx = 0; idx < cfg.shard.nb_workers; ++idx) {
+            auto base = "localhost:" + std::to_string(antara::mmbot::shard::worker_http_port(cfg, idx));
+            scrapes.push_back(std::async(std::launch::async, [base = std::move(base), &route]() {
+                RestClient::Connection connection(base);
+                connection.SetTimeout(worker_scrape_timeout_s);
+                return connection.get(route);
+            }));
+        }
+        std::vector<RestClient::Response> answers;
+        answers.reserve(scrapes.size());
+        for (auto &&scrape : scrapes) {
+            answers.push_back(scrape.get());
+        }
+        return answers;
+    }
+
+    //! the "BASE/QUOTE" keys of the price registry, grouped by the worker owning them.
+    std::vector<nlohmann::json> pairs_by_worker(const nlohmann::json &price_registry, const antara::mmbot::shard::ring &ring)
+    {
+        std::vector<nlohmann::json> pairs(ring.nb_workers(), nlohmann::json::array());
+        for (auto &&coin_prices : price_registry) {
+            for (auto &&[coin, prices] : coin_prices.items()) {
+                for (auto &&price : prices) {
+                    for (auto &&[key, value] : price.items()) {
+                        auto separator = key.find('/');
+                        if (separator == std::string::npos) {
+                            continue;
+                        }
+                        auto pair = antara::pair::of(key.substr(separator + 1), key.substr(0, separator));
+                        pairs[ring.owner(pair)].push_back(key);
+                    }
+                }
+            }
+        }
+        return pairs;
+    }
+}
+
+namespace antara::mmbot::shard
+{
+    unsigned short worker_http_port(const config &cfg, std::size_t worker) noexcept
+    {
+        return static_cast<unsigned short>(cfg.http_port + 1 + worker);
+    }
+
+    config worker_config(const config &cfg, std::size_t worker)
+    {
+        config result = cfg;
+        result.http_port = worker_http_port(cfg, worker);
+        if (worker < cfg.shard.mm2_endpoints.size()) {
+            result.mm2_endpoint = cfg.shard.mm2_endpoints[worker];
+        }
+        return result;
+    }
+
+    ring make_ring(const config &cfg)
+    {
+        return ring(cfg.shard.nb_workers, cfg.shard.virtual_nodes);
+    }
+
+    coordinator::coordinator(std::string executable) :
+            executable_(std::move(executable)), publisher_(get_mmbot_config().shard.price_socket_path)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+    }
+
+    coordinator::~coordinator() noexcept
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        http_workers_.stop();
+        config_watcher_.stop();
+        {
+            std::scoped_lock lock(workers_mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (supervisor_.joinable()) {
+            supervisor_.join();
+        }
+        for (auto &&current_worker : workers_) {
+            if (current_worker->process != nullptr) {
+                auto ec = current_worker->process->stop(reproc::cleanup::terminate, reproc::milliseconds(2000),
+                                                        reproc::cleanup::kill, reproc::infinite);
+                if (ec) {
+                    VLOG_F(loguru::Verbosity_ERROR, "shard worker %zu stop: %s", current_worker->index,
+                           ec.message().c_str());
+                }
+            }
+            if (current_worker->sink.joinable()) {
+                current_worker->sink.join();
+            }
+        }
+        publisher_.stop();
+    }
+
+    int coordinator::run()
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        //! held for the whole run of the coordinator.
+        const auto cfg_snapshot = get_mmbot_config_snapshot();
+        const auto &cfg = *cfg_snapshot;
+        VLOG_F(loguru::Verbosity_INFO, "coordinating %zu shard worker(s)", cfg.shard.nb_workers);
+        try {
+            //! a ring that can't be built would only fail later, in the http handlers.
+            make_ring(cfg);
+            publisher_.start();
+            price_service_.add_price_observer([this](const antara::pair &pair, st_price price) {
+                publisher_.publish(pair, price);
+            });
+            if (cfg.price_bus_path.has_value()) {
+                price_bus_ = std::make_unique<price_bus_writer>(cfg.price_bus_path.value(), cfg.price_bus_capacity);
+                price_service_.add_price_observer([bus = price_bus_.get()](const antara::pair &pair, st_price price) {
+                    bus->publish(pair, price);
+                });
+            }
+            price_service_.enable_price_service_thread();
+            {
+                std::scoped_lock lock(workers_mutex_);
+                for (std::size_t idx = 0; idx < cfg.shard.nb_workers; ++idx) {
+                    auto &current_worker = workers_.emplace_back(std::make_unique<worker>());
+                    current_worker->index = idx;
+                    launch(*current_worker);
+                }
+            }
+            supervisor_ = std::thread([this]() { supervise(); });
+            restinio::run(restinio::on_this_thread<http_server_traits>().port(cfg.http_port).address(
+                    "localhost").request_handler(create_routes()));
+        }
+        catch (const std::exception &e) {
+            VLOG_F(loguru::Verbosity_FATAL, "exception catch: %s", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    void coordinator::launch(worker &current_worker)
+    {
+        if (current_worker.sink.joinable()) {
+            current_worker.sink.join();
+        }
+        current_worker.process = std::make_unique<reproc::process>(reproc::cleanup::terminate,
+                                                                   reproc::milliseconds(2000),
+                                                                   reproc::cleanup::kill, reproc::infinite);
+        std::vector<std::string> args{executable_, "--shard-worker", std::to_string(current_worker.index)};
+        auto path = std::filesystem::current_path().string();
+        if (auto ec = current_worker.process->start(args, nullptr, path.c_str()); ec) {
+            VLOG_F(loguru::Verbosity_ERROR, "shard worker %zu not launched: %s", current_worker.index,
+                   ec.message().c_str());
+            return;
+        }
+        ++current_worker.nb_launches;
+        VLOG_F(loguru::Verbosity_INFO, "shard worker %zu launched", current_worker.index);
+        current_worker.sink = std::thread([process = current_worker.process.get()]() {
+            process->drain(reproc::stream::out, reproc::sink::discard());
+        });
+    }
+
+    bool coordinator::is_running(worker &current_worker)
+    {
+        return current_worker.process != nullptr &&
+               current_worker.process->wait(reproc::milliseconds(0)) == reproc::error::wait_timeout;
+    }
+
+    void coordinator::supervise()
+    {
+        loguru::set_thread_name("shard supervisor");
+        static auto &restarts = metrics::get_counter("mmbot_shard_worker_restarts_total");
+        std::unique_lock lock(workers_mutex_);
+        while (!cv_.wait_for(lock, worker_check_interval, [this]() { return stopped_; })) {
+            for (auto &&current_worker : workers_) {
+                if (!is_running(*current_worker)) {
+                    VLOG_F(loguru::Verbosity_WARNING, "shard worker %zu exited, launching it again",
+                           current_worker->index);
+                    restarts.inc();
+                    launch(*current_worker);
+                }
+            }
+        }
+    }
+
+    std::string coordinator::merged_metrics()
+    {
+        const auto &cfg = get_mmbot_config();
+        std::vector<metrics::labelled_exposition> expositions{
+                {metrics::label("shard", "coordinator"), metrics::get_registry().to_prometheus()}};
+        auto answers = scrape_workers(cfg, "/metrics");
+        for (std::size_t idx = 0; idx < answers.size(); ++idx) {
+            const auto shard_label = metrics::label("shard", std::to_string(idx));
+            auto &resp = answers[idx];
+            if (resp.code != 200) {
+                metrics::get_counter("mmbot_shard_scrape_failures_total", shard_label).inc();
+                continue;
+            }
+            expositions.push_back({shard_label, std::move(resp.body)});
+        }
+        return metrics::merge_prometheus(expositions);
+    }
+
+    nlohmann::json coordinator::shards_view()
+    {
+        const auto &cfg = get_mmbot_config();
+        auto pairs = pairs_by_worker(price_service_.get_price_registry(), make_ring(cfg));
+        nlohmann::json workers = nlohmann::json::array();
+        {
+            std::scoped_lock lock(workers_mutex_);
+            for (auto &&current_worker : workers_) {
+                const auto worker_cfg = worker_config(cfg, current_worker->index);
+                workers.push_back({{"index", current_worker->index},
+                                   {"http_port", worker_cfg.http_port},
+                                   {"mm2_endpoint", worker_cfg.mm2_endpoint.value_or("")},
+                                   {"running", is_running(*current_worker)},
+                                   {"nb_launches", current_worker->nb_launches},
+                                   {"pairs", pairs[current_worker->index]}});
+            }
+        }
+        const auto answers = scrape_workers(cfg, "/");
+        for (auto &&current_worker : workers) {
+            const auto idx = current_worker["index"].get<std::size_t>();
+            current_worker["reachable"] = idx < answers.size() && answers[idx].code == 200;
+        }
+        return {{"nb_workers", cfg.shard.nb_workers},
+                {"virtual_nodes", cfg.shard.virtual_nodes},
+                {"workers", workers}};
+    }
+
+    restinio::request_handling_status_t
+    coordinator::reply_later(const restinio::request_handle_t &req, std::function<void()> reply)
+    {
+        if (!http_workers_.post(std::move(reply))) {
+            return req->create_response(restinio::status_service_unavailable()).done();
+        }
+        return restinio::request_accepted();
+    }
+
+    std::unique_ptr<restinio::router::express_router_t<>> coordinator::create_routes()
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        using namespace restinio;
+        auto http_router = std::make_unique<restinio::router::express_router_t<>>();
+        http_router->http_get("/", [](const auto &req, const auto &) {
+            return req->create_response(status_ok()).set_body("Welcome.").done();
+        });
+
+        //! the workers are scraped off the server thread, which keeps answering the other routes meanwhile.
+        http_router->http_get("/metrics", [this](const auto &req, const auto &) {
+            return reply_later(req, [this, req]() {
+                req->create_response(status_ok()).append_header(http_field::content_type,
+                                                                "text/plain; version=0.0.4").set_body(
+                        merged_metrics()).done();
+            });
+        });
+
+        http_router->http_get("/api/v1/shards", [this](const auto &req, const auto &) {
+            return reply_later(req, [this, req]() {
+                req->create_response(status_ok()).append_header(http_field::content_type,
+                                                                "application/json").set_body(
+                        shards_view().dump()).done();
+            });
+        });
+
+        http_router->http_get("/api/v1/getallprice", [this](const auto &req, const auto &) {
+            auto all_prices = all_prices_body_.get(price_service_.get_price_registry_version(), [this]() {
+                return price_service_.get_price_registry().dump();
+            });
+            return http::reply_with_body(req, status_ok(), std::move(all_prices.body), all_prices.etag);
+        });
+
+        http_router->non_matched_request_handler(
+                [](auto req) {
+                    return req->create_response(status_not_found()).set_body("Not Found").done();
+                });
+        return http_router;
+    }
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <reproc++/reproc.hpp>
+#include <reproc++/sink.hpp>
+#include <restinio/all.hpp>
+#include "config/config.hpp"
+#include "config/config.watcher.hpp"
+#include "http/http.body.hpp"
+#include "price/price.bus.hpp"
+#include "price/service.price.platform.hpp"
+#include "shard/shard.price.feed.hpp"
+#include "shard/shard.ring.hpp"
+#include "utils/antara.worker.pool.hpp"
+
+namespace antara::mmbot::shard
+{
+    //! the worker of index `worker` listens on http_port + 1 + worker.
+    unsigned short worker_http_port(const config &cfg, std::size_t worker) noexcept;
+
+    //! `cfg` as seen by the worker of index `worker`: its own http port, and its own mm2 when one is configured.
+    config worker_config(const config &cfg, std::size_t worker);
+
+    //! the ring of the configured workers, every process of a deployment builds the same one.
+    ring make_ring(const config &cfg);
+
+    /**
+     * @brief Sharding mode of the bot: launches `shard.nb_workers` bot processes which quote the pairs the ring
+     *        gives them, each with its own mm2. The prices are fetched once, here, and published to the workers on
+     *        a unix socket. The http server merges the /metrics of the workers and lists them on /api/v1/shards.
+     *        A worker that exits is launched again.
+     */
+    class coordinator
+    {
+    public:
+        //! `executable` is the bot itself, started with `--shard-worker <index>`.
+        explicit coordinator(std::string executable);
+
+        ~coordinator() noexcept;
+
+        coordinator(const coordinator &) = delete;
+
+        coordinator &operator=(const coordinator &) = delete;
+
+        int run();
+
+        //! the exposition of the coordinator and of every worker reachable, labelled with `shard`. The workers are
+        //! scraped in parallel with a timeout.
+        std::string merged_metrics();
+
+        nlohmann::json shards_view();
+
+    private:
+        struct worker
+        {
+            std::size_t index;
+            std::unique_ptr<reproc::process> process;
+            std::thread sink;
+            std::size_t nb_launches{0};
+        };
+
+        void launch(worker &current_worker);
+
+        bool is_running(worker &current_worker);
+
+        void supervise();
+
+        std::unique_ptr<restinio::router::express_router_t<>> create_routes();
+
+        //! run `reply`, which completes `req`, on the http workers.
+        restinio::request_handling_status_t reply_later(const restinio::request_handle_t &req,
+                                                        std::function<void()> reply);
+
+        std::string executable_;
+        //! before the price service, whose thread publishes to them until the service is destroyed.
+        price_publisher publisher_;
+        std::unique_ptr<price_bus_writer> price_bus_;
+        price_service_platform price_service_;
+        http::versioned_body all_prices_body_;
+        std::mutex workers_mutex_;
+        std::vector<std::unique_ptr<worker>> workers_;
+        std::condition_variable cv_;
+        bool stopped_{false};
+        std::thread supervisor_;
+        config_watcher config_watcher_{std::filesystem::current_path() / "assets", "mmbot_config.json"};
+        //! the requests scraping the workers, stopped first.
+        antara::worker_pool http_workers_{2};
+    };
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <doctest/doctest.h>
+#include "metrics/metrics.hpp"
+#include "shard/shard.coordinator.hpp"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
+
+namespace antara::mmbot::shard::tests
+{
+    TEST_CASE ("shard workers get their own http port and mm2")
+    {
+        config cfg{};
+        cfg.http_port = 7777;
+        cfg.mm2_endpoint = "http://127.0.0.1:7783";
+        cfg.shard.nb_workers = 2;
+        cfg.shard.mm2_endpoints = {"http://127.0.0.1:7790"};
+
+        auto first = worker_config(cfg, 0);
+        CHECK_EQ(7778, first.http_port);
+        CHECK_EQ("http://127.0.0.1:7790", first.mm2_endpoint.value());
+        auto second = worker_config(cfg, 1);
+        CHECK_EQ(7779, second.http_port);
+        CHECK_EQ(7779, worker_http_port(cfg, 1));
+        CHECK_EQ(cfg.mm2_endpoint, second.mm2_endpoint);
+        CHECK_EQ(cfg.shard, second.shard);
+
+        CHECK_EQ(2, make_ring(cfg).nb_workers());
+        cfg.shard.virtual_nodes = 0;
+        CHECK_THROWS_AS(make_ring(cfg), std::invalid_argument);
+    }
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+
+    TEST_CASE ("the coordinator doesn't wait on a hung worker longer than the scrape timeout")
+    {
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        auto cfg = get_mmbot_config();
+        cfg.http_port = 7860;
+        cfg.shard.nb_workers = 2;
+        cfg.shard.price_socket_path = (std::filesystem::temp_directory_path() / "mmbot.coordinator.tests.sock").string();
+        set_mmbot_config(cfg);
+
+        //! the worker 0 accepts the connections but never answers, nothing listens for the worker 1.
+        int hung_worker = ::socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE_NE(-1, hung_worker);
+        int reuse = 1;
+        ::setsockopt(hung_worker, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(worker_http_port(cfg, 0));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE_EQ(0, ::bind(hung_worker, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+        REQUIRE_EQ(0, ::listen(hung_worker, 4));
+        {
+            auto &hung_failures = metrics::get_counter("mmbot_shard_scrape_failures_total",
+                                                       metrics::label("shard", "0"));
+            auto &down_failures = metrics::get_counter("mmbot_shard_scrape_failures_total",
+                                                       metrics::label("shard", "1"));
+            const auto nb_hung_failures = hung_failures.value();
+            const auto nb_down_failures = down_failures.value();
+            coordinator shards("mmbot");
+            const auto start = std::chrono::steady_clock::now();
+            static_cast<void>(shards.merged_metrics());
+            CHECK_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{3});
+            CHECK_EQ(nb_hung_failures + 1, hung_failures.value());
+            CHECK_EQ(nb_down_failures + 1, down_failures.value());
+        }
+        ::close(hung_worker);
+        load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+    }
+
+#endif
+}
@@ -0,0 +1,385 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+#include <loguru.hpp>
+#include "metrics/metrics.hpp"
+#include "utils/exceptions.hpp"
+#include "shard.price.feed.hpp"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define MMBOT_HAS_UNIX_SOCKET 1
+#endif
+
+namespace
+{
+    using antara::mmbot::shard::price_record;
+
+    static_assert(std::is_trivially_copyable_v<price_record> && sizeof(price_record) == 48,
+                  "price records are sent as they are in memory");
+
+    //! how long a blocked accept or read waits before looking at the stop flag.
+    constexpr int stop_poll_timeout_ms = 100;
+
+    //! the snapshot of a joining subscriber is sent this many bytes at a time.
+    constexpr std::size_t snapshot_chunk_size = 64 * 1024;
+
+    //! a joining subscriber that hasn't read its snapshot by then is disconnected.
+    constexpr std::chrono::seconds snapshot_timeout{5};
+
+    bool copy_symbol(const std::string &symbol, std::array<char, 16> &destination) noexcept
+    {
+        if (symbol.size() >= destination.size()) {
+            return false;
+        }
+        std::copy(begin(symbol), end(symbol), begin(destination));
+        return true;
+    }
+
+#ifdef MMBOT_HAS_UNIX_SOCKET
+    std::optional<sockaddr_un> unix_address(const std::string &path) noexcept
+    {
+        sockaddr_un address{};
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            return std::nullopt;
+        }
+        address.sun_family = AF_UNIX;
+        std::copy(begin(path), end(path), address.sun_path);
+        return address;
+    }
+
+    //! never blocks: false when the subscriber is gone or its socket buffer is full.
+    bool send_records(int fd, const price_record *records, std::size_t nb_records) noexcept
+    {
+        int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+        flags |= MSG_NOSIGNAL;
+#endif
+        const auto size = nb_records * sizeof(price_record);
+        return ::send(fd, records, size, flags) == static_cast<ssize_t>(size);
+    }
+
+    //! waits for the subscriber to read, false when it is gone, too slow for the deadline or the feed is stopped.
+    bool send_all_records(int fd, const std::vector<price_record> &records,
+                          std::chrono::steady_clock::time_point deadline, const std::atomic_bool &stopped) noexcept
+    {
+        int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+        flags |= MSG_NOSIGNAL;
+#endif
+        //! a record may be split between two sends, the subscriber puts it back together.
+        const auto *bytes = reinterpret_cast<const char *>(records.data());
+        const auto size = records.size() * sizeof(price_record);
+        std::size_t offset = 0;
+        pollfd writable{fd, POLLOUT, 0};
+        while (offset < size) {
+            if (stopped || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            auto nb_sent = ::send(fd, bytes + offset, std::min(size - offset, snapshot_chunk_size), flags);
+            if (nb_sent > 0) {
+                offset += static_cast<std::size_t>(nb_sent);
+            } else if (nb_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                ::poll(&writable, 1, stop_poll_timeout_ms);
+            } else if (nb_sent == 0 || errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+}
+
+namespace antara::mmbot::shard
+{
+    std::optional<price_record> make_price_record(const antara::pair &pair, st_price price) noexcept
+    {
+        price_record record;
+        if (!copy_symbol(pair.base.symbol.value(), record.base) ||
+            !copy_symbol(pair.quote.symbol.value(), record.quote)) {
+            return std::nullopt;
+        }
+        record.price_high = absl::Uint128High64(price.value());
+        record.price_low = absl::Uint128Low64(price.value());
+        return record;
+    }
+
+    antara::pair pair_of(const price_record &record)
+    {
+        return antara::pair{asset{st_symbol{std::string(record.quote.data())}},
+                            asset{st_symbol{std::string(record.base.data())}}};
+    }
+
+    st_price price_of(const price_record &record) noexcept
+    {
+        return st_price{absl::MakeUint128(record.price_high, record.price_low)};
+    }
+
+    price_publisher::price_publisher(std::string socket_path) : socket_path_(std::move(socket_path))
+    {
+    }
+
+    price_publisher::~price_publisher() noexcept
+    {
+        stop();
+    }
+
+    void price_publisher::start()
+    {
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        auto address = unix_address(socket_path_);
+        if (!address.has_value()) {
+            throw std::system_error(std::make_error_code(std::errc::filename_too_long), socket_path_);
+        }
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "price feed socket");
+        }
+        //! a socket file left by a coordinator that crashed would make bind fail.
+        ::unlink(socket_path_.c_str());
+        if (::bind(listen_fd_, reinterpret_cast<const sockaddr *>(&address.value()), sizeof(sockaddr_un)) != 0 ||
+            ::listen(listen_fd_, SOMAXCONN) != 0) {
+            auto error = errno;
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            throw std::system_error(error, std::generic_category(), "price feed on " + socket_path_);
+        }
+        stopped_ = false;
+        thread_ = std::thread([this]() { run(); });
+#else
+        throw errors::not_implemented("the shard price feed needs unix sockets");
+#endif
+    }
+
+    void price_publisher::stop() noexcept
+    {
+        stopped_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        std::scoped_lock lock(mutex_);
+        for (auto fd : subscribers_) {
+            ::close(fd);
+        }
+        subscribers_.clear();
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            ::unlink(socket_path_.c_str());
+        }
+#endif
+    }
+
+    void price_publisher::run()
+    {
+        loguru::set_thread_name("shard price feed");
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        pollfd listening{listen_fd_, POLLIN, 0};
+        while (!stopped_) {
+            if (::poll(&listening, 1, stop_poll_timeout_ms) > 0 && (listening.revents & POLLIN) != 0) {
+                accept_subscriber();
+            }
+        }
+#endif
+    }
+
+    void price_publisher::accept_subscriber()
+    {
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            VLOG_F(loguru::Verbosity_WARNING, "price feed accept failed: %s", std::strerror(errno));
+            return;
+        }
+        //! the snapshot goes out off the lock, the prices published meanwhile wait in the backlog of the subscriber.
+        std::vector<price_record> pending;
+        {
+            std::scoped_lock lock(mutex_);
+            pending.reserve(latest_.size());
+            for (auto &&[pair, record] : latest_) {
+                pending.push_back(record);
+            }
+            joining_.insert_or_assign(fd, std::vector<price_record>{});
+        }
+        const auto deadline = std::chrono::steady_clock::now() + snapshot_timeout;
+        std::size_t nb_subscribers = 0;
+        while (true) {
+            const bool sent = send_all_records(fd, pending, deadline, stopped_);
+            std::scoped_lock lock(mutex_);
+            auto backlog = joining_.find(fd);
+            if (!sent) {
+                joining_.erase(backlog);
+                ::close(fd);
+                VLOG_F(loguru::Verbosity_WARNING, "price feed subscriber left before its snapshot");
+                return;
+            }
+            if (backlog->second.empty()) {
+                joining_.erase(backlog);
+                subscribers_.push_back(fd);
+                nb_subscribers = subscribers_.size();
+                break;
+            }
+            pending = std::move(backlog->second);
+            backlog->second.clear();
+        }
+        VLOG_F(loguru::Verbosity_INFO, "price feed subscriber joined, %zu subscriber(s)", nb_subscribers);
+#endif
+    }
+
+    void price_publisher::publish(const antara::pair &pair, st_price price)
+    {
+        auto record = make_price_record(pair, price);
+        if (!record.has_value()) {
+            VLOG_F(loguru::Verbosity_WARNING, "%s/%s can't be published, a symbol is too long",
+                   pair.base.symbol.value().c_str(), pair.quote.symbol.value().c_str());
+            return;
+        }
+        static auto &published = metrics::get_counter("mmbot_shard_prices_published_total");
+        static auto &dropped = metrics::get_counter("mmbot_shard_subscribers_dropped_total");
+        std::scoped_lock lock(mutex_);
+        latest_.insert_or_assign(pair, record.value());
+        published.inc();
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        for (auto &&[fd, backlog] : joining_) {
+            backlog.push_back(record.value());
+        }
+        auto lagging = std::remove_if(begin(subscribers_), end(subscribers_), [&record](int fd) {
+            if (send_records(fd, &record.value(), 1)) {
+                return false;
+            }
+            ::close(fd);
+            return true;
+        });
+        if (lagging != end(subscribers_)) {
+            dropped.inc(static_cast<std::uint64_t>(std::distance(lagging, end(subscribers_))));
+            subscribers_.erase(lagging, end(subscribers_));
+            VLOG_F(loguru::Verbosity_WARNING, "price feed dropped subscriber(s), %zu left", subscribers_.size());
+        }
+#endif
+    }
+
+    std::size_t price_publisher::nb_subscribers() const
+    {
+        std::scoped_lock lock(mutex_);
+        return subscribers_.size();
+    }
+
+    price_subscriber::price_subscriber(std::string socket_path, std::chrono::milliseconds reconnect_interval) :
+            socket_path_(std::move(socket_path)), reconnect_interval_(reconnect_interval)
+    {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    price_subscriber::~price_subscriber() noexcept
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    st_price price_subscriber::get_price(antara::pair currency_pair, std::size_t) const
+    {
+        std::scoped_lock lock(mutex_);
+        if (auto price = prices_.find(currency_pair); price != prices_.end()) {
+            return price->second;
+        }
+        return st_price{0u};
+    }
+
+    bool price_subscriber::is_connected() const noexcept
+    {
+        return connected_;
+    }
+
+    void price_subscriber::run()
+    {
+        loguru::set_thread_name("shard price sub");
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        auto address = unix_address(socket_path_);
+        if (!address.has_value()) {
+            VLOG_F(loguru::Verbosity_ERROR, "price feed socket path too long: %s", socket_path_.c_str());
+            return;
+        }
+        while (!stopped_) {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr *>(&address.value()), sizeof(sockaddr_un)) == 0) {
+                VLOG_F(loguru::Verbosity_INFO, "connected to the price feed on %s", socket_path_.c_str());
+                connected_ = true;
+                read_prices(fd);
+                connected_ = false;
+                VLOG_F(loguru::Verbosity_WARNING, "disconnected from the price feed on %s", socket_path_.c_str());
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            std::unique_lock lock(mutex_);
+            cv_.wait_for(lock, reconnect_interval_, [this]() { return stopped_.load(); });
+        }
+#endif
+    }
+
+    void price_subscriber::read_prices([[maybe_unused]] int fd)
+    {
+#ifdef MMBOT_HAS_UNIX_SOCKET
+        static auto &received = metrics::get_counter("mmbot_shard_prices_received_total");
+        //! the stream may split a record, the bytes of an incomplete one are kept for the next read.
+        std::array<char, sizeof(price_record) * 256> buffer{};
+        std::size_t buffered = 0;
+        pollfd readable{fd, POLLIN, 0};
+        while (!stopped_) {
+            if (::poll(&readable, 1, stop_poll_timeout_ms) <= 0) {
+                continue;
+            }
+            auto nb_read = ::recv(fd, buffer.data() + buffered, buffer.size() - buffered, 0);
+            if (nb_read <= 0) {
+                return;
+            }
+            buffered += static_cast<std::size_t>(nb_read);
+            const auto nb_records = buffered / sizeof(price_record);
+            {
+                std::scoped_lock lock(mutex_);
+                for (std::size_t idx = 0; idx < nb_records; ++idx) {
+                    price_record record;
+                    std::memcpy(&record, buffer.data() + idx * sizeof(price_record), sizeof(price_record));
+                    record.base.back() = '\0';
+                    record.quote.back() = '\0';
+                    prices_.insert_or_assign(pair_of(record), price_of(record));
+                }
+            }
+            received.inc(nb_records);
+            const auto consumed = nb_records * sizeof(price_record);
+            std::memmove(buffer.data(), buffer.data() + consumed, buffered - consumed);
+            buffered -= consumed;
+        }
+#endif
+    }
+}
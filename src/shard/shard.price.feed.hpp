@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "price/abstract.price.platform.hpp"
+
+namespace antara::mmbot::shard
+{
+    //! one price on the socket, the symbols are nul padded so they are at most 15 characters.
+    struct price_record
+    {
+        std::array<char, 16> base{};
+        std::array<char, 16> quote{};
+        std::uint64_t price_high{0};
+        std::uint64_t price_low{0};
+    };
+
+    //! std::nullopt when a symbol is too long for the record.
+    std::optional<price_record> make_price_record(const antara::pair &pair, st_price price) noexcept;
+
+    antara::pair pair_of(const price_record &record);
+
+    st_price price_of(const price_record &record) noexcept;
+
+    /**
+     * @brief Coordinator side of the price feed: accepts the workers on a unix socket and sends them every price
+     *        published. A worker first receives the latest price of every pair, in pieces it is given a few
+     *        seconds to read, then every price published meanwhile. A worker that can't keep up afterwards is
+     *        disconnected and gets them again when it reconnects.
+     */
+    class price_publisher
+    {
+    public:
+        explicit price_publisher(std::string socket_path);
+
+        ~price_publisher() noexcept;
+
+        price_publisher(const price_publisher &) = delete;
+
+        price_publisher &operator=(const price_publisher &) = delete;
+
+        //! listen and accept the workers on the publisher thread, throws std::system_error if the socket can't be bound.
+        void start();
+
+        void stop() noexcept;
+
+        //! thread safe, e.g. from the price observer of the price service.
+        void publish(const antara::pair &pair, st_price price);
+
+        [[nodiscard]] std::size_t nb_subscribers() const;
+
+    private:
+        void run();
+
+        void accept_subscriber();
+
+        std::string socket_path_;
+        int listen_fd_{-1};
+        mutable std::mutex mutex_;
+        std::vector<int> subscribers_;
+        //! the subscribers still reading their snapshot, with the prices published since they joined.
+        std::unordered_map<int, std::vector<price_record>> joining_;
+        std::unordered_map<antara::pair, price_record> latest_;
+        std::atomic_bool stopped_{false};
+        std::thread thread_;
+    };
+
+    /**
+     * @brief Worker side of the price feed, a price platform answering from the latest price received. The prices
+     *        are read on the subscriber thread, which reconnects every `reconnect_interval` while the coordinator
+     *        is away. A pair not received yet has a price of 0, like a pair missing from a price api.
+     */
+    class price_subscriber final : public abstract_price_platform
+    {
+    public:
+        explicit price_subscriber(std::string socket_path,
+                                  std::chrono::milliseconds reconnect_interval = std::chrono::milliseconds{100});
+
+        ~price_subscriber() noexcept final;
+
+        price_subscriber(const price_subscriber &) = delete;
+
+        price_subscriber &operator=(const price_subscriber &) = delete;
+
+        [[nodiscard]] st_price get_price(antara::pair currency_pair, std::size_t nb_try_in_a_row) const final;
+
+        [[nodiscard]] bool is_connected() const noexcept;
+
+    private:
+        void run();
+
+        //! read until the coordinator goes away or the subscriber is stopped.
+        void read_prices(int fd);
+
+        std::string socket_path_;
+        std::chrono::milliseconds reconnect_interval_;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::unordered_map<antara::pair, st_price> prices_;
+        std::atomic_bool connected_{false};
+        std::atomic_bool stopped_{false};
+        std::thread thread_;
+    };
+}
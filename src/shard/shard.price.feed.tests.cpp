@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <doctest/doctest.h>
+#include "shard/shard.price.feed.hpp"
+
+namespace antara::mmbot::shard::tests
+{
+    namespace
+    {
+        bool wait_until(const std::function<bool()> &condition)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (!condition()) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{5});
+            }
+            return true;
+        }
+    }
+
+    TEST_CASE ("price records keep the pair and the whole 128 bits price")
+    {
+        const auto pair = antara::pair::of("BTC", "KMD");
+        const st_price price{absl::MakeUint128(3, 42)};
+        auto record = make_price_record(pair, price);
+        REQUIRE(record.has_value());
+        CHECK_EQ(pair, pair_of(record.value()));
+        CHECK_EQ(price, price_of(record.value()));
+        CHECK_FALSE(make_price_record(antara::pair::of("BTC", "SIXTEEN_CHARS_XX"), price).has_value());
+    }
+
+    TEST_CASE ("price subscriber receives the latest prices, then every price published")
+    {
+        const std::string socket_path = "mmbot.tests.prices.sock";
+        const auto kmd_btc = antara::pair::of("BTC", "KMD");
+        const auto rick_morty = antara::pair::of("MORTY", "RICK");
+        price_publisher publisher(socket_path);
+        publisher.start();
+        publisher.publish(kmd_btc, st_price{100u});
+        publisher.publish(kmd_btc, st_price{120u});
+
+        price_subscriber subscriber(socket_path, std::chrono::milliseconds{10});
+        CHECK(wait_until([&subscriber, &kmd_btc]() { return subscriber.get_price(kmd_btc, 0) == st_price{120u}; }));
+        CHECK(subscriber.is_connected());
+        CHECK_EQ(1, publisher.nb_subscribers());
+        CHECK_EQ(st_price{0u}, subscriber.get_price(rick_morty, 0));
+
+        publisher.publish(rick_morty, st_price{7u});
+        CHECK(wait_until([&subscriber, &rick_morty]() { return subscriber.get_price(rick_morty, 0) == st_price{7u}; }));
+
+        SUBCASE ("the subscriber reconnects to a restarted coordinator") {
+            publisher.stop();
+            CHECK(wait_until([&subscriber]() { return !subscriber.is_connected(); }));
+            price_publisher restarted(socket_path);
+            restarted.start();
+            restarted.publish(kmd_btc, st_price{130u});
+            CHECK(wait_until([&subscriber, &kmd_btc]() { return subscriber.get_price(kmd_btc, 0) == st_price{130u}; }));
+            CHECK_EQ(st_price{7u}, subscriber.get_price(rick_morty, 0));
+        }
+    }
+
+    TEST_CASE ("a snapshot larger than the socket buffer reaches the subscriber")
+    {
+        const std::string socket_path = "mmbot.tests.snapshot.sock";
+        constexpr std::size_t nb_pairs = 20000;
+        price_publisher publisher(socket_path);
+        publisher.start();
+        for (std::size_t idx = 0; idx < nb_pairs; ++idx) {
+            publisher.publish(antara::pair::of("KMD", "C" + std::to_string(idx)), st_price{idx + 1});
+        }
+
+        price_subscriber subscriber(socket_path, std::chrono::milliseconds{10});
+        const auto last_pair = antara::pair::of("KMD", "C" + std::to_string(nb_pairs - 1));
+        const st_price last_price{nb_pairs};
+        CHECK(wait_until([&subscriber, &last_pair, &last_price]() {
+            return subscriber.get_price(last_pair, 0) == last_price;
+        }));
+        CHECK(wait_until([&publisher]() { return publisher.nb_subscribers() == 1; }));
+        CHECK_EQ(st_price{1u}, subscriber.get_price(antara::pair::of("KMD", "C0"), 0));
+    }
+}
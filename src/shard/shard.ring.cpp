@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "shard.ring.hpp"
+
+namespace
+{
+    //! FNV-1a spreads close keys badly, the splitmix64 finalizer mixes every bit of it.
+    std::uint64_t mix(std::uint64_t value) noexcept
+    {
+        value ^= value >> 30u;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27u;
+        value *= 0x94d049bb133111ebull;
+        value ^= value >> 31u;
+        return value;
+    }
+}
+
+namespace antara::mmbot::shard
+{
+    std::uint64_t stable_hash(std::string_view data) noexcept
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (auto cur_char : data) {
+            hash ^= static_cast<unsigned char>(cur_char);
+            hash *= 0x100000001b3ull;
+        }
+        return mix(hash);
+    }
+
+    ring::ring(std::size_t nb_workers, std::size_t virtual_nodes) : nb_workers_(nb_workers)
+    {
+        if (nb_workers == 0 || virtual_nodes == 0) {
+            throw std::invalid_argument("the shard ring needs at least one worker and one virtual node");
+        }
+        points_.reserve(nb_workers * virtual_nodes);
+        for (std::size_t worker = 0; worker < nb_workers; ++worker) {
+            for (std::size_t node = 0; node < virtual_nodes; ++node) {
+                points_.emplace_back(stable_hash("worker-" + std::to_string(worker) + "#" + std::to_string(node)),
+                                     worker);
+            }
+        }
+        std::sort(begin(points_), end(points_));
+    }
+
+    std::size_t ring::owner(const antara::pair &pair) const noexcept
+    {
+        const auto &base = pair.base.symbol.value();
+        const auto &quote = pair.quote.symbol.value();
+        const auto hash = stable_hash(base < quote ? base + "/" + quote : quote + "/" + base);
+        auto point = std::lower_bound(begin(points_), end(points_), hash,
+                                      [](const auto &cur_point, std::uint64_t value) {
+                                          return cur_point.first < value;
+                                      });
+        return point == end(points_) ? points_.front().second : point->second;
+    }
+
+    bool ring::owns(std::size_t worker, const antara::pair &pair) const noexcept
+    {
+        return owner(pair) == worker;
+    }
+
+    std::size_t ring::nb_workers() const noexcept
+    {
+        return nb_workers_;
+    }
+}
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "utils/mmbot_strong_types.hpp"
+
+namespace antara::mmbot::shard
+{
+    //! 64 bits hash that is the same in every process and build, unlike std::hash.
+    std::uint64_t stable_hash(std::string_view data) noexcept;
+
+    /**
+     * @brief Consistent hash ring assigning the pairs to the workers. Each worker has `virtual_nodes` points on the
+     *        ring and a pair belongs to the first point at or after its hash, so adding a worker only moves the pairs
+     *        it takes over. Both directions of a pair belong to the same worker, they quote the same mm2 orderbook.
+     */
+    class ring
+    {
+    public:
+        explicit ring(std::size_t nb_workers, std::size_t virtual_nodes = 64);
+
+        [[nodiscard]] std::size_t owner(const antara::pair &pair) const noexcept;
+
+        [[nodiscard]] bool owns(std::size_t worker, const antara::pair &pair) const noexcept;
+
+        [[nodiscard]] std::size_t nb_workers() const noexcept;
+
+    private:
+        //! (point, worker) sorted by point.
+        std::vector<std::pair<std::uint64_t, std::size_t>> points_;
+        std::size_t nb_workers_;
+    };
+}
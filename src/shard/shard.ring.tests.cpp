@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <array>
+#include <string>
+#include <vector>
+#include <doctest/doctest.h>
+#include "shard/shard.ring.hpp"
+
+namespace antara::mmbot::shard::tests
+{
+    namespace
+    {
+        std::vector<antara::pair> make_pairs(std::size_t nb_pairs)
+        {
+            std::vector<antara::pair> pairs;
+            for (std::size_t idx = 0; idx < nb_pairs; ++idx) {
+                pairs.push_back(antara::pair::of("COIN" + std::to_string(idx), "KMD"));
+            }
+            return pairs;
+        }
+    }
+
+    TEST_CASE ("shard ring gives every pair to one worker, the same in both directions")
+    {
+        CHECK_THROWS_AS(ring(0), std::invalid_argument);
+        CHECK_THROWS_AS(ring(2, 0), std::invalid_argument);
+
+        ring shards(3);
+        ring same_shards(3);
+        CHECK_EQ(3, shards.nb_workers());
+        for (auto &&pair : make_pairs(100)) {
+            auto owner = shards.owner(pair);
+            CHECK_LT(owner, 3);
+            CHECK_EQ(owner, same_shards.owner(pair));
+            CHECK_EQ(owner, shards.owner(antara::pair{pair.base, pair.quote}));
+            CHECK(shards.owns(owner, pair));
+            CHECK_FALSE(shards.owns((owner + 1) % 3, pair));
+        }
+        CHECK_EQ(stable_hash("KMD/BTC"), stable_hash("KMD/BTC"));
+        CHECK_NE(stable_hash("KMD/BTC"), stable_hash("KMD/BTD"));
+    }
+
+    TEST_CASE ("shard ring spreads the pairs and adding a worker only moves the pairs it takes")
+    {
+        const auto pairs = make_pairs(4000);
+        ring four(4);
+        ring five(5);
+        std::array<std::size_t, 4> per_worker{};
+        std::size_t moved = 0;
+        for (auto &&pair : pairs) {
+            ++per_worker[four.owner(pair)];
+            if (four.owner(pair) != five.owner(pair)) {
+                CHECK_EQ(4, five.owner(pair));
+                ++moved;
+            }
+        }
+        for (auto nb_pairs : per_worker) {
+            CHECK_GT(nb_pairs, 600);
+            CHECK_LT(nb_pairs, 1400);
+        }
+        CHECK_GT(moved, 400);
+        CHECK_LT(moved, 1400);
+    }
+}
@@ -0,0 +1,307 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include "matching.engine.hpp"
+
+namespace
+{
+    constexpr const double g_quantity_epsilon = 1e-12;
+}
+
+namespace antara::mmbot::simulation
+{
+    matching_engine::matching_engine(latency_model latency, fill_model fill, std::uint64_t seed) noexcept :
+            latency_(latency), fill_(fill), rng_(seed)
+    {
+    }
+
+    orders::order &matching_engine::submit(const antara::pair &pair, const orders::order_level &ol)
+    {
+        if (ol.side == antara::side::both) {
+            throw std::invalid_argument("a single order cannot be placed on both sides");
+        }
+        auto id = st_order_id{"sim-" + std::to_string(next_order_id_++)};
+        auto o = orders::order_builder(id, pair)
+                .price(ol.price)
+                .quantity(ol.quantity)
+                .side(ol.side)
+                .status(orders::order_status::pending)
+                .build();
+        orders_.emplace(id, std::move(o));
+        unfinished_by_pair_[pair].insert(id);
+        ++stats_.nb_orders_placed;
+        schedule(event_kind::activate, id, latency_.place_latency);
+        process_due_events();
+        return orders_.at(id);
+    }
+
+    bool matching_engine::cancel(const st_order_id &id)
+    {
+        auto it = orders_.find(id);
+        if (it == orders_.end() || it->second.finished()) {
+            return false;
+        }
+        schedule(event_kind::cancel, id, latency_.cancel_latency);
+        process_due_events();
+        return true;
+    }
+
+    std::vector<st_order_id> matching_engine::cancel_all(const antara::pair &pair)
+    {
+        std::vector<st_order_id> cancelled;
+        auto it = unfinished_by_pair_.find(pair);
+        if (it == unfinished_by_pair_.end()) {
+            return cancelled;
+        }
+        //! the cancels are processed after the loop, a zero latency would erase from the set being iterated.
+        cancelled.assign(it->second.begin(), it->second.end());
+        for (auto &&id : cancelled) {
+            schedule(event_kind::cancel, id, latency_.cancel_latency);
+        }
+        process_due_events();
+        return cancelled;
+    }
+
+    std::vector<orders::execution>
+    matching_engine::take(const antara::pair &pair, antara::side side, st_price limit, st_quantity quantity)
+    {
+        auto book_it = books_.find(pair);
+        if (book_it == books_.end()) {
+            return {};
+        }
+        if (fill_.fill_probability < 1.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng_) >= fill_.fill_probability) {
+            return {};
+        }
+        auto first_new = executions_.size();
+        const auto limit_value = limit.value();
+        if (side == antara::side::buy) {
+            match(book_it->second.asks, [limit_value](const absl::uint128 &p) { return p <= limit_value; },
+                  quantity.value(), nullptr, fill_.max_fill_ratio);
+        } else if (side == antara::side::sell) {
+            match(book_it->second.bids, [limit_value](const absl::uint128 &p) { return p >= limit_value; },
+                  quantity.value(), nullptr, fill_.max_fill_ratio);
+        }
+        return std::vector<orders::execution>(executions_.begin() + first_new, executions_.end());
+    }
+
+    void matching_engine::advance(sim_duration duration)
+    {
+        const auto target = now_ + duration;
+        while (!events_.empty() && events_.top().at <= target) {
+            now_ = std::max(now_, events_.top().at);
+            process_due_events();
+        }
+        now_ = target;
+    }
+
+    sim_time_point matching_engine::now() const noexcept
+    {
+        return now_;
+    }
+
+    const orders::order &matching_engine::get_order(const st_order_id &id) const
+    {
+        return orders_.at(id);
+    }
+
+    std::vector<orders::order> matching_engine::get_live_orders() const
+    {
+        std::vector<orders::order> live;
+        for (auto &&[id, o] : orders_) {
+            if (o.status == orders::order_status::live || o.status == orders::order_status::partially_filled) {
+                live.push_back(o);
+            }
+        }
+        return live;
+    }
+
+    const std::vector<orders::execution> &matching_engine::get_executions() const noexcept
+    {
+        return executions_;
+    }
+
+    std::vector<orders::execution> matching_engine::get_executions(const st_order_id &id) const
+    {
+        std::vector<orders::execution> result;
+        if (auto it = executions_by_order_.find(id); it != executions_by_order_.end()) {
+            result.reserve(it->second.size());
+            for (auto idx : it->second) {
+                result.push_back(executions_[idx]);
+            }
+        }
+        return result;
+    }
+
+    std::vector<orders::execution> matching_engine::drain_recent_executions()
+    {
+        std::vector<orders::execution> recent;
+        recent.swap(recent_executions_);
+        return recent;
+    }
+
+    std::optional<st_price> matching_engine::best_bid(const antara::pair &pair) const
+    {
+        auto it = books_.find(pair);
+        if (it == books_.end() || it->second.bids.empty()) {
+            return std::nullopt;
+        }
+        return st_price{it->second.bids.begin()->first};
+    }
+
+    std::optional<st_price> matching_engine::best_ask(const antara::pair &pair) const
+    {
+        auto it = books_.find(pair);
+        if (it == books_.end() || it->second.asks.empty()) {
+            return std::nullopt;
+        }
+        return st_price{it->second.asks.begin()->first};
+    }
+
+    const engine_stats &matching_engine::get_stats() const noexcept
+    {
+        return stats_;
+    }
+
+    void matching_engine::schedule(event_kind kind, const st_order_id &id, sim_duration base_latency)
+    {
+        auto latency = base_latency;
+        if (latency_.jitter.count() > 0) {
+            latency += sim_duration{
+                    std::uniform_int_distribution<sim_duration::rep>(0, latency_.jitter.count())(rng_)};
+        }
+        events_.push(event{now_ + latency, next_sequence_++, kind, id});
+    }
+
+    void matching_engine::process_due_events()
+    {
+        while (!events_.empty() && events_.top().at <= now_) {
+            auto current = events_.top();
+            events_.pop();
+            switch (current.kind) {
+                case event_kind::activate:
+                    activate(current.id);
+                    break;
+                case event_kind::cancel: {
+                    auto &o = orders_.at(current.id);
+                    if (!o.finished() &&
+                        o.change_status(orders::order_status_change{o.id, orders::order_status::cancelled})) {
+                        remove_from_book(o);
+                        unfinished_by_pair_[o.pair].erase(o.id);
+                        ++stats_.nb_orders_cancelled;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void matching_engine::activate(const st_order_id &id)
+    {
+        auto &o = orders_.at(id);
+        if (o.status != orders::order_status::pending) {
+            return;
+        }
+        o.status = orders::order_status::live;
+        auto &current_book = books_[o.pair];
+        const auto limit_value = o.price.value();
+        double remaining = o.quantity.value() - o.filled.value();
+        if (o.side == antara::side::buy) {
+            remaining = match(current_book.asks,
+                              [limit_value](const absl::uint128 &p) { return p <= limit_value; },
+                              remaining, &o, 1.0);
+            if (remaining > g_quantity_epsilon) {
+                current_book.bids[limit_value].push_back(resting_order{id, now_});
+            }
+        } else {
+            remaining = match(current_book.bids,
+                              [limit_value](const absl::uint128 &p) { return p >= limit_value; },
+                              remaining, &o, 1.0);
+            if (remaining > g_quantity_epsilon) {
+                current_book.asks[limit_value].push_back(resting_order{id, now_});
+            }
+        }
+    }
+
+    void matching_engine::remove_from_book(const orders::order &o)
+    {
+        auto book_it = books_.find(o.pair);
+        if (book_it == books_.end()) {
+            return;
+        }
+        auto erase_from = [&o](auto &levels) {
+            auto level_it = levels.find(o.price.value());
+            if (level_it == levels.end()) {
+                return;
+            }
+            auto &queue = level_it->second;
+            queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                       [&o](const resting_order &r) { return r.id == o.id; }), queue.end());
+            if (queue.empty()) {
+                levels.erase(level_it);
+            }
+        };
+        if (o.side == antara::side::buy) {
+            erase_from(book_it->second.bids);
+        } else {
+            erase_from(book_it->second.asks);
+        }
+    }
+
+    template<typename Levels, typename Crosses>
+    double matching_engine::match(Levels &levels, Crosses &&crosses, double quantity, orders::order *taker,
+                                  double ratio)
+    {
+        auto level_it = levels.begin();
+        while (quantity > g_quantity_epsilon && level_it != levels.end() && crosses(level_it->first)) {
+            auto &queue = level_it->second;
+            const st_price level_price{level_it->first};
+            for (auto it = queue.begin(); it != queue.end() && quantity > g_quantity_epsilon;) {
+                auto &maker_order = orders_.at(it->id);
+                const double available = (maker_order.quantity.value() - maker_order.filled.value()) * ratio;
+                const double traded = std::min(quantity, available);
+                if (traded > g_quantity_epsilon) {
+                    stats_.quote_to_fill_latencies.push_back(now_ - it->activated_at);
+                    record_execution(maker_order, level_price, traded, true);
+                    if (taker != nullptr) {
+                        record_execution(*taker, level_price, traded, false);
+                    }
+                    quantity -= traded;
+                }
+                it = maker_order.status == orders::order_status::filled ? queue.erase(it) : std::next(it);
+            }
+            level_it = queue.empty() ? levels.erase(level_it) : std::next(level_it);
+        }
+        return quantity;
+    }
+
+    void matching_engine::record_execution(orders::order &o, st_price price, double quantity, antara::maker maker)
+    {
+        auto execution_id = st_execution_id{"sim-ex-" + std::to_string(next_execution_id_++)};
+        orders::execution ex{execution_id, o.pair, price, st_quantity{quantity}, o.side, maker};
+        o.execute(ex);
+        o.add_execution_id(execution_id);
+        if (o.status == orders::order_status::filled) {
+            unfinished_by_pair_[o.pair].erase(o.id);
+            ++stats_.nb_orders_filled;
+        }
+        executions_by_order_[o.id].push_back(executions_.size());
+        executions_.push_back(ex);
+        recent_executions_.push_back(std::move(ex));
+        ++stats_.nb_executions;
+    }
+}
@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <optional>
+#include <queue>
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <orders/orders.hpp>
+#include <utils/mmbot_strong_types.hpp>
+
+namespace antara::mmbot::simulation
+{
+    using sim_duration = std::chrono::microseconds;
+    using sim_time_point = std::chrono::microseconds;
+
+    //! Delays applied on the simulated clock between a request and the moment it reaches the book.
+    struct latency_model
+    {
+        sim_duration place_latency{0};
+        sim_duration cancel_latency{0};
+        sim_duration jitter{0};
+    };
+
+    //! How external flow sent through matching_engine::take interacts with the resting orders.
+    struct fill_model
+    {
+        double fill_probability{1.0};
+        double max_fill_ratio{1.0};
+    };
+
+    struct engine_stats
+    {
+        std::size_t nb_orders_placed{0};
+        std::size_t nb_orders_cancelled{0};
+        std::size_t nb_orders_filled{0};
+        std::size_t nb_executions{0};
+        std::vector<sim_duration> quote_to_fill_latencies;
+    };
+
+    /**
+     * @brief In-process price-time priority matching engine driven by a simulated clock.
+     *
+     * Nothing happens in wall-clock time: orders and cancels are scheduled with the latency model
+     * and only take effect when the clock is advanced, which makes runs fully deterministic for a given seed.
+     * The engine is not thread-safe.
+     */
+    class matching_engine
+    {
+    public:
+        explicit matching_engine(latency_model latency = {}, fill_model fill = {}, std::uint64_t seed = 42) noexcept;
+
+        orders::order &submit(const antara::pair &pair, const orders::order_level &ol);
+
+        bool cancel(const st_order_id &id);
+
+        //! cancel every unfinished order of `pair`, returns their ids.
+        std::vector<st_order_id> cancel_all(const antara::pair &pair);
+
+        std::vector<orders::execution>
+        take(const antara::pair &pair, antara::side side, st_price limit, st_quantity quantity);
+
+        void advance(sim_duration duration);
+
+        [[nodiscard]] sim_time_point now() const noexcept;
+
+        [[nodiscard]] const orders::order &get_order(const st_order_id &id) const;
+
+        [[nodiscard]] std::vector<orders::order> get_live_orders() const;
+
+        [[nodiscard]] const std::vector<orders::execution> &get_executions() const noexcept;
+
+        [[nodiscard]] std::vector<orders::execution> get_executions(const st_order_id &id) const;
+
+        std::vector<orders::execution> drain_recent_executions();
+
+        [[nodiscard]] std::optional<st_price> best_bid(const antara::pair &pair) const;
+
+        [[nodiscard]] std::optional<st_price> best_ask(const antara::pair &pair) const;
+
+        [[nodiscard]] const engine_stats &get_stats() const noexcept;
+
+    private:
+        struct resting_order
+        {
+            st_order_id id;
+            sim_time_point activated_at;
+        };
+
+        template<typename Compare>
+        using price_levels = std::map<absl::uint128, std::deque<resting_order>, Compare>;
+
+        struct book
+        {
+            price_levels<std::greater<>> bids;
+            price_levels<std::less<>> asks;
+        };
+
+        enum class event_kind
+        {
+            activate, cancel
+        };
+
+        struct event
+        {
+            sim_time_point at;
+            std::uint64_t sequence;
+            event_kind kind;
+            st_order_id id;
+        };
+
+        struct event_later
+        {
+            bool operator()(const event &lhs, const event &rhs) const
+            {
+                return lhs.at != rhs.at ? lhs.at > rhs.at : lhs.sequence > rhs.sequence;
+            }
+        };
+
+        void schedule(event_kind kind, const st_order_id &id, sim_duration base_latency);
+
+        void process_due_events();
+
+        void activate(const st_order_id &id);
+
+        void remove_from_book(const orders::order &o);
+
+        template<typename Levels, typename Crosses>
+        double match(Levels &levels, Crosses &&crosses, double quantity, orders::order *taker, double ratio);
+
+        void record_execution(orders::order &o, st_price price, double quantity, antara::maker maker);
+
+        latency_model latency_;
+        fill_model fill_;
+        std::mt19937_64 rng_;
+        sim_time_point now_{0};
+        std::uint64_t next_sequence_{0};
+        std::uint64_t next_order_id_{0};
+        std::uint64_t next_execution_id_{0};
+
+        orders::orders_by_id orders_;
+        std::unordered_map<antara::pair, book> books_;
+        std::unordered_map<antara::pair, std::unordered_set<st_order_id>> unfinished_by_pair_;
+        std::priority_queue<event, std::vector<event>, event_later> events_;
+
+        std::vector<orders::execution> executions_;
+        std::unordered_map<st_order_id, std::vector<std::size_t>> executions_by_order_;
+        std::vector<orders::execution> recent_executions_;
+        engine_stats stats_;
+    };
+}
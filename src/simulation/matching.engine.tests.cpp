@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+
+#include <cex/cex.simulated.hpp>
+#include <dex/dex.simulated.hpp>
+#include <order_manager/order.manager.hpp>
+#include <strategy_manager/strategy.manager.hpp>
+#include "matching.engine.hpp"
+
+namespace antara::mmbot::tests
+{
+    struct fixed_price_service
+    {
+        st_price get_price([[maybe_unused]] antara::pair pair) const
+        {
+            return price;
+        }
+
+        st_price price;
+    };
+
+    TEST_CASE ("the matching engine respects price-time priority")
+    {
+        simulation::matching_engine engine;
+        auto pair = antara::pair::of("A", "B");
+
+        auto &first = engine.submit(pair, {st_price{100}, st_quantity{5}, antara::side::sell});
+        auto &second = engine.submit(pair, {st_price{100}, st_quantity{5}, antara::side::sell});
+        auto &better = engine.submit(pair, {st_price{99}, st_quantity{5}, antara::side::sell});
+        CHECK_EQ(st_price{99}, engine.best_ask(pair).value());
+
+        auto executions = engine.take(pair, antara::side::buy, st_price{100}, st_quantity{7});
+        REQUIRE_EQ(2, executions.size());
+        CHECK_EQ(st_price{99}, executions[0].price);
+        CHECK_EQ(st_price{100}, executions[1].price);
+        CHECK_EQ(orders::order_status::filled, better.status);
+        CHECK_EQ(st_quantity{2}, first.filled);
+        CHECK_EQ(st_quantity{0}, second.filled);
+    }
+
+    TEST_CASE ("an incoming order crossing the book trades as taker")
+    {
+        simulation::matching_engine engine;
+        auto pair = antara::pair::of("A", "B");
+
+        auto &ask = engine.submit(pair, {st_price{100}, st_quantity{5}, antara::side::sell});
+        auto &bid = engine.submit(pair, {st_price{101}, st_quantity{8}, antara::side::buy});
+
+        CHECK_EQ(orders::order_status::filled, ask.status);
+        CHECK_EQ(st_quantity{5}, bid.filled);
+        CHECK_EQ(st_price{101}, engine.best_bid(pair).value());
+        CHECK_FALSE(engine.best_ask(pair).has_value());
+        CHECK_EQ(2, engine.get_executions().size());
+    }
+
+    TEST_CASE ("orders and cancels only reach the book after their latency")
+    {
+        simulation::latency_model latency{simulation::sim_duration{100}, simulation::sim_duration{50}};
+        simulation::matching_engine engine(latency);
+        auto pair = antara::pair::of("A", "B");
+
+        auto &ask = engine.submit(pair, {st_price{100}, st_quantity{5}, antara::side::sell});
+        CHECK_FALSE(engine.best_ask(pair).has_value());
+        CHECK_EQ(orders::order_status::pending, ask.status);
+
+        engine.advance(simulation::sim_duration{100});
+        CHECK(engine.best_ask(pair).has_value());
+        CHECK_EQ(orders::order_status::live, ask.status);
+
+        CHECK(engine.cancel(ask.id));
+        CHECK_EQ(orders::order_status::live, ask.status);
+
+        engine.advance(simulation::sim_duration{10});
+        auto executions = engine.take(pair, antara::side::buy, st_price{100}, st_quantity{1});
+        REQUIRE_EQ(1, executions.size());
+        CHECK_EQ(orders::order_status::partially_filled, ask.status);
+        CHECK_EQ(simulation::sim_duration{10}, engine.get_stats().quote_to_fill_latencies.front());
+
+        engine.advance(simulation::sim_duration{40});
+        CHECK_EQ(orders::order_status::cancelled, ask.status);
+        CHECK_FALSE(engine.best_ask(pair).has_value());
+        CHECK_FALSE(engine.cancel(ask.id));
+    }
+
+    TEST_CASE ("the fill model limits how much external flow takes")
+    {
+        simulation::matching_engine engine({}, simulation::fill_model{1.0, 0.5});
+        auto pair = antara::pair::of("A", "B");
+
+        auto &bid = engine.submit(pair, {st_price{100}, st_quantity{10}, antara::side::buy});
+        auto executions = engine.take(pair, antara::side::sell, st_price{90}, st_quantity{100});
+
+        REQUIRE_EQ(1, executions.size());
+        CHECK_EQ(st_quantity{5}, bid.filled);
+        CHECK_EQ(orders::order_status::partially_filled, bid.status);
+
+        simulation::matching_engine never_fills({}, simulation::fill_model{0.0, 1.0});
+        never_fills.submit(pair, {st_price{100}, st_quantity{10}, antara::side::buy});
+        CHECK(never_fills.take(pair, antara::side::sell, st_price{90}, st_quantity{100}).empty());
+    }
+
+    TEST_CASE ("strategy and order managers run end to end against the simulated exchanges")
+    {
+        simulation::matching_engine engine;
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex);
+        fixed_price_service ps{st_price{100}};
+        strategy_manager<fixed_price_service> sm(ps, om);
+
+        auto pair = antara::pair::of("A", "B");
+        sm.add_strategy(market_making_strategy{pair, st_spread{0.1}, st_quantity{10}, antara::side::both});
+        sm.refresh_orders(pair);
+
+        CHECK_EQ(st_price{90}, engine.best_bid(pair).value());
+        CHECK_EQ(st_price{110}, engine.best_ask(pair).value());
+        CHECK_EQ(2, om.get_all_orders().size());
+
+        engine.take(pair, antara::side::buy, st_price{115}, st_quantity{4});
+        om.poll();
+        REQUIRE_EQ(1, cex.get_mirrored_executions().size());
+        CHECK_EQ(antara::side::buy, cex.get_mirrored_executions().front().side);
+
+        om.poll();
+        CHECK_EQ(1, cex.get_mirrored_executions().size());
+
+        sm.refresh_orders(pair);
+        CHECK_EQ(2, engine.get_live_orders().size());
+        CHECK_EQ(4, engine.get_stats().nb_orders_placed);
+        CHECK_EQ(2, engine.get_stats().nb_orders_cancelled);
+    }
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "backtest/replay.price.service.hpp"
+#include "cex/cex.simulated.hpp"
+#include "dex/dex.simulated.hpp"
+#include "strategy_manager/strategy.manager.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot;
+
+    void BM_create_order_group(benchmark::State &state)
+    {
+        const antara::pair pair{antara::asset{st_symbol{"RICK"}}, antara::asset{st_symbol{"MORTY"}}};
+        simulation::matching_engine engine;
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex);
+        replay_price_service ps;
+        ps.update(pair, st_price{1797920499999999ull});
+        strategy_manager<replay_price_service> sm(ps, om);
+        const market_making_strategy strat{pair, st_spread{0.05}, st_quantity{10.0}, antara::side::both};
+        sm.add_strategy(strat);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(sm.create_order_group(strat));
+        }
+    }
+}
+
+BENCHMARK(BM_create_order_group);
@@ -16,22 +16,41 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <utils/mmbot_strong_types.hpp>
+#include <metrics/metrics.hpp>
 #include <orders/orders.hpp>
 #include <order_manager/order.manager.hpp>
 #include <price/service.price.platform.hpp>
+#include <price/volatility.estimator.hpp>
 
 namespace antara::mmbot
 {
+    enum class spread_mode
+    {
+        fixed, volatility
+    };
+
     struct market_making_strategy
     {
         antara::pair pair;
         antara::st_spread spread;
         antara::st_quantity quantity;
         antara::side side;
+        //! volatility: the spread is volatility_multiplier times the volatility of the pair, between min_spread and
+        //! max_spread, `spread` is used until the volatility is known.
+        spread_mode mode{spread_mode::fixed};
+        double volatility_multiplier{2.0};
+        antara::st_spread min_spread{0.001};
+        antara::st_spread max_spread{0.2};
+        //! the quotes are replaced only when a level moves by at least this number of price ticks, 0 always replaces.
+        std::size_t reprice_threshold_ticks{0};
         bool operator==(const market_making_strategy &other) const;
         bool operator!=(const market_making_strategy &other) const;
     };
@@ -66,6 +85,7 @@ namespace antara::mmbot
     {
     public:
         using registry_strategies = std::unordered_map<antara::pair, market_making_strategy>;
+        using pair_readiness = std::function<bool(const antara::pair &)>;
 
         strategy_manager(PS& ps, abstract_om& om): om_(om), ps_(ps)
         {
@@ -88,16 +108,51 @@ namespace antara::mmbot
 
         orders::order_group create_order_group(const market_making_strategy &strat) override;
 
+        //! the spread quoted for `strat` now, depends on the volatility in spread_mode::volatility.
+        antara::st_spread get_spread(const market_making_strategy &strat) const;
+
+        //! feed the volatility of `pair`, e.g. from the price observer of the price service.
+        void on_price_tick(const antara::pair &pair, antara::st_price price,
+                           volatility_estimator::clock::time_point when = volatility_estimator::clock::now());
+
+        std::optional<volatility_snapshot> get_volatility(const antara::pair &pair) const;
+
+        void set_volatility_options(volatility_options options);
+
+        //! pairs for which `readiness` is false are skipped by refresh_all_orders, e.g. until their coins are active.
+        void set_pair_readiness(pair_readiness readiness);
+
         void refresh_orders(antara::pair pair);
         void refresh_all_orders();
 
         void start();
 
     private:
+        struct quote
+        {
+            orders::order_group group;
+            std::unordered_set<st_order_id> ids;
+        };
+
+        //! resolved once in add_strategy, refresh_orders runs in a loop.
+        struct pair_metrics
+        {
+            metrics::histogram *refresh_latency;
+            metrics::counter *reprice_skipped;
+        };
+
+        [[nodiscard]] bool is_within_threshold(const market_making_strategy &strat, const orders::order_group &orders) const;
+
         registry_strategies registry_strategies_;
         abstract_om &om_;
         PS &ps_;
+        pair_readiness pair_readiness_;
         bool running_;
+        volatility_options volatility_options_;
+        mutable std::mutex volatility_mutex_;
+        std::unordered_map<antara::pair, volatility_estimator> volatilities_;
+        std::unordered_map<antara::pair, quote> last_quotes_;
+        std::unordered_map<antara::pair, pair_metrics> pair_metrics_;
     };
 }
 
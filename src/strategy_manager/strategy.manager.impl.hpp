@@ -16,22 +16,29 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 
+#include <metrics/metrics.hpp>
 #include "strategy.manager.hpp"
 
 namespace antara::mmbot
 {
-    bool market_making_strategy::operator==(const market_making_strategy &other) const
+    inline bool market_making_strategy::operator==(const market_making_strategy &other) const
     {
         return pair == other.pair
                && spread == other.spread
                && quantity == other.quantity
-               && side == other.side;
+               && side == other.side
+               && mode == other.mode
+               && volatility_multiplier == other.volatility_multiplier
+               && min_spread == other.min_spread
+               && max_spread == other.max_spread
+               && reprice_threshold_ticks == other.reprice_threshold_ticks;
     }
 
-    bool market_making_strategy::operator!=(const market_making_strategy &other) const
+    inline bool market_making_strategy::operator!=(const market_making_strategy &other) const
     {
         return !(*this == other);
     }
@@ -41,6 +48,10 @@ namespace antara::mmbot
     {
         antara::pair pair = strat.pair;
         registry_strategies_.emplace(pair, strat);
+        const auto pair_label = metrics::label("pair", pair.base.symbol.value() + "/" + pair.quote.symbol.value());
+        pair_metrics_.try_emplace(pair, pair_metrics{
+                &metrics::get_histogram("mmbot_refresh_orders_latency_us", pair_label),
+                &metrics::get_counter("mmbot_reprice_skipped_total", pair_label)});
     }
 
     template <class PS>
@@ -59,8 +70,8 @@ namespace antara::mmbot
     orders::order_level strategy_manager<PS>::make_bid(
         antara::st_price mid, antara::st_spread spread, antara::st_quantity quantity)
     {
-        antara::st_spread mod = antara::st_spread{1.0} - spread;
-        antara::st_price price = mid * mod;
+        //! rounded away from the mid so the quoted spread is never tighter than the requested one.
+        antara::st_price price = antara::multiply(mid, antara::st_spread::one() - spread, antara::rounding::down);
         antara::side side = antara::side::buy;
         orders::order_level ol{antara::st_price{price}, quantity, side};
         return ol;
@@ -70,8 +81,7 @@ namespace antara::mmbot
     orders::order_level strategy_manager<PS>::make_ask(
         antara::st_price mid, antara::st_spread spread, antara::st_quantity quantity)
     {
-        antara::st_spread mod = 1.0 + spread;
-        antara::st_price price = mid * mod;
+        antara::st_price price = antara::multiply(mid, antara::st_spread::one() + spread, antara::rounding::up);
         antara::side side = antara::side::sell;
         orders::order_level ol{price, quantity, side};
         return ol;
@@ -84,7 +94,7 @@ namespace antara::mmbot
         auto pair = strat.pair;
 
         antara::side side = strat.side;
-        antara::st_spread spread = strat.spread;
+        antara::st_spread spread = get_spread(strat);
         antara::st_quantity quantity = strat.quantity;
 
         orders::order_group os;
@@ -129,6 +139,91 @@ namespace antara::mmbot
         return create_order_group(strat, mid);
     }
 
+    template <class PS>
+    antara::st_spread strategy_manager<PS>::get_spread(const market_making_strategy &strat) const
+    {
+        if (strat.mode == spread_mode::fixed) {
+            return strat.spread;
+        }
+        auto volatility = get_volatility(strat.pair);
+        if (!volatility.has_value() || !volatility->volatility.has_value()) {
+            return strat.spread;
+        }
+        auto spread = antara::st_spread{strat.volatility_multiplier * volatility->volatility.value()};
+        return std::clamp(spread, strat.min_spread, strat.max_spread);
+    }
+
+    template <class PS>
+    void strategy_manager<PS>::on_price_tick(const antara::pair &pair, antara::st_price price,
+                                             volatility_estimator::clock::time_point when)
+    {
+        std::scoped_lock lock(volatility_mutex_);
+        auto it = volatilities_.find(pair);
+        if (it == volatilities_.end()) {
+            it = volatilities_.emplace(pair, volatility_estimator{volatility_options_}).first;
+        }
+        it->second.on_price(price, when);
+    }
+
+    template <class PS>
+    std::optional<volatility_snapshot> strategy_manager<PS>::get_volatility(const antara::pair &pair) const
+    {
+        std::scoped_lock lock(volatility_mutex_);
+        auto it = volatilities_.find(pair);
+        return it == volatilities_.end() ? std::nullopt : std::optional<volatility_snapshot>(it->second.get());
+    }
+
+    template <class PS>
+    void strategy_manager<PS>::set_volatility_options(volatility_options options)
+    {
+        std::scoped_lock lock(volatility_mutex_);
+        volatility_options_ = options;
+    }
+
+    template <class PS>
+    bool strategy_manager<PS>::is_within_threshold(const market_making_strategy &strat,
+                                                   const orders::order_group &orders) const
+    {
+        auto it = last_quotes_.find(strat.pair);
+        if (strat.reprice_threshold_ticks == 0 || it == last_quotes_.end()) {
+            return false;
+        }
+        const auto &last = it->second;
+        //! a quote that is not live anymore (filled, cancelled) is always replaced.
+        const auto &all_orders = om_.get_all_orders();
+        for (auto &&id : last.ids) {
+            auto order_it = all_orders.find(id);
+            if (order_it == all_orders.end() || order_it->second.status != orders::order_status::live) {
+                return false;
+            }
+        }
+        const auto &previous_levels = last.group.levels;
+        const auto &levels = orders.levels;
+        if (previous_levels.size() != levels.size()) {
+            return false;
+        }
+        const absl::uint128 threshold = strat.reprice_threshold_ticks;
+        for (std::size_t idx = 0; idx < levels.size(); ++idx) {
+            const auto &previous = previous_levels[idx];
+            const auto &current = levels[idx];
+            if (previous.side != current.side || previous.quantity != current.quantity) {
+                return false;
+            }
+            const auto move = previous.price > current.price ? previous.price.value() - current.price.value() :
+                              current.price.value() - previous.price.value();
+            if (move >= threshold) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class PS>
+    void strategy_manager<PS>::set_pair_readiness(pair_readiness readiness)
+    {
+        pair_readiness_ = std::move(readiness);
+    }
+
     template <class PS>
     void strategy_manager<PS>::refresh_orders(antara::pair pair)
     {
@@ -136,17 +231,29 @@ namespace antara::mmbot
         //     throw
         // }
 
+        const auto &current_metrics = pair_metrics_.at(pair);
+        metrics::scoped_timer timer(*current_metrics.refresh_latency);
         auto strat = registry_strategies_.at(pair);
         auto orders = create_order_group(strat);
+        if (is_within_threshold(strat, orders)) {
+            current_metrics.reprice_skipped->inc();
+            return;
+        }
 
         om_.cancel_orders(pair);
-        om_.place_order(orders);
+        auto ids = om_.place_order(orders);
+        if (strat.reprice_threshold_ticks > 0) {
+            last_quotes_.insert_or_assign(pair, quote{std::move(orders), std::move(ids)});
+        }
     }
 
     template <class PS>
     void strategy_manager<PS>::refresh_all_orders()
     {
         for(const auto& [pair, strat] : registry_strategies_) {
+            if (pair_readiness_ && !pair_readiness_(pair)) {
+                continue;
+            }
             refresh_orders(pair);
         }
     }
@@ -164,7 +271,4 @@ namespace antara::mmbot
             // std::this_thread::sleep_for(1s);
         }
     }
-
-    template class strategy_manager<price_service_platform>;
-    template class strategy_manager<price_service_platform_mock>;
 }
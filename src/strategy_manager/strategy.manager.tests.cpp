@@ -19,6 +19,9 @@
 #include <trompeloeil.hpp>
 
 #include <utils/mmbot_strong_types.hpp>
+#include <backtest/replay.price.service.hpp>
+#include <cex/cex.simulated.hpp>
+#include <dex/dex.simulated.hpp>
 #include <order_manager/order.manager.mock.hpp>
 #include <price/service.price.platform.mock.hpp>
 #include "strategy.manager.hpp"
@@ -146,4 +149,103 @@ namespace antara::mmbot::tests
 
         sm.refresh_orders(pair);
     }
+
+    TEST_CASE("only the ready pairs are refreshed")
+    {
+        auto ready_pair = antara::pair::of("A", "B");
+        auto pending_pair = antara::pair::of("A", "C");
+
+        dex dex;
+        cex cex;
+        auto om = order_manager_mock(dex, cex);
+        auto ps = price_service_platform_mock();
+
+        auto sm = strategy_manager<price_service_platform_mock>(ps, om);
+        sm.add_strategy({ready_pair, st_spread{0.1}, st_quantity{10}, antara::side::sell});
+        sm.add_strategy({pending_pair, st_spread{0.1}, st_quantity{10}, antara::side::sell});
+        sm.set_pair_readiness([&ready_pair](const antara::pair &pair) { return pair == ready_pair; });
+
+        REQUIRE_CALL(ps, get_price(ready_pair))
+            .RETURN(st_price{1});
+        REQUIRE_CALL(om, cancel_orders(ready_pair))
+            .RETURN(std::unordered_set<st_order_id>());
+        REQUIRE_CALL(om, place_order(trompeloeil::_))
+            .RETURN(std::unordered_set<st_order_id>());
+        FORBID_CALL(ps, get_price(pending_pair));
+        FORBID_CALL(om, cancel_orders(pending_pair));
+
+        sm.refresh_all_orders();
+    }
+
+    TEST_CASE("the spread follows the volatility in volatility mode")
+    {
+        using namespace std::chrono_literals;
+        auto pair = antara::pair::of("A", "B");
+        market_making_strategy strat{pair, st_spread{0.05}, st_quantity{10}, antara::side::both};
+        strat.mode = spread_mode::volatility;
+        strat.volatility_multiplier = 2.0;
+        strat.min_spread = st_spread{0.01};
+        strat.max_spread = st_spread{0.1};
+
+        dex dex;
+        cex cex;
+        auto om = order_manager(dex, cex);
+        auto ps = price_service_platform_mock();
+        auto sm = strategy_manager<price_service_platform_mock>(ps, om);
+        volatility_options options;
+        options.horizon = 1s;
+        sm.set_volatility_options(options);
+
+        CHECK_EQ(st_spread{0.05}, sm.get_spread(strat));
+        CHECK_FALSE(sm.get_volatility(pair).has_value());
+
+        //! 1% moves every second, no range window closed yet.
+        auto now = volatility_estimator::clock::now();
+        for (int idx = 0; idx <= 20; ++idx) {
+            sm.on_price_tick(pair, st_price{idx % 2 == 0 ? 10000u : 10100u}, now + idx * 1s);
+        }
+        CHECK_EQ(st_spread{2.0 * std::log(1.01)}, sm.get_spread(strat));
+        auto og = sm.create_order_group(strat, st_price{10000});
+        //! 10000 * (1 - 0.019901), rounded down.
+        CHECK_EQ(st_price{9800}, og.levels[0].price);
+
+        //! quiet market, the spread tightens down to min_spread.
+        for (int idx = 21; idx <= 400; ++idx) {
+            sm.on_price_tick(pair, st_price{10000}, now + idx * 1s);
+        }
+        CHECK_EQ(st_spread{0.01}, sm.get_spread(strat));
+
+        strat.max_spread = st_spread{0.001};
+        CHECK_EQ(st_spread{0.001}, sm.get_spread(strat));
+        strat.mode = spread_mode::fixed;
+        CHECK_EQ(st_spread{0.05}, sm.get_spread(strat));
+    }
+
+    TEST_CASE("the quotes are replaced only when they move by the reprice threshold")
+    {
+        auto pair = antara::pair::of("A", "B");
+        market_making_strategy strat{pair, st_spread{0.1}, st_quantity{10}, antara::side::both};
+        strat.reprice_threshold_ticks = 100;
+
+        simulation::matching_engine engine;
+        simulated_dex dex(engine);
+        simulated_cex cex;
+        order_manager om(dex, cex);
+        replay_price_service ps;
+        strategy_manager<replay_price_service> sm(ps, om);
+        sm.add_strategy(strat);
+
+        ps.update(pair, st_price{1000000});
+        sm.refresh_orders(pair);
+        CHECK_EQ(2, engine.get_stats().nb_orders_placed);
+
+        //! bid and ask move by 45 and 55 ticks.
+        ps.update(pair, st_price{1000050});
+        sm.refresh_orders(pair);
+        CHECK_EQ(2, engine.get_stats().nb_orders_placed);
+
+        ps.update(pair, st_price{1000200});
+        sm.refresh_orders(pair);
+        CHECK_EQ(4, engine.get_stats().nb_orders_placed);
+    }
 }
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <cmath>
+#include "tick.recorder.hpp"
+
+namespace
+{
+    std::chrono::microseconds now_us()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+    }
+
+    antara::st_price to_fixed_point(double price, std::size_t nb_decimals)
+    {
+        auto scaled = std::round(static_cast<long double>(price) * std::pow(10.0L, static_cast<long double>(nb_decimals)));
+        return antara::st_price{scaled > 0 ? absl::uint128(scaled) : absl::uint128(0)};
+    }
+}
+
+namespace antara::mmbot::tickstore
+{
+    tick_recorder::tick_recorder(std::filesystem::path path, std::size_t rows_per_block) :
+            writer_(std::move(path), rows_per_block)
+    {
+    }
+
+    void tick_recorder::attach(price_service_platform &price_service)
+    {
+        price_service.add_price_observer([this](const antara::pair &pair, st_price price) {
+            this->record_price(pair, price);
+        });
+    }
+
+    void tick_recorder::attach(mm2_client &client)
+    {
+        client.add_orderbook_observer([this](const mm2::orderbook_answer &answer) {
+            this->record_orderbook(answer);
+        });
+    }
+
+    void tick_recorder::record_price(const antara::pair &pair, st_price price)
+    {
+        writer_.append(now_us(), pair, price);
+    }
+
+    void tick_recorder::record_orderbook(const mm2::orderbook_answer &answer)
+    {
+        auto snapshot = to_book_snapshot(get_mmbot_config(), answer);
+        antara::pair pair{answer.rel, answer.base};
+        st_price mid{0};
+        if (!snapshot.bids.empty() && !snapshot.asks.empty()) {
+            mid = st_price{(snapshot.bids.front().price.value() + snapshot.asks.front().price.value()) / 2};
+        }
+        writer_.append(now_us(), pair, mid, snapshot);
+    }
+
+    void tick_recorder::flush()
+    {
+        writer_.flush();
+    }
+
+    book_snapshot to_book_snapshot(const config &cfg, const mm2::orderbook_answer &answer)
+    {
+        std::size_t nb_decimals = 8u;
+        if (auto id = cfg.coin_scales.get_id(answer.rel.symbol.value()); id != coin_scale_table::invalid_coin_id) {
+            nb_decimals = cfg.coin_scales[id].nb_decimals;
+        }
+        book_snapshot snapshot;
+        snapshot.bids.reserve(answer.bids.size());
+        snapshot.asks.reserve(answer.asks.size());
+        for (auto &&bid : answer.bids) {
+            snapshot.bids.push_back({to_fixed_point(bid.bids_contents.price, nb_decimals),
+                                     st_quantity{bid.bids_contents.max_volume}});
+        }
+        for (auto &&ask : answer.asks) {
+            snapshot.asks.push_back({to_fixed_point(ask.ask_contents.price, nb_decimals),
+                                     st_quantity{ask.ask_contents.max_volume}});
+        }
+        auto by_price = [](auto &&lhs, auto &&rhs) { return lhs.price.value() < rhs.price.value(); };
+        std::sort(snapshot.bids.begin(), snapshot.bids.end(), [&by_price](auto &&lhs, auto &&rhs) {
+            return by_price(rhs, lhs);
+        });
+        std::sort(snapshot.asks.begin(), snapshot.asks.end(), by_price);
+        return snapshot;
+    }
+}
@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <mm2/mm2.client.hpp>
+#include <price/service.price.platform.hpp>
+#include "tick.store.hpp"
+
+namespace antara::mmbot::tickstore
+{
+    /**
+     * @brief Persists the prices computed by the price thread and the orderbooks answered by mm2 into a tick store.
+     */
+    class tick_recorder
+    {
+    public:
+        explicit tick_recorder(std::filesystem::path path, std::size_t rows_per_block = 4096);
+
+        void attach(price_service_platform &price_service);
+
+        void attach(mm2_client &client);
+
+        void record_price(const antara::pair &pair, st_price price);
+
+        void record_orderbook(const mm2::orderbook_answer &answer);
+
+        void flush();
+
+    private:
+        tick_store_writer writer_;
+    };
+
+    /**
+     * @brief Convert an orderbook answer to a snapshot, prices are scaled to the decimals of the `rel` coin.
+     */
+    book_snapshot to_book_snapshot(const config &cfg, const mm2::orderbook_answer &answer);
+}
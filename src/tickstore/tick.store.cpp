@@ -0,0 +1,472 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <cstring>
+#include <stdexcept>
+#include <loguru.hpp>
+#include <utils/pretty_function.hpp>
+#include "tick.store.hpp"
+
+namespace
+{
+    using namespace antara;
+    using namespace antara::mmbot::tickstore;
+
+    constexpr std::size_t align8(std::size_t size) noexcept
+    {
+        return (size + 7u) & ~std::size_t{7u};
+    }
+
+    std::size_t ticks_columns_size(std::size_t nb_rows) noexcept
+    {
+        return 3u * sizeof(std::uint64_t) * nb_rows + 2u * align8(sizeof(std::uint32_t) * nb_rows);
+    }
+
+    std::string pair_to_string(const antara::pair &pair)
+    {
+        return pair.base.symbol.value() + "/" + pair.quote.symbol.value();
+    }
+
+    antara::pair pair_from_string(const std::string &str)
+    {
+        auto pos = str.find('/');
+        return antara::pair::of(str.substr(pos + 1), str.substr(0, pos));
+    }
+
+    template<typename T>
+    void write_pod(std::ofstream &ofs, const T &value)
+    {
+        ofs.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void write_column(std::ofstream &ofs, const std::vector<T> &column)
+    {
+        const auto size = sizeof(T) * column.size();
+        ofs.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(size));
+        static constexpr char padding[8] = {};
+        ofs.write(padding, static_cast<std::streamsize>(align8(size) - size));
+    }
+
+    void append_bytes(std::vector<std::byte> &out, const void *data, std::size_t size)
+    {
+        auto bytes = static_cast<const std::byte *>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    void append_level(std::vector<std::byte> &out, const book_level &level)
+    {
+        format::level_record record{absl::Uint128Low64(level.price.value()), absl::Uint128High64(level.price.value()),
+                                    level.quantity.value()};
+        append_bytes(out, &record, sizeof(record));
+    }
+
+    book_level to_level(const format::level_record &record) noexcept
+    {
+        return book_level{st_price{absl::MakeUint128(record.price_hi, record.price_lo)}, st_quantity{record.quantity}};
+    }
+
+    //! std::nullopt when an entry of the pairs block runs past its payload.
+    std::optional<std::vector<std::pair<pair_id, std::string>>>
+    read_pairs(const std::byte *payload, const format::block_header &block)
+    {
+        constexpr auto entry_header_size = 2 * sizeof(std::uint32_t);
+        std::vector<std::pair<pair_id, std::string>> pairs;
+        std::size_t cursor = 0;
+        for (std::uint32_t idx = 0; idx < block.nb_rows; ++idx) {
+            if (cursor > block.payload_size || block.payload_size - cursor < entry_header_size) {
+                return std::nullopt;
+            }
+            std::uint32_t id = 0, length = 0;
+            std::memcpy(&id, payload + cursor, sizeof(id));
+            std::memcpy(&length, payload + cursor + sizeof(id), sizeof(length));
+            if (block.payload_size - cursor - entry_header_size < length) {
+                return std::nullopt;
+            }
+            pairs.emplace_back(id, std::string(reinterpret_cast<const char *>(payload + cursor + entry_header_size),
+                                               length));
+            cursor += align8(entry_header_size + length);
+        }
+        return pairs;
+    }
+
+    //! false when a block is too small for its columns or a book, levels included, runs past its books column.
+    bool books_in_bounds(const std::byte *payload, const format::block_header &block) noexcept
+    {
+        const auto columns_size = ticks_columns_size(block.nb_rows);
+        if (block.payload_size < columns_size) {
+            return false;
+        }
+        const auto books_size = block.payload_size - columns_size;
+        const auto offsets = payload + 3u * sizeof(std::uint64_t) * block.nb_rows +
+                             align8(sizeof(pair_id) * block.nb_rows);
+        for (std::uint32_t row = 0; row < block.nb_rows; ++row) {
+            std::uint32_t offset = 0;
+            std::memcpy(&offset, offsets + row * sizeof(offset), sizeof(offset));
+            if (offset == format::no_book) {
+                continue;
+            }
+            if (offset % alignof(format::level_record) != 0 || books_size < sizeof(format::book_record) ||
+                offset > books_size - sizeof(format::book_record)) {
+                return false;
+            }
+            format::book_record record{};
+            std::memcpy(&record, payload + columns_size + offset, sizeof(record));
+            const auto levels_size = (std::uint64_t{record.nb_bids} + record.nb_asks) * sizeof(format::level_record);
+            if (levels_size > books_size - offset - sizeof(format::book_record)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+namespace antara::mmbot::tickstore
+{
+    book_view::book_view(const format::book_record *record) noexcept :
+            record_(record),
+            levels_(reinterpret_cast<const format::level_record *>(record + 1))
+    {
+    }
+
+    std::size_t book_view::nb_bids() const noexcept
+    {
+        return record_->nb_bids;
+    }
+
+    std::size_t book_view::nb_asks() const noexcept
+    {
+        return record_->nb_asks;
+    }
+
+    book_level book_view::bid(std::size_t idx) const noexcept
+    {
+        return to_level(levels_[idx]);
+    }
+
+    book_level book_view::ask(std::size_t idx) const noexcept
+    {
+        return to_level(levels_[record_->nb_bids + idx]);
+    }
+
+    book_snapshot book_view::materialize() const
+    {
+        book_snapshot snapshot;
+        snapshot.bids.reserve(nb_bids());
+        snapshot.asks.reserve(nb_asks());
+        for (std::size_t idx = 0; idx < nb_bids(); ++idx) {
+            snapshot.bids.push_back(bid(idx));
+        }
+        for (std::size_t idx = 0; idx < nb_asks(); ++idx) {
+            snapshot.asks.push_back(ask(idx));
+        }
+        return snapshot;
+    }
+
+    tick_block_view::tick_block_view(const std::byte *payload, std::size_t nb_rows) noexcept : nb_rows_(nb_rows)
+    {
+        auto cursor = payload;
+        timestamps_ = reinterpret_cast<const std::int64_t *>(cursor);
+        cursor += sizeof(std::int64_t) * nb_rows;
+        price_lo_ = reinterpret_cast<const std::uint64_t *>(cursor);
+        cursor += sizeof(std::uint64_t) * nb_rows;
+        price_hi_ = reinterpret_cast<const std::uint64_t *>(cursor);
+        cursor += sizeof(std::uint64_t) * nb_rows;
+        pair_ids_ = reinterpret_cast<const pair_id *>(cursor);
+        cursor += align8(sizeof(pair_id) * nb_rows);
+        book_offsets_ = reinterpret_cast<const std::uint32_t *>(cursor);
+        cursor += align8(sizeof(std::uint32_t) * nb_rows);
+        books_ = cursor;
+    }
+
+    std::size_t tick_block_view::size() const noexcept
+    {
+        return nb_rows_;
+    }
+
+    std::chrono::microseconds tick_block_view::timestamp(std::size_t row) const noexcept
+    {
+        return std::chrono::microseconds{timestamps_[row]};
+    }
+
+    pair_id tick_block_view::pair(std::size_t row) const noexcept
+    {
+        return pair_ids_[row];
+    }
+
+    st_price tick_block_view::price(std::size_t row) const noexcept
+    {
+        return st_price{absl::MakeUint128(price_hi_[row], price_lo_[row])};
+    }
+
+    bool tick_block_view::has_book(std::size_t row) const noexcept
+    {
+        return book_offsets_[row] != format::no_book;
+    }
+
+    book_view tick_block_view::book(std::size_t row) const noexcept
+    {
+        return book_view(reinterpret_cast<const format::book_record *>(books_ + book_offsets_[row]));
+    }
+
+    const std::int64_t *tick_block_view::timestamps() const noexcept
+    {
+        return timestamps_;
+    }
+
+    const pair_id *tick_block_view::pair_ids() const noexcept
+    {
+        return pair_ids_;
+    }
+
+    tick_store_reader::tick_store_reader(const std::filesystem::path &path) : file_(path)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        if (!file_.is_open() || file_.size() < sizeof(format::file_header)) {
+            return;
+        }
+        auto data = file_.data();
+        const auto &header = *reinterpret_cast<const format::file_header *>(data);
+        if (std::memcmp(header.magic, format::magic, sizeof(format::magic)) != 0 ||
+            header.version != format::version) {
+            VLOG_F(loguru::Verbosity_WARNING, "%s is not a tick store", path.string().c_str());
+            return;
+        }
+        valid_ = true;
+        std::size_t offset = sizeof(format::file_header);
+        while (offset + sizeof(format::block_header) <= file_.size()) {
+            const auto &block = *reinterpret_cast<const format::block_header *>(data + offset);
+            const auto payload = data + offset + sizeof(format::block_header);
+            //! nothing of a block is trusted before it is known to fit in the file, then its entries in the block.
+            bool intact = block.payload_size <= file_.size() - offset - sizeof(format::block_header);
+            std::optional<std::vector<std::pair<pair_id, std::string>>> pairs;
+            if (intact && block.kind == format::block_kind::pairs) {
+                pairs = read_pairs(payload, block);
+                intact = pairs.has_value();
+            } else if (intact && block.kind == format::block_kind::ticks) {
+                intact = books_in_bounds(payload, block);
+            }
+            if (!intact) {
+                VLOG_F(loguru::Verbosity_WARNING, "ignoring torn block at offset %zu", offset);
+                break;
+            }
+            if (pairs.has_value()) {
+                for (auto &&[id, name] : pairs.value()) {
+                    auto pair = pair_from_string(name);
+                    pairs_by_id_.insert_or_assign(id, pair);
+                    ids_by_pair_.insert_or_assign(pair, id);
+                }
+            } else if (block.kind == format::block_kind::ticks) {
+                blocks_.emplace_back(payload, block.nb_rows);
+                nb_ticks_ += block.nb_rows;
+            }
+            offset += sizeof(format::block_header) + block.payload_size;
+        }
+        valid_size_ = offset;
+        DVLOG_F(loguru::Verbosity_INFO, "tick store loaded: %zu blocks, %zu ticks, %zu pairs", blocks_.size(),
+                nb_ticks_, pairs_by_id_.size());
+    }
+
+    bool tick_store_reader::is_valid() const noexcept
+    {
+        return valid_;
+    }
+
+    std::size_t tick_store_reader::valid_size() const noexcept
+    {
+        return valid_size_;
+    }
+
+    const std::vector<tick_block_view> &tick_store_reader::blocks() const noexcept
+    {
+        return blocks_;
+    }
+
+    std::size_t tick_store_reader::nb_ticks() const noexcept
+    {
+        return nb_ticks_;
+    }
+
+    const antara::pair &tick_store_reader::pair_of(pair_id id) const
+    {
+        return pairs_by_id_.at(id);
+    }
+
+    const std::unordered_map<antara::pair, pair_id> &tick_store_reader::pairs() const noexcept
+    {
+        return ids_by_pair_;
+    }
+
+    std::vector<tick> tick_store_reader::load() const
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        std::vector<tick> ticks;
+        ticks.reserve(nb_ticks_);
+        for_each([this, &ticks](const tick_block_view &block, std::size_t row) {
+            tick current{block.timestamp(row), pair_of(block.pair(row)), block.price(row)};
+            if (block.has_book(row)) {
+                current.book = block.book(row).materialize();
+            }
+            ticks.push_back(std::move(current));
+        });
+        return ticks;
+    }
+
+    tick_store_writer::tick_store_writer(std::filesystem::path path, std::size_t rows_per_block) :
+            path_(std::move(path)), rows_per_block_(rows_per_block)
+    {
+        VLOG_SCOPE_F(loguru::Verbosity_INFO, pretty_function);
+        std::error_code ec;
+        if (std::filesystem::exists(path_, ec) && std::filesystem::file_size(path_, ec) > 0) {
+            std::size_t valid_size = 0;
+            {
+                tick_store_reader reader(path_);
+                if (!reader.is_valid()) {
+                    throw std::invalid_argument(path_.string() + " exists and is not a tick store");
+                }
+                pair_ids_ = reader.pairs();
+                valid_size = reader.valid_size();
+            }
+            std::filesystem::resize_file(path_, valid_size);
+            ofs_.open(path_, std::ios::binary | std::ios::app);
+        } else {
+            ofs_.open(path_, std::ios::binary | std::ios::trunc);
+            format::file_header header{};
+            std::memcpy(header.magic, format::magic, sizeof(format::magic));
+            header.version = format::version;
+            write_pod(ofs_, header);
+        }
+        DCHECK_F(ofs_.is_open(), "Failed to open: [%s]", path_.string().c_str());
+    }
+
+    tick_store_writer::~tick_store_writer() noexcept
+    {
+        try {
+            flush();
+        }
+        catch (const std::exception &error) {
+            VLOG_F(loguru::Verbosity_ERROR, "flushing tick store failed: %s", error.what());
+        }
+    }
+
+    void tick_store_writer::append(std::chrono::microseconds timestamp, const antara::pair &pair, st_price price,
+                                   const std::optional<book_snapshot> &book)
+    {
+        std::scoped_lock lock(mutex_);
+        timestamps_.push_back(timestamp.count());
+        price_lo_.push_back(absl::Uint128Low64(price.value()));
+        price_hi_.push_back(absl::Uint128High64(price.value()));
+        pair_column_.push_back(intern(pair));
+        if (book.has_value()) {
+            book_offsets_.push_back(static_cast<std::uint32_t>(books_.size()));
+            format::book_record record{static_cast<std::uint32_t>(book->bids.size()),
+                                       static_cast<std::uint32_t>(book->asks.size())};
+            append_bytes(books_, &record, sizeof(record));
+            for (auto &&level : book->bids) {
+                append_level(books_, level);
+            }
+            for (auto &&level : book->asks) {
+                append_level(books_, level);
+            }
+        } else {
+            book_offsets_.push_back(format::no_book);
+        }
+        if (timestamps_.size() >= rows_per_block_) {
+            write_pending_pairs();
+            write_pending_ticks();
+            ofs_.flush();
+        }
+    }
+
+    void tick_store_writer::append(const tick &current_tick)
+    {
+        append(current_tick.timestamp, current_tick.pair, current_tick.price, current_tick.book);
+    }
+
+    void tick_store_writer::flush()
+    {
+        std::scoped_lock lock(mutex_);
+        write_pending_pairs();
+        write_pending_ticks();
+        ofs_.flush();
+    }
+
+    std::size_t tick_store_writer::nb_pending_rows() const
+    {
+        std::scoped_lock lock(mutex_);
+        return timestamps_.size();
+    }
+
+    pair_id tick_store_writer::intern(const antara::pair &pair)
+    {
+        if (auto it = pair_ids_.find(pair); it != pair_ids_.end()) {
+            return it->second;
+        }
+        auto id = static_cast<pair_id>(pair_ids_.size());
+        pair_ids_.emplace(pair, id);
+        pending_pairs_.emplace_back(id, pair_to_string(pair));
+        return id;
+    }
+
+    void tick_store_writer::write_pending_pairs()
+    {
+        if (pending_pairs_.empty()) {
+            return;
+        }
+        std::vector<std::byte> payload;
+        for (auto &&[id, name] : pending_pairs_) {
+            auto length = static_cast<std::uint32_t>(name.size());
+            append_bytes(payload, &id, sizeof(id));
+            append_bytes(payload, &length, sizeof(length));
+            append_bytes(payload, name.data(), name.size());
+            payload.resize(align8(payload.size()));
+        }
+        write_pod(ofs_, format::block_header{format::block_kind::pairs,
+                                             static_cast<std::uint32_t>(pending_pairs_.size()), payload.size()});
+        ofs_.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        pending_pairs_.clear();
+    }
+
+    void tick_store_writer::write_pending_ticks()
+    {
+        if (timestamps_.empty()) {
+            return;
+        }
+        const auto nb_rows = timestamps_.size();
+        write_pod(ofs_, format::block_header{format::block_kind::ticks, static_cast<std::uint32_t>(nb_rows),
+                                             ticks_columns_size(nb_rows) + books_.size()});
+        write_column(ofs_, timestamps_);
+        write_column(ofs_, price_lo_);
+        write_column(ofs_, price_hi_);
+        write_column(ofs_, pair_column_);
+        write_column(ofs_, book_offsets_);
+        write_column(ofs_, books_);
+        timestamps_.clear();
+        price_lo_.clear();
+        price_hi_.clear();
+        pair_column_.clear();
+        book_offsets_.clear();
+        books_.clear();
+    }
+
+    bool is_tick_store(const std::filesystem::path &path)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        char magic[sizeof(format::magic)] = {};
+        ifs.read(magic, sizeof(magic));
+        return ifs.gcount() == sizeof(magic) && std::memcmp(magic, format::magic, sizeof(magic)) == 0;
+    }
+}
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <utils/antara.mapped.file.hpp>
+#include <utils/mmbot_strong_types.hpp>
+
+namespace antara::mmbot::tickstore
+{
+    using pair_id = std::uint32_t;
+
+    struct book_level
+    {
+        st_price price;
+        st_quantity quantity;
+    };
+
+    struct book_snapshot
+    {
+        std::vector<book_level> bids;
+        std::vector<book_level> asks;
+    };
+
+    struct tick
+    {
+        std::chrono::microseconds timestamp;
+        antara::pair pair;
+        st_price price;
+        std::optional<book_snapshot> book{std::nullopt};
+    };
+
+    /**
+     * @brief On-disk layout of a tick store, every structure is 8 bytes aligned and stored in native byte order.
+     *
+     *        file   := file_header block*
+     *        block  := block_header payload
+     *        pairs  payload := (pair_id, length, "BASE/QUOTE", padding)*
+     *        ticks  payload := timestamps[n] price_lo[n] price_hi[n] pair_ids[n] book_offsets[n] books
+     *
+     *        A book offset is the byte offset of a book_record inside the books section of its block, or `no_book`.
+     *        A book_record is followed by nb_bids then nb_asks level_records.
+     */
+    namespace format
+    {
+        inline constexpr char magic[8] = {'M', 'M', 'B', 'T', 'I', 'C', 'K', 'S'};
+        inline constexpr std::uint32_t version = 1;
+        inline constexpr std::uint32_t no_book = std::numeric_limits<std::uint32_t>::max();
+
+        enum class block_kind : std::uint32_t
+        {
+            pairs = 1,
+            ticks = 2
+        };
+
+        struct file_header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t reserved;
+        };
+
+        struct block_header
+        {
+            block_kind kind;
+            std::uint32_t nb_rows;
+            std::uint64_t payload_size;
+        };
+
+        struct book_record
+        {
+            std::uint32_t nb_bids;
+            std::uint32_t nb_asks;
+        };
+
+        struct level_record
+        {
+            std::uint64_t price_lo;
+            std::uint64_t price_hi;
+            double quantity;
+        };
+
+        static_assert(sizeof(file_header) == 16);
+        static_assert(sizeof(block_header) == 16);
+        static_assert(sizeof(book_record) == 8);
+        static_assert(sizeof(level_record) == 24);
+    }
+
+    //! Zero-copy view on a book snapshot living inside a mapped block.
+    class book_view
+    {
+    public:
+        book_view(const format::book_record *record) noexcept;
+
+        [[nodiscard]] std::size_t nb_bids() const noexcept;
+
+        [[nodiscard]] std::size_t nb_asks() const noexcept;
+
+        [[nodiscard]] book_level bid(std::size_t idx) const noexcept;
+
+        [[nodiscard]] book_level ask(std::size_t idx) const noexcept;
+
+        [[nodiscard]] book_snapshot materialize() const;
+
+    private:
+        const format::book_record *record_;
+        const format::level_record *levels_;
+    };
+
+    //! Zero-copy view on the columns of one block of ticks.
+    class tick_block_view
+    {
+    public:
+        tick_block_view(const std::byte *payload, std::size_t nb_rows) noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        [[nodiscard]] std::chrono::microseconds timestamp(std::size_t row) const noexcept;
+
+        [[nodiscard]] pair_id pair(std::size_t row) const noexcept;
+
+        [[nodiscard]] st_price price(std::size_t row) const noexcept;
+
+        [[nodiscard]] bool has_book(std::size_t row) const noexcept;
+
+        [[nodiscard]] book_view book(std::size_t row) const noexcept;
+
+        //! raw columns, for scans that don't need to decode every field.
+        [[nodiscard]] const std::int64_t *timestamps() const noexcept;
+
+        [[nodiscard]] const pair_id *pair_ids() const noexcept;
+
+    private:
+        std::size_t nb_rows_;
+        const std::int64_t *timestamps_;
+        const std::uint64_t *price_lo_;
+        const std::uint64_t *price_hi_;
+        const pair_id *pair_ids_;
+        const std::uint32_t *book_offsets_;
+        const std::byte *books_;
+    };
+
+    class tick_store_reader
+    {
+    public:
+        explicit tick_store_reader(const std::filesystem::path &path);
+
+        //! false if the file doesn't exist or is not a tick store.
+        [[nodiscard]] bool is_valid() const noexcept;
+
+        //! size of the prefix of the file made of complete blocks, a torn tail left by a crash is ignored.
+        [[nodiscard]] std::size_t valid_size() const noexcept;
+
+        [[nodiscard]] const std::vector<tick_block_view> &blocks() const noexcept;
+
+        [[nodiscard]] std::size_t nb_ticks() const noexcept;
+
+        [[nodiscard]] const antara::pair &pair_of(pair_id id) const;
+
+        [[nodiscard]] const std::unordered_map<antara::pair, pair_id> &pairs() const noexcept;
+
+        template<typename Functor>
+        void for_each(Functor &&functor) const
+        {
+            for (auto &&block : blocks_) {
+                for (std::size_t row = 0; row < block.size(); ++row) {
+                    functor(block, row);
+                }
+            }
+        }
+
+        [[nodiscard]] std::vector<tick> load() const;
+
+    private:
+        mapped_file file_;
+        bool valid_{false};
+        std::size_t valid_size_{0};
+        std::size_t nb_ticks_{0};
+        std::vector<tick_block_view> blocks_;
+        std::unordered_map<pair_id, antara::pair> pairs_by_id_;
+        std::unordered_map<antara::pair, pair_id> ids_by_pair_;
+    };
+
+    /**
+     * @brief Append-only writer, rows are buffered column by column and written as one block every `rows_per_block`
+     *        rows or on flush. Reopening an existing store keeps its pair dictionary and drops a torn tail.
+     */
+    class tick_store_writer
+    {
+    public:
+        explicit tick_store_writer(std::filesystem::path path, std::size_t rows_per_block = 4096);
+
+        ~tick_store_writer() noexcept;
+
+        void append(std::chrono::microseconds timestamp, const antara::pair &pair, st_price price,
+                    const std::optional<book_snapshot> &book = std::nullopt);
+
+        void append(const tick &current_tick);
+
+        void flush();
+
+        [[nodiscard]] std::size_t nb_pending_rows() const;
+
+    private:
+        pair_id intern(const antara::pair &pair);
+
+        void write_pending_pairs();
+
+        void write_pending_ticks();
+
+        std::filesystem::path path_;
+        std::size_t rows_per_block_;
+        std::ofstream ofs_;
+        mutable std::mutex mutex_;
+        std::unordered_map<antara::pair, pair_id> pair_ids_;
+        std::vector<std::pair<pair_id, std::string>> pending_pairs_;
+        std::vector<std::int64_t> timestamps_;
+        std::vector<std::uint64_t> price_lo_;
+        std::vector<std::uint64_t> price_hi_;
+        std::vector<pair_id> pair_column_;
+        std::vector<std::uint32_t> book_offsets_;
+        std::vector<std::byte> books_;
+    };
+
+    //! `true` if the file starts with the tick store magic.
+    bool is_tick_store(const std::filesystem::path &path);
+}
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <doctest/doctest.h>
+#include <backtest/backtest.engine.hpp>
+#include "tick.store.hpp"
+
+namespace antara::mmbot::tests
+{
+    struct tick_store_fixture
+    {
+        tick_store_fixture()
+        {
+            std::filesystem::remove(path);
+        }
+
+        ~tick_store_fixture()
+        {
+            std::filesystem::remove(path);
+        }
+
+        std::filesystem::path path{std::filesystem::temp_directory_path() / "mmbot_tests.ticks"};
+    };
+
+    TEST_CASE_FIXTURE(tick_store_fixture, "ticks written to a store can be read back without copies")
+    {
+        auto kmd_btc = antara::pair::of("BTC", "KMD");
+        auto eth_usd = antara::pair::of("USD", "ETH");
+        absl::uint128 big_price = absl::MakeUint128(3, 42);
+        {
+            tickstore::tick_store_writer writer(path, 2);
+            writer.append(std::chrono::microseconds{1}, kmd_btc, st_price{100});
+            writer.append(std::chrono::microseconds{2}, eth_usd, st_price{big_price},
+                          tickstore::book_snapshot{{{st_price{99}, st_quantity{1.5}}},
+                                                   {{st_price{101}, st_quantity{2}},
+                                                    {st_price{102}, st_quantity{3}}}});
+            CHECK_EQ(0, writer.nb_pending_rows());
+            writer.append(std::chrono::microseconds{3}, kmd_btc, st_price{105});
+            CHECK_EQ(1, writer.nb_pending_rows());
+        }
+        CHECK(tickstore::is_tick_store(path));
+
+        tickstore::tick_store_reader reader(path);
+        REQUIRE(reader.is_valid());
+        CHECK_EQ(3, reader.nb_ticks());
+        REQUIRE_EQ(2, reader.blocks().size());
+        CHECK_EQ(std::filesystem::file_size(path), reader.valid_size());
+
+        auto &&first = reader.blocks().front();
+        CHECK_EQ(kmd_btc, reader.pair_of(first.pair(0)));
+        CHECK_EQ(st_price{100}, first.price(0));
+        CHECK_FALSE(first.has_book(0));
+        CHECK_EQ(eth_usd, reader.pair_of(first.pair(1)));
+        CHECK_EQ(st_price{big_price}, first.price(1));
+        REQUIRE(first.has_book(1));
+        auto book = first.book(1);
+        CHECK_EQ(1, book.nb_bids());
+        CHECK_EQ(2, book.nb_asks());
+        CHECK_EQ(st_price{99}, book.bid(0).price);
+        CHECK_EQ(st_quantity{3}, book.ask(1).quantity);
+
+        auto ticks = reader.load();
+        REQUIRE_EQ(3, ticks.size());
+        CHECK_EQ(std::chrono::microseconds{3}, ticks[2].timestamp);
+        CHECK_EQ(st_price{105}, ticks[2].price);
+    }
+
+    TEST_CASE_FIXTURE(tick_store_fixture, "a store can be reopened for append and ignores a torn tail")
+    {
+        auto kmd_btc = antara::pair::of("BTC", "KMD");
+        {
+            tickstore::tick_store_writer writer(path);
+            writer.append(std::chrono::microseconds{1}, kmd_btc, st_price{100});
+        }
+        auto valid_size = std::filesystem::file_size(path);
+        {
+            std::ofstream ofs(path, std::ios::binary | std::ios::app);
+            ofs << "torn";
+        }
+        CHECK_EQ(valid_size, tickstore::tick_store_reader(path).valid_size());
+        {
+            tickstore::tick_store_writer writer(path);
+            writer.append(std::chrono::microseconds{2}, kmd_btc, st_price{110});
+            writer.append(std::chrono::microseconds{3}, antara::pair::of("USD", "ETH"), st_price{200});
+        }
+        tickstore::tick_store_reader reader(path);
+        auto ticks = reader.load();
+        REQUIRE_EQ(3, ticks.size());
+        CHECK_EQ(2, reader.pairs().size());
+        CHECK_EQ(kmd_btc, ticks[1].pair);
+        CHECK_EQ(antara::pair::of("USD", "ETH"), ticks[2].pair);
+    }
+
+    TEST_CASE_FIXTURE(tick_store_fixture, "a block whose entries run past its payload is ignored as torn")
+    {
+        auto kmd_btc = antara::pair::of("BTC", "KMD");
+        {
+            tickstore::tick_store_writer writer(path);
+            writer.append(std::chrono::microseconds{1}, kmd_btc, st_price{100},
+                          tickstore::book_snapshot{{{st_price{99}, st_quantity{1}}}, {}});
+        }
+        const auto pairs_offset = sizeof(tickstore::format::file_header);
+        tickstore::format::block_header pairs_block{};
+        {
+            std::ifstream ifs(path, std::ios::binary);
+            ifs.seekg(pairs_offset);
+            ifs.read(reinterpret_cast<char *>(&pairs_block), sizeof(pairs_block));
+        }
+        REQUIRE_EQ(tickstore::format::block_kind::pairs, pairs_block.kind);
+        const auto ticks_offset = pairs_offset + sizeof(pairs_block) + pairs_block.payload_size;
+        auto overwrite = [this](std::size_t offset, std::uint32_t value) {
+            std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out);
+            fs.seekp(static_cast<std::streamoff>(offset));
+            fs.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        };
+
+        SUBCASE ("a pair name longer than the block") {
+            overwrite(pairs_offset + sizeof(pairs_block) + sizeof(std::uint32_t), 1u << 20u);
+            tickstore::tick_store_reader reader(path);
+            REQUIRE(reader.is_valid());
+            CHECK_EQ(pairs_offset, reader.valid_size());
+            CHECK(reader.pairs().empty());
+            CHECK_EQ(0, reader.nb_ticks());
+        }
+
+        SUBCASE ("a book offset past the books column") {
+            //! one row: timestamps, price_lo and price_hi, then the pair ids padded to 8 bytes, then the book offsets.
+            overwrite(ticks_offset + sizeof(tickstore::format::block_header) + 4 * sizeof(std::uint64_t), 1024u);
+            tickstore::tick_store_reader reader(path);
+            CHECK_EQ(ticks_offset, reader.valid_size());
+            CHECK_EQ(1, reader.pairs().size());
+            CHECK_EQ(0, reader.nb_ticks());
+        }
+
+        SUBCASE ("a book with more levels than the books column") {
+            overwrite(ticks_offset + sizeof(tickstore::format::block_header) + 5 * sizeof(std::uint64_t), 1000u);
+            CHECK_EQ(ticks_offset, tickstore::tick_store_reader(path).valid_size());
+        }
+    }
+
+    TEST_CASE_FIXTURE(tick_store_fixture, "a backtest can replay a tick store")
+    {
+        auto pair = antara::pair::of("B", "A");
+        {
+            tickstore::tick_store_writer writer(path);
+            writer.append(std::chrono::microseconds{0}, pair, st_price{100},
+                          tickstore::book_snapshot{{{st_price{98}, st_quantity{1}}}, {{st_price{102}, st_quantity{2}}}});
+            writer.append(std::chrono::microseconds{10}, pair, st_price{120});
+        }
+        auto ticks = backtest::load_ticks(path);
+        REQUIRE_EQ(2, ticks.size());
+        REQUIRE(ticks[0].book.has_value());
+        CHECK_EQ(st_price{98}, ticks[0].book.value().best_bid);
+        CHECK_EQ(st_quantity{2}, ticks[0].book.value().ask_quantity);
+        CHECK_FALSE(ticks[1].book.has_value());
+    }
+}
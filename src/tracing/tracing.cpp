@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tracing.hpp"
+
+namespace
+{
+    struct span_slot
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<std::uint64_t> start_ns{0};
+        std::atomic<std::uint64_t> end_ns{0};
+    };
+
+    //! single producer (its thread), read by the dumper with relaxed loads, a span being overwritten may be torn.
+    struct thread_ring
+    {
+        std::array<span_slot, antara::mmbot::tracing::ring_capacity> slots{};
+        std::atomic<std::uint64_t> head{0};
+        std::size_t thread_id{0};
+        std::string thread_name;
+    };
+
+    struct trace_registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_ring>> rings;
+    };
+
+    trace_registry &get_trace_registry()
+    {
+        static trace_registry registry;
+        return registry;
+    }
+
+    std::atomic_bool tracing_enabled{false};
+
+    thread_ring &current_ring()
+    {
+        thread_local std::shared_ptr<thread_ring> ring = []() {
+            auto new_ring = std::make_shared<thread_ring>();
+            auto &registry = get_trace_registry();
+            std::scoped_lock lock(registry.mutex);
+            new_ring->thread_id = registry.rings.size() + 1;
+            new_ring->thread_name = "thread " + std::to_string(new_ring->thread_id);
+            registry.rings.push_back(new_ring);
+            return new_ring;
+        }();
+        return *ring;
+    }
+}
+
+namespace antara::mmbot::tracing
+{
+    bool is_enabled() noexcept
+    {
+        return tracing_enabled.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled) noexcept
+    {
+        tracing_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    std::uint64_t now_ns() noexcept
+    {
+        static const auto origin = std::chrono::steady_clock::now();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - origin).count());
+    }
+
+    void record(const char *name, std::uint64_t start_ns, std::uint64_t end_ns) noexcept
+    {
+        auto &ring = current_ring();
+        auto head = ring.head.load(std::memory_order_relaxed);
+        auto &slot = ring.slots[head % ring_capacity];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    void set_thread_name(const char *name)
+    {
+        auto &ring = current_ring();
+        std::scoped_lock lock(get_trace_registry().mutex);
+        ring.thread_name = name;
+    }
+
+    void clear() noexcept
+    {
+        auto &registry = get_trace_registry();
+        std::scoped_lock lock(registry.mutex);
+        for (auto &&ring : registry.rings) {
+            for (auto &&slot : ring->slots) {
+                slot.name.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    nlohmann::json dump_chrome_trace()
+    {
+        nlohmann::json events = nlohmann::json::array();
+        auto &registry = get_trace_registry();
+        std::scoped_lock lock(registry.mutex);
+        for (auto &&ring : registry.rings) {
+            events.push_back({{"name", "thread_name"},
+                              {"ph",   "M"},
+                              {"pid",  1},
+                              {"tid",  ring->thread_id},
+                              {"args", {{"name", ring->thread_name}}}});
+            auto head = ring->head.load(std::memory_order_acquire);
+            auto first = head > ring_capacity ? head - ring_capacity : 0;
+            for (auto idx = first; idx < head; ++idx) {
+                auto &slot = ring->slots[idx % ring_capacity];
+                auto name = slot.name.load(std::memory_order_relaxed);
+                if (name == nullptr) {
+                    continue;
+                }
+                auto start_ns = slot.start_ns.load(std::memory_order_relaxed);
+                auto end_ns = std::max(slot.end_ns.load(std::memory_order_relaxed), start_ns);
+                events.push_back({{"name", name},
+                                  {"ph",   "X"},
+                                  {"pid",  1},
+                                  {"tid",  ring->thread_id},
+                                  {"ts",   static_cast<double>(start_ns) / 1000.0},
+                                  {"dur",  static_cast<double>(end_ns - start_ns) / 1000.0}});
+            }
+        }
+        return {{"traceEvents", std::move(events)}, {"displayTimeUnit", "ns"}};
+    }
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <utils/pretty_function.hpp>
+
+namespace antara::mmbot::tracing
+{
+    //! number of spans kept per thread, older spans are overwritten.
+    inline constexpr std::size_t ring_capacity = 16384;
+
+    bool is_enabled() noexcept;
+
+    void set_enabled(bool enabled) noexcept;
+
+    //! nanoseconds since the first call, the time base of every span.
+    std::uint64_t now_ns() noexcept;
+
+    //! Append a finished span to the ring buffer of the calling thread, `name` must outlive the process.
+    void record(const char *name, std::uint64_t start_ns, std::uint64_t end_ns) noexcept;
+
+    //! Give a name to the calling thread in the dumps.
+    void set_thread_name(const char *name);
+
+    //! Drop every recorded span.
+    void clear() noexcept;
+
+    //! Chrome trace event format, loads in chrome://tracing and Perfetto.
+    nlohmann::json dump_chrome_trace();
+
+    class scope
+    {
+    public:
+        explicit scope(const char *name) noexcept : name_(is_enabled() ? name : nullptr),
+                                                    start_ns_(name_ != nullptr ? now_ns() : 0)
+        {
+        }
+
+        ~scope() noexcept
+        {
+            if (name_ != nullptr) {
+                record(name_, start_ns_, now_ns());
+            }
+        }
+
+        scope(const scope &) = delete;
+
+        scope &operator=(const scope &) = delete;
+
+    private:
+        const char *name_;
+        std::uint64_t start_ns_;
+    };
+}
+
+#define MMBOT_TRACE_CAT_IMPL(a, b) a##b
+#define MMBOT_TRACE_CAT(a, b) MMBOT_TRACE_CAT_IMPL(a, b)
+
+#ifdef MMBOT_ENABLE_TRACING
+#define MMBOT_TRACE_SCOPE(name) const antara::mmbot::tracing::scope MMBOT_TRACE_CAT(mmbot_trace_scope_, __LINE__)(name)
+#else
+#define MMBOT_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#define MMBOT_TRACE_FUNCTION() MMBOT_TRACE_SCOPE(pretty_function)
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <thread>
+#include <doctest/doctest.h>
+#include "tracing.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("spans are only recorded while tracing is enabled")
+    {
+        tracing::clear();
+        tracing::set_enabled(false);
+        {
+            tracing::scope span("disabled span");
+        }
+        tracing::set_enabled(true);
+        {
+            tracing::scope span("enabled span");
+        }
+        std::thread([]() {
+            tracing::set_thread_name("tracing test thread");
+            tracing::scope span("span from another thread");
+        }).join();
+        tracing::set_enabled(false);
+
+        auto trace = tracing::dump_chrome_trace().dump();
+        CHECK_EQ(std::string::npos, trace.find("disabled span"));
+        CHECK_NE(std::string::npos, trace.find("\"name\":\"enabled span\""));
+        CHECK_NE(std::string::npos, trace.find("span from another thread"));
+        CHECK_NE(std::string::npos, trace.find("tracing test thread"));
+
+        tracing::clear();
+        CHECK_EQ(std::string::npos, tracing::dump_chrome_trace().dump().find("enabled span"));
+    }
+
+    TEST_CASE ("the ring buffer keeps the most recent spans")
+    {
+        tracing::clear();
+        std::thread([]() {
+            for (std::size_t idx = 0; idx < tracing::ring_capacity + 10; ++idx) {
+                tracing::record(idx < 10 ? "oldest" : "newest", idx, idx + 1);
+            }
+        }).join();
+        auto trace = tracing::dump_chrome_trace().dump();
+        CHECK_EQ(std::string::npos, trace.find("oldest"));
+        CHECK_NE(std::string::npos, trace.find("newest"));
+        tracing::clear();
+    }
+}
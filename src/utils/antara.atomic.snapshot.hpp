@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace antara
+{
+    /**
+     * @brief Immutable versions of a value published atomically. Readers take a plain reference with a single
+     *        acquire load and never lock; a replaced version stays alive for `grace` after it is replaced and is
+     *        freed by a later publish. A reader using a version longer than that holds it with load() instead.
+     */
+    template<typename T>
+    class atomic_snapshot
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit atomic_snapshot(T initial = T{}, clock::duration grace = std::chrono::seconds{60}) : grace_(grace)
+        {
+            publish(std::move(initial));
+        }
+
+        atomic_snapshot(const atomic_snapshot &) = delete;
+
+        atomic_snapshot &operator=(const atomic_snapshot &) = delete;
+
+        //! valid until `grace` after the version is replaced.
+        [[nodiscard]] const T &get() const noexcept
+        {
+            return *current_.load(std::memory_order_acquire);
+        }
+
+        //! the current version, kept alive as long as it is held.
+        [[nodiscard]] std::shared_ptr<const T> load() const
+        {
+            std::scoped_lock lock(publish_mutex_);
+            return versions_.back().value;
+        }
+
+        //! 1 for the initial value, incremented by every publish.
+        [[nodiscard]] std::uint64_t version() const noexcept
+        {
+            return version_.load(std::memory_order_acquire);
+        }
+
+        //! publishers are serialized between them, returns the version of the published value.
+        std::uint64_t publish(T value)
+        {
+            auto published = std::make_shared<const T>(std::move(value));
+            std::scoped_lock lock(publish_mutex_);
+            const auto now = clock::now();
+            if (!versions_.empty()) {
+                versions_.back().replaced_at = now;
+            }
+            //! replaced in order, the oldest are at the front.
+            while (!versions_.empty() && versions_.front().replaced_at.has_value() &&
+                   versions_.front().replaced_at.value() + grace_ <= now) {
+                versions_.pop_front();
+            }
+            versions_.push_back(version_entry{published, std::nullopt});
+            current_.store(published.get(), std::memory_order_release);
+            return version_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        }
+
+    private:
+        struct version_entry
+        {
+            std::shared_ptr<const T> value;
+            std::optional<clock::time_point> replaced_at;
+        };
+
+        clock::duration grace_;
+        std::atomic<const T *> current_{nullptr};
+        std::atomic<std::uint64_t> version_{0};
+        mutable std::mutex publish_mutex_;
+        std::deque<version_entry> versions_;
+    };
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "antara.atomic.snapshot.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("atomic snapshot keeps the published versions readable")
+    {
+        antara::atomic_snapshot<std::string> snapshot("first");
+        CHECK_EQ(1, snapshot.version());
+        const auto &first = snapshot.get();
+        CHECK_EQ(2, snapshot.publish("second"));
+        CHECK_EQ("second", snapshot.get());
+        CHECK_EQ("first", first);
+    }
+
+    TEST_CASE ("atomic snapshot frees the versions replaced for longer than the grace period")
+    {
+        antara::atomic_snapshot<std::string> snapshot("first", std::chrono::milliseconds{20});
+        std::weak_ptr<const std::string> first = snapshot.load();
+        auto held = snapshot.load();
+        snapshot.publish("second");
+        CHECK_FALSE(first.expired());
+        std::this_thread::sleep_for(std::chrono::milliseconds{30});
+        std::weak_ptr<const std::string> second = snapshot.load();
+        snapshot.publish("third");
+        CHECK_FALSE(first.expired());
+        CHECK_EQ("first", *held);
+        held.reset();
+        CHECK(first.expired());
+        CHECK_FALSE(second.expired());
+        CHECK_EQ("third", snapshot.get());
+    }
+
+    TEST_CASE ("atomic snapshot readers see complete versions while publishing")
+    {
+        antara::atomic_snapshot<std::vector<int>> snapshot(std::vector<int>(64, 0));
+        std::atomic_bool done{false};
+        std::atomic_size_t nb_torn{0};
+        std::vector<std::thread> readers;
+        for (int idx = 0; idx < 4; ++idx) {
+            readers.emplace_back([&snapshot, &done, &nb_torn]() {
+                while (!done) {
+                    const auto &values = snapshot.get();
+                    for (auto &&value : values) {
+                        if (value != values.front()) {
+                            ++nb_torn;
+                        }
+                    }
+                }
+            });
+        }
+        for (int version = 1; version <= 200; ++version) {
+            snapshot.publish(std::vector<int>(64, version));
+        }
+        done = true;
+        for (auto &&reader : readers) {
+            reader.join();
+        }
+        CHECK_EQ(0, nb_torn);
+        CHECK_EQ(201, snapshot.version());
+        CHECK_EQ(200, snapshot.get().back());
+    }
+}
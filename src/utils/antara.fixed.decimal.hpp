@@ -0,0 +1,267 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <absl/numeric/int128.h>
+
+namespace antara
+{
+    //! down and up are toward and away from zero, half_up rounds the ties away from zero.
+    enum class rounding
+    {
+        down, up, half_up
+    };
+
+    namespace details
+    {
+        constexpr std::int64_t pow10_i64(unsigned exponent) noexcept
+        {
+            return exponent == 0 ? 1 : 10 * pow10_i64(exponent - 1);
+        }
+
+        template<typename Int>
+        constexpr bool is_negative(Int value) noexcept
+        {
+            if constexpr (std::numeric_limits<Int>::is_signed) {
+                return value < Int(0);
+            } else {
+                return false;
+            }
+        }
+
+        //! numerator / denominator rounded with `mode`, denominator must be positive.
+        template<typename Int>
+        constexpr Int divide_rounded(Int numerator, Int denominator, rounding mode) noexcept
+        {
+            Int quotient = numerator / denominator;
+            Int remainder = numerator % denominator;
+            if (remainder == Int(0) || mode == rounding::down) {
+                return quotient;
+            }
+            const Int away = is_negative(numerator) ? Int(-1) : Int(1);
+            if (mode == rounding::up) {
+                return quotient + away;
+            }
+            const Int abs_remainder = is_negative(remainder) ? -remainder : remainder;
+            return abs_remainder >= denominator - abs_remainder ? quotient + away : quotient;
+        }
+    }
+
+    /**
+     * @brief Signed decimal number with `Decimals` digits after the point, stored as an integer of 10^-Decimals.
+     *        Additions are exact, products and quotients are rounded with an explicit mode, overflows throw
+     *        std::overflow_error. Doubles and strings are only meant for the boundaries (config, json, logs).
+     */
+    template<unsigned Decimals>
+    class fixed_decimal
+    {
+        static_assert(Decimals <= 18, "the scale has to fit in 64 bits");
+
+    public:
+        using rep = std::int64_t;
+        static constexpr unsigned decimals = Decimals;
+        static constexpr rep scale = details::pow10_i64(Decimals);
+
+        constexpr fixed_decimal() noexcept = default;
+
+        //! rounded to the nearest representable value.
+        explicit fixed_decimal(double value)
+        {
+            const double scaled = std::round(value * static_cast<double>(scale));
+            if (!(std::fabs(scaled) < 9.2e18)) {
+                throw std::overflow_error("fixed_decimal: " + std::to_string(value) + " is out of range");
+            }
+            raw_ = static_cast<rep>(scaled);
+        }
+
+        static constexpr fixed_decimal from_raw(rep raw) noexcept
+        {
+            fixed_decimal result;
+            result.raw_ = raw;
+            return result;
+        }
+
+        static constexpr fixed_decimal one() noexcept
+        {
+            return from_raw(scale);
+        }
+
+        //! exact for "-12.345" like strings, the digits beyond Decimals are rounded with `mode`.
+        static fixed_decimal from_string(std::string_view str, rounding mode = rounding::half_up)
+        {
+            bool negative = !str.empty() && str.front() == '-';
+            if (negative || (!str.empty() && str.front() == '+')) {
+                str.remove_prefix(1);
+            }
+            if (str.empty()) {
+                throw std::invalid_argument("fixed_decimal: empty string");
+            }
+            absl::int128 value = 0;
+            unsigned nb_decimals = 0;
+            bool after_point = false;
+            bool has_digits = false;
+            int first_dropped = -1;
+            bool dropped_non_zero = false;
+            for (const char current : str) {
+                if (current == '.' && !after_point) {
+                    after_point = true;
+                    continue;
+                }
+                if (current < '0' || current > '9') {
+                    throw std::invalid_argument("fixed_decimal: invalid number " + std::string(str));
+                }
+                has_digits = true;
+                if (after_point && nb_decimals == Decimals) {
+                    first_dropped = first_dropped < 0 ? current - '0' : first_dropped;
+                    dropped_non_zero = dropped_non_zero || current != '0';
+                    continue;
+                }
+                value = value * 10 + (current - '0');
+                if (value > std::numeric_limits<rep>::max()) {
+                    throw std::overflow_error("fixed_decimal: " + std::string(str) + " is out of range");
+                }
+                nb_decimals += after_point ? 1 : 0;
+            }
+            if (!has_digits) {
+                throw std::invalid_argument("fixed_decimal: invalid number " + std::string(str));
+            }
+            for (; nb_decimals < Decimals; ++nb_decimals) {
+                value *= 10;
+            }
+            const bool round_away = mode == rounding::up ? dropped_non_zero :
+                                    mode == rounding::half_up && first_dropped >= 5;
+            value += round_away ? 1 : 0;
+            return checked(negative ? -value : value);
+        }
+
+        [[nodiscard]] constexpr rep raw() const noexcept
+        {
+            return raw_;
+        }
+
+        [[nodiscard]] double to_double() const noexcept
+        {
+            return static_cast<double>(raw_) / static_cast<double>(scale);
+        }
+
+        [[nodiscard]] std::string to_string() const
+        {
+            const bool negative = raw_ < 0;
+            const auto magnitude = negative ? -static_cast<absl::int128>(raw_) : static_cast<absl::int128>(raw_);
+            std::string fractional = std::to_string(static_cast<std::uint64_t>(magnitude % scale));
+            fractional.insert(0, Decimals - fractional.size(), '0');
+            std::string result = negative ? "-" : "";
+            result += std::to_string(static_cast<std::uint64_t>(magnitude / scale));
+            if constexpr (Decimals > 0) {
+                result += '.' + fractional;
+            }
+            return result;
+        }
+
+        static fixed_decimal multiply(fixed_decimal lhs, fixed_decimal rhs, rounding mode)
+        {
+            return checked(details::divide_rounded<absl::int128>(absl::int128(lhs.raw_) * rhs.raw_, scale, mode));
+        }
+
+        static fixed_decimal divide(fixed_decimal lhs, fixed_decimal rhs, rounding mode)
+        {
+            if (rhs.raw_ == 0) {
+                throw std::domain_error("fixed_decimal: division by zero");
+            }
+            absl::int128 numerator = absl::int128(lhs.raw_) * scale;
+            absl::int128 denominator = rhs.raw_;
+            if (denominator < 0) {
+                numerator = -numerator;
+                denominator = -denominator;
+            }
+            return checked(details::divide_rounded<absl::int128>(numerator, denominator, mode));
+        }
+
+        friend fixed_decimal operator+(fixed_decimal lhs, fixed_decimal rhs)
+        {
+            return checked(absl::int128(lhs.raw_) + rhs.raw_);
+        }
+
+        friend fixed_decimal operator-(fixed_decimal lhs, fixed_decimal rhs)
+        {
+            return checked(absl::int128(lhs.raw_) - rhs.raw_);
+        }
+
+        friend fixed_decimal operator-(fixed_decimal value)
+        {
+            return checked(-absl::int128(value.raw_));
+        }
+
+        //! rounded half up, use multiply() to choose the mode.
+        friend fixed_decimal operator*(fixed_decimal lhs, fixed_decimal rhs)
+        {
+            return multiply(lhs, rhs, rounding::half_up);
+        }
+
+        friend fixed_decimal operator/(fixed_decimal lhs, fixed_decimal rhs)
+        {
+            return divide(lhs, rhs, rounding::half_up);
+        }
+
+        friend constexpr bool operator==(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ == rhs.raw_;
+        }
+
+        friend constexpr bool operator!=(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ != rhs.raw_;
+        }
+
+        friend constexpr bool operator<(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ < rhs.raw_;
+        }
+
+        friend constexpr bool operator<=(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ <= rhs.raw_;
+        }
+
+        friend constexpr bool operator>(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ > rhs.raw_;
+        }
+
+        friend constexpr bool operator>=(fixed_decimal lhs, fixed_decimal rhs) noexcept
+        {
+            return lhs.raw_ >= rhs.raw_;
+        }
+
+    private:
+        static fixed_decimal checked(absl::int128 raw)
+        {
+            if (raw > std::numeric_limits<rep>::max() || raw < std::numeric_limits<rep>::min()) {
+                throw std::overflow_error("fixed_decimal: overflow");
+            }
+            return from_raw(static_cast<rep>(raw));
+        }
+
+        rep raw_{0};
+    };
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <doctest/doctest.h>
+#include "antara.fixed.decimal.hpp"
+
+namespace antara::mmbot::tests
+{
+    using decimal6 = antara::fixed_decimal<6>;
+
+    TEST_CASE ("fixed decimal conversions")
+    {
+        CHECK_EQ(100000, decimal6(0.1).raw());
+        CHECK_EQ(1050000, decimal6(1.05).raw());
+        CHECK_EQ(1, decimal6(0.000001).raw());
+        CHECK_EQ(decimal6(0.0125), decimal6::from_string("0.0125"));
+        CHECK_EQ(-1500000, decimal6::from_string("-1.5").raw());
+        CHECK_EQ(3, decimal6::from_string("0.0000025").raw());
+        CHECK_EQ(2, decimal6::from_string("0.0000025", antara::rounding::down).raw());
+        CHECK_EQ(2, decimal6::from_string("0.0000020001", antara::rounding::half_up).raw());
+        CHECK_EQ(3, decimal6::from_string("0.0000020001", antara::rounding::up).raw());
+        CHECK_EQ("12.000500", decimal6::from_string("12.0005").to_string());
+        CHECK_EQ("-0.000001", decimal6::from_raw(-1).to_string());
+        CHECK_EQ(doctest::Approx(0.25), decimal6(0.25).to_double());
+        CHECK_THROWS_AS(decimal6::from_string("1.2.3"), std::invalid_argument);
+        CHECK_THROWS_AS(decimal6::from_string(""), std::invalid_argument);
+        CHECK_THROWS_AS(decimal6(1e20), std::overflow_error);
+    }
+
+    TEST_CASE ("fixed decimal arithmetic")
+    {
+        auto one = decimal6::one();
+        auto spread = decimal6(0.1);
+        CHECK_EQ(decimal6(0.9), one - spread);
+        CHECK_EQ(decimal6(1.1), one + spread);
+        CHECK_EQ(decimal6(0.01), spread * spread);
+        CHECK_EQ(decimal6::from_raw(333333), decimal6::divide(one, decimal6(3.0), antara::rounding::down));
+        CHECK_EQ(decimal6::from_raw(333334), decimal6::divide(one, decimal6(3.0), antara::rounding::up));
+        CHECK_EQ(decimal6::from_raw(666667), one / decimal6(1.5));
+        CHECK_EQ(decimal6::from_raw(-1), decimal6::multiply(decimal6::from_raw(-1), decimal6(0.5), antara::rounding::half_up));
+        CHECK_EQ(decimal6::from_raw(0), decimal6::multiply(decimal6::from_raw(-1), decimal6(0.5), antara::rounding::down));
+        CHECK_EQ(decimal6::from_raw(-2), decimal6::divide(decimal6::from_raw(3), decimal6(-2.0), antara::rounding::half_up));
+        CHECK(spread < one);
+        CHECK(-spread < decimal6{});
+        CHECK_THROWS_AS(one / decimal6{}, std::domain_error);
+        CHECK_THROWS_AS(decimal6::from_raw(std::numeric_limits<std::int64_t>::max()) + one, std::overflow_error);
+        CHECK_THROWS_AS(decimal6(1e6) * decimal6(1e9), std::overflow_error);
+    }
+}
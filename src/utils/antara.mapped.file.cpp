@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fstream>
+#include "antara.mapped.file.hpp"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MMBOT_HAS_MMAP 1
+#endif
+
+namespace antara
+{
+    mapped_file::mapped_file(const std::filesystem::path &path)
+    {
+#ifdef MMBOT_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st{};
+            if (::fstat(fd, &st) == 0) {
+                opened_ = true;
+                size_ = static_cast<std::size_t>(st.st_size);
+                if (size_ > 0) {
+                    void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr != MAP_FAILED) {
+                        data_ = static_cast<const std::byte *>(addr);
+                        mapped_ = true;
+                    } else {
+                        opened_ = false;
+                        size_ = 0;
+                    }
+                }
+            }
+            ::close(fd);
+        }
+        if (opened_) {
+            return;
+        }
+#endif
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open()) {
+            return;
+        }
+        opened_ = true;
+        fallback_.resize(static_cast<std::size_t>(ifs.tellg()));
+        ifs.seekg(0);
+        ifs.read(reinterpret_cast<char *>(fallback_.data()), static_cast<std::streamsize>(fallback_.size()));
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+    }
+
+    mapped_file::~mapped_file() noexcept
+    {
+#ifdef MMBOT_HAS_MMAP
+        if (mapped_) {
+            ::munmap(const_cast<std::byte *>(data_), size_);
+        }
+#endif
+    }
+
+    const std::byte *mapped_file::data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t mapped_file::size() const noexcept
+    {
+        return size_;
+    }
+
+    bool mapped_file::is_open() const noexcept
+    {
+        return opened_;
+    }
+}
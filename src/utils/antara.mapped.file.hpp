@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace antara
+{
+    //! Read-only view of a whole file, memory mapped where the platform allows it.
+    class mapped_file
+    {
+    public:
+        explicit mapped_file(const std::filesystem::path &path);
+
+        ~mapped_file() noexcept;
+
+        mapped_file(const mapped_file &) = delete;
+
+        mapped_file &operator=(const mapped_file &) = delete;
+
+        [[nodiscard]] const std::byte *data() const noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        [[nodiscard]] bool is_open() const noexcept;
+
+    private:
+        const std::byte *data_{nullptr};
+        std::size_t size_{0};
+        bool mapped_{false};
+        bool opened_{false};
+        std::vector<std::byte> fallback_;
+    };
+}
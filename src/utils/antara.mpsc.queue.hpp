@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace antara
+{
+    /**
+     * @brief Bounded lock-free queue for many producers and a single consumer (sequence numbered ring).
+     *        try_push never blocks and fails when the queue is full, it is up to the producer to drop or retry.
+     */
+    template<typename T>
+    class mpsc_queue
+    {
+    public:
+        //! capacity is rounded up to the next power of two.
+        explicit mpsc_queue(std::size_t capacity) : mask_(round_up_pow2(capacity) - 1),
+                                                    cells_(std::make_unique<cell[]>(mask_ + 1))
+        {
+            for (std::size_t idx = 0; idx <= mask_; ++idx) {
+                cells_[idx].sequence.store(idx, std::memory_order_relaxed);
+            }
+        }
+
+        mpsc_queue(const mpsc_queue &) = delete;
+
+        mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+        bool try_push(T &&value) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+            cell *current = nullptr;
+            for (;;) {
+                current = &cells_[pos & mask_];
+                const auto sequence = current->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            current->value = std::move(value);
+            current->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        //! must only be called from the consumer thread.
+        bool try_pop(T &out) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+            auto &current = cells_[pos & mask_];
+            if (current.sequence.load(std::memory_order_acquire) != pos + 1) {
+                return false;
+            }
+            out = std::move(current.value);
+            current.sequence.store(pos + mask_ + 1, std::memory_order_release);
+            dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return mask_ + 1;
+        }
+
+    private:
+        static std::size_t round_up_pow2(std::size_t value) noexcept
+        {
+            std::size_t result = 1;
+            while (result < value) {
+                result <<= 1u;
+            }
+            return result;
+        }
+
+        struct cell
+        {
+            std::atomic_size_t sequence{0};
+            T value{};
+        };
+
+        std::size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+        alignas(64) std::atomic_size_t enqueue_pos_{0};
+        alignas(64) std::atomic_size_t dequeue_pos_{0};
+    };
+}
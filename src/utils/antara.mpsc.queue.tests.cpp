@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <doctest/doctest.h>
+#include "antara.mpsc.queue.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("mpsc queue is bounded and keeps the order of a producer")
+    {
+        antara::mpsc_queue<std::string> queue(3);
+        CHECK_EQ(4, queue.capacity());
+        for (int idx = 0; idx < 4; ++idx) {
+            CHECK(queue.try_push(std::to_string(idx)));
+        }
+        CHECK_FALSE(queue.try_push("full"));
+        std::string out;
+        for (int idx = 0; idx < 4; ++idx) {
+            CHECK(queue.try_pop(out));
+            CHECK_EQ(std::to_string(idx), out);
+        }
+        CHECK_FALSE(queue.try_pop(out));
+        CHECK(queue.try_push("reused"));
+    }
+
+    TEST_CASE ("mpsc queue with concurrent producers")
+    {
+        antara::mpsc_queue<std::size_t> queue(1024);
+        constexpr std::size_t nb_producers = 4;
+        constexpr std::size_t nb_values = 10000;
+        std::vector<std::thread> producers;
+        for (std::size_t producer = 0; producer < nb_producers; ++producer) {
+            producers.emplace_back([&queue]() {
+                for (std::size_t value = 1; value <= nb_values;) {
+                    if (queue.try_push(std::size_t{value})) {
+                        ++value;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        std::size_t sum = 0;
+        std::size_t nb_popped = 0;
+        std::size_t value = 0;
+        while (nb_popped < nb_producers * nb_values) {
+            if (queue.try_pop(value)) {
+                sum += value;
+                ++nb_popped;
+            }
+        }
+        for (auto &&producer : producers) {
+            producer.join();
+        }
+        CHECK_EQ(nb_producers * nb_values * (nb_values + 1) / 2, sum);
+    }
+}
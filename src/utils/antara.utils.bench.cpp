@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils/antara.utils.hpp"
+
+namespace
+{
+    using namespace antara;
+
+    void BM_generate_st_price_from_api_price(benchmark::State &state, st_symbol symbol, std::string api_price)
+    {
+        const auto &cfg = mmbot::get_mmbot_config();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(generate_st_price_from_api_price(cfg, symbol, api_price));
+        }
+    }
+
+    void BM_get_price_as_string_decimal(benchmark::State &state, st_symbol symbol, st_symbol original_symbol,
+                                        std::string api_price)
+    {
+        const auto &cfg = mmbot::get_mmbot_config();
+        const auto price = generate_st_price_from_api_price(cfg, original_symbol, api_price);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(get_price_as_string_decimal(cfg, symbol, original_symbol, price));
+        }
+    }
+
+    void BM_get_price_as_string_decimal_by_id(benchmark::State &state, st_symbol symbol, st_symbol original_symbol,
+                                              std::string api_price)
+    {
+        const auto &cfg = mmbot::get_mmbot_config();
+        const auto coin = cfg.coin_scales.at(symbol.value());
+        const auto original_coin = cfg.coin_scales.at(original_symbol.value());
+        const auto price = generate_st_price_from_api_price(cfg, original_coin, api_price);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(get_price_as_string_decimal(cfg, coin, original_coin, price));
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_generate_st_price_from_api_price, btc, st_symbol{"BTC"}, "17999.204999999998");
+BENCHMARK_CAPTURE(BM_generate_st_price_from_api_price, eth, st_symbol{"ETH"}, "54.27638512030834");
+BENCHMARK_CAPTURE(BM_generate_st_price_from_api_price, scientific, st_symbol{"BTC"}, "1.2345e-05");
+BENCHMARK_CAPTURE(BM_get_price_as_string_decimal, eth, st_symbol{"ETH"}, st_symbol{"ETH"}, "54.27638512030834");
+BENCHMARK_CAPTURE(BM_get_price_as_string_decimal, eth_as_btc, st_symbol{"BTC"}, st_symbol{"ETH"},
+                  "54.27638512030834");
+BENCHMARK_CAPTURE(BM_get_price_as_string_decimal, zil, st_symbol{"ZIL"}, st_symbol{"ZIL"},
+                  "12345678.010089534999123456");
+BENCHMARK_CAPTURE(BM_get_price_as_string_decimal_by_id, eth_as_btc, st_symbol{"BTC"}, st_symbol{"ETH"},
+                  "54.27638512030834");
+BENCHMARK_CAPTURE(BM_get_price_as_string_decimal_by_id, zil, st_symbol{"ZIL"}, st_symbol{"ZIL"},
+                  "12345678.010089534999123456");
@@ -14,7 +14,7 @@
  *                                                                            *
  ******************************************************************************/
 
-#include <sstream>
+#include <array>
 #include "bcmath_stl.h"
 #include "antara.utils.hpp"
 
@@ -24,20 +24,52 @@ namespace antara
     get_price_as_string_decimal(const mmbot::config &cfg, const st_symbol &symbol, const st_symbol &original_symbol,
                                 st_price price) noexcept
     {
-        std::stringstream ss;
-        ss << price.value();
-        std::string price_str;
-        ss >> price_str;
-        return unformat_str_to_representation_price(cfg, symbol, original_symbol, price_str);
+        return get_price_as_string_decimal(cfg, cfg.coin_scales.at(symbol.value()),
+                                           cfg.coin_scales.at(original_symbol.value()), price);
+    }
+
+    std::string
+    get_price_as_string_decimal(const mmbot::config &cfg, mmbot::coin_id coin, mmbot::coin_id original_coin,
+                                st_price price) noexcept
+    {
+        //! integer split on the scale instead of printing the price and inserting the dot in the string.
+        const auto &scale = cfg.coin_scales[coin];
+        const auto &original_scale = cfg.coin_scales[original_coin];
+        absl::uint128 integer_part = price.value() / original_scale.scale;
+        absl::uint128 fractional_part = price.value() % original_scale.scale;
+
+        std::array<char, 40> buffer{};
+        auto integer_begin = buffer.end();
+        do {
+            *--integer_begin = static_cast<char>('0' + static_cast<int>(integer_part % 10));
+            integer_part /= 10;
+        } while (integer_part > 0);
+        std::string price_str(integer_begin, buffer.end());
+        price_str += '.';
+
+        const auto nb_fractional_digits = original_scale.nb_decimals;
+        for (std::size_t idx = nb_fractional_digits; idx > 0; --idx) {
+            buffer[idx - 1] = static_cast<char>('0' + static_cast<int>(fractional_part % 10));
+            fractional_part /= 10;
+        }
+        price_str.append(buffer.data(), std::min(nb_fractional_digits, scale.nb_decimals));
+        return price_str;
     }
 
     std::string
     unformat_str_to_representation_price(const mmbot::config &cfg, const st_symbol &symbol,
                                          const st_symbol &original_symbol, std::string price_str)
     {
+        return unformat_str_to_representation_price(cfg, cfg.coin_scales.at(symbol.value()),
+                                                    cfg.coin_scales.at(original_symbol.value()), std::move(price_str));
+    }
 
-        auto nb_decimal = static_cast<int>(cfg.registry_additional_coin_infos.at(symbol.value()).nb_decimals);
-        auto original_nb_decimal = static_cast<int>(cfg.registry_additional_coin_infos.at(original_symbol.value()).nb_decimals);
+    std::string
+    unformat_str_to_representation_price(const mmbot::config &cfg, mmbot::coin_id coin, mmbot::coin_id original_coin,
+                                         std::string price_str)
+    {
+        auto nb_decimal = static_cast<int>(cfg.coin_scales[coin].nb_decimals);
+        auto original_nb_decimal = static_cast<int>(cfg.coin_scales[original_coin].nb_decimals);
 
         while (static_cast<int>(price_str.length()) <= original_nb_decimal) {
             price_str.insert(0, 1, '0');
@@ -54,7 +86,12 @@ namespace antara
 
     std::string format_str_api_price(const mmbot::config &cfg, const st_symbol &symbol, std::string price_str)
     {
-        auto nb_decimal = static_cast<int>(cfg.registry_additional_coin_infos.at(symbol.value()).nb_decimals);
+        return format_str_api_price(cfg, cfg.coin_scales.at(symbol.value()), std::move(price_str));
+    }
+
+    std::string format_str_api_price(const mmbot::config &cfg, mmbot::coin_id coin, std::string price_str)
+    {
+        auto nb_decimal = static_cast<int>(cfg.coin_scales[coin].nb_decimals);
         auto after_decimal_str = price_str.substr(price_str.find('.') + 1, price_str.size());
         if (static_cast<int>(after_decimal_str.size()) > nb_decimal) {
             price_str = BCMath::bcround(price_str, nb_decimal);
@@ -76,9 +113,15 @@ namespace antara
 
     st_price
     generate_st_price_from_api_price(const mmbot::config &cfg, const st_symbol &symbol, std::string price_str) noexcept
+    {
+        return generate_st_price_from_api_price(cfg, cfg.coin_scales.at(symbol.value()), std::move(price_str));
+    }
+
+    st_price
+    generate_st_price_from_api_price(const mmbot::config &cfg, mmbot::coin_id coin, std::string price_str) noexcept
     {
         extract_if_scientific(price_str);
-        price_str = format_str_api_price(cfg, symbol, price_str);
+        price_str = format_str_api_price(cfg, coin, std::move(price_str));
         if (price_str.length() < 20) {
             return st_price{std::stoull(price_str)};
         }
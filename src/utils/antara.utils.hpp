@@ -28,15 +28,27 @@ namespace antara
     [[nodiscard]] std::string get_price_as_string_decimal(const mmbot::config &cfg, const st_symbol &symbol, const st_symbol& original_symbol,
                                                           st_price price) noexcept;
 
+    //! same as above with the ids of cfg.coin_scales, for the callers converting many prices of the same coins.
+    [[nodiscard]] std::string get_price_as_string_decimal(const mmbot::config &cfg, mmbot::coin_id coin,
+                                                          mmbot::coin_id original_coin, st_price price) noexcept;
+
     [[nodiscard]] st_price generate_st_price_from_api_price(const mmbot::config &cfg, const st_symbol &symbol,
                                                             std::string price_api_value) noexcept;
 
+    [[nodiscard]] st_price generate_st_price_from_api_price(const mmbot::config &cfg, mmbot::coin_id coin,
+                                                            std::string price_api_value) noexcept;
+
     std::string format_str_api_price(const mmbot::config &cfg, const st_symbol &symbol, std::string price_str);
 
+    std::string format_str_api_price(const mmbot::config &cfg, mmbot::coin_id coin, std::string price_str);
+
     void extract_if_scientific(std::string &price_str);
     std::string unformat_str_to_representation_price(const mmbot::config &cfg, const st_symbol &symbol, const st_symbol& original_symbol,
                                                      std::string price_str);
 
+    std::string unformat_str_to_representation_price(const mmbot::config &cfg, mmbot::coin_id coin,
+                                                     mmbot::coin_id original_coin, std::string price_str);
+
     static inline void ltrim(std::string &s, const std::string &delimiters = " \f\n\r\t\v")
     {
         s.erase(0, s.find_first_not_of(delimiters));
@@ -97,4 +97,23 @@ namespace antara::tests
         auto price = generate_st_price_from_api_price(cfg, st_symbol{"DOGE"}, "2.5319564650362795e-7");
         CHECK_EQ("0.00000025", get_price_as_string_decimal(cfg, st_symbol{"DOGE"}, st_symbol{"DOGE"}, price));
     }
-}
\ No newline at end of file
+
+    TEST_CASE("antara price conversions by coin id")
+    {
+        mmbot::load_mmbot_config(std::filesystem::current_path() / "assets", "mmbot_config.json");
+        const auto& cfg = antara::mmbot::get_mmbot_config();
+        const auto btc = cfg.coin_scales.at("BTC");
+        const auto eth = cfg.coin_scales.at("ETH");
+        const auto eur = cfg.coin_scales.at("EUR");
+        auto price = generate_st_price_from_api_price(cfg, eth, "54.27638512030834");
+        CHECK_EQ(price, generate_st_price_from_api_price(cfg, st_symbol{"ETH"}, "54.27638512030834"));
+        CHECK_EQ("54.276385120308340000", get_price_as_string_decimal(cfg, eth, eth, price));
+        CHECK_EQ("54.27638512", get_price_as_string_decimal(cfg, btc, eth, price));
+        CHECK_EQ("0.00000000", get_price_as_string_decimal(cfg, btc, btc, st_price{0ull}));
+        CHECK_EQ("0.00000001", get_price_as_string_decimal(cfg, btc, btc, st_price{1ull}));
+        CHECK_EQ("0.05", get_price_as_string_decimal(cfg, eur, eur, st_price{5ull}));
+        CHECK_EQ("0.00", get_price_as_string_decimal(cfg, eur, btc, st_price{1ull}));
+        CHECK_EQ(unformat_str_to_representation_price(cfg, st_symbol{"BTC"}, st_symbol{"ETH"}, "54276385120308340000"),
+                 unformat_str_to_representation_price(cfg, btc, eth, "54276385120308340000"));
+    }
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <loguru.hpp>
+#include "antara.worker.pool.hpp"
+
+namespace antara
+{
+    worker_pool::worker_pool(std::size_t nb_workers)
+    {
+        workers_.reserve(nb_workers);
+        for (std::size_t idx = 0; idx < std::max<std::size_t>(nb_workers, 1u); ++idx) {
+            workers_.emplace_back([this]() { this->work(); });
+        }
+    }
+
+    worker_pool::~worker_pool() noexcept
+    {
+        stop();
+    }
+
+    bool worker_pool::post(task current_task)
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            if (stopped_) {
+                return false;
+            }
+            tasks_.push_back(std::move(current_task));
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    void worker_pool::stop() noexcept
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        for (auto &&worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    std::size_t worker_pool::nb_pending() const
+    {
+        std::scoped_lock lock(mutex_);
+        return tasks_.size();
+    }
+
+    std::size_t worker_pool::nb_workers() const noexcept
+    {
+        return workers_.size();
+    }
+
+    void worker_pool::work()
+    {
+        while (true) {
+            task current_task;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this]() { return stopped_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                current_task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            try {
+                current_task();
+            }
+            catch (const std::exception &error) {
+                VLOG_F(loguru::Verbosity_ERROR, "worker task failed: %s", error.what());
+            }
+        }
+    }
+}
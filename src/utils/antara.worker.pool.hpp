@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace antara
+{
+    /**
+     * @brief Fixed set of threads running posted tasks in FIFO order, used to move blocking calls off the threads
+     *        that must stay responsive. stop() runs the tasks still queued before joining.
+     */
+    class worker_pool
+    {
+    public:
+        using task = std::function<void()>;
+
+        explicit worker_pool(std::size_t nb_workers);
+
+        ~worker_pool() noexcept;
+
+        worker_pool(const worker_pool &) = delete;
+
+        worker_pool &operator=(const worker_pool &) = delete;
+
+        //! returns false if the pool is stopped, the task is then not run.
+        bool post(task current_task);
+
+        void stop() noexcept;
+
+        [[nodiscard]] std::size_t nb_pending() const;
+
+        [[nodiscard]] std::size_t nb_workers() const noexcept;
+
+    private:
+        void work();
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<task> tasks_;
+        bool stopped_{false};
+        std::vector<std::thread> workers_;
+    };
+}
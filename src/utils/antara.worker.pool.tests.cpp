@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <atomic>
+#include <stdexcept>
+#include <doctest/doctest.h>
+#include "antara.worker.pool.hpp"
+
+namespace antara::mmbot::tests
+{
+    TEST_CASE ("worker pool runs every posted task before stopping")
+    {
+        std::atomic_size_t nb_done{0};
+        antara::worker_pool pool(4);
+        CHECK_EQ(4, pool.nb_workers());
+        for (int idx = 0; idx < 100; ++idx) {
+            CHECK(pool.post([&nb_done]() { ++nb_done; }));
+        }
+        pool.post([]() { throw std::runtime_error("a failing task doesn't kill its worker"); });
+        pool.stop();
+        CHECK_EQ(100, nb_done);
+        CHECK_FALSE(pool.post([&nb_done]() { ++nb_done; }));
+        CHECK_EQ(0, pool.nb_pending());
+    }
+}
@@ -0,0 +1,56 @@
+/******************************************************************************
+ * Copyright © 2013-2019 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include "utils/mmbot_strong_types.hpp"
+
+namespace
+{
+    using namespace antara;
+
+    void BM_st_price_times_st_spread(benchmark::State &state)
+    {
+        st_price price{1797920499999999ull};
+        st_spread spread{1.05};
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(price * spread);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void BM_st_price_multiply_rounding_down(benchmark::State &state)
+    {
+        st_price price{1797920499999999ull};
+        const auto bid_ratio = st_spread::one() - st_spread::from_string("0.0025");
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(multiply(price, bid_ratio, rounding::down));
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void BM_st_price_rescale(benchmark::State &state)
+    {
+        st_price price{absl::uint128(5427638512030834ull) * 10000};
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(rescale(price, 18, 8, rounding::half_up));
+            benchmark::ClobberMemory();
+        }
+    }
+}
+
+BENCHMARK(BM_st_price_times_st_spread);
+BENCHMARK(BM_st_price_multiply_rounding_down);
+BENCHMARK(BM_st_price_rescale);
@@ -14,17 +14,106 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <string>
 #include "mmbot_strong_types.hpp"
 #include <absl/numeric/int128.h>
 
 namespace antara
 {
+    st_price operator+(const st_price &price, const st_price &other)
+    {
+        if (price.value() > absl::Uint128Max() - other.value()) {
+            throw std::overflow_error("st_price: addition overflow");
+        }
+        return st_price{price.value() + other.value()};
+    }
+
+    st_price operator-(const st_price &price, const st_price &other)
+    {
+        if (price.value() < other.value()) {
+            throw std::underflow_error("st_price: negative price");
+        }
+        return st_price{price.value() - other.value()};
+    }
+
+    st_price multiply(const st_price &price, const st_spread &ratio, rounding mode)
+    {
+        if (ratio.raw() < 0) {
+            throw std::underflow_error("st_price: negative price");
+        }
+        const auto factor = static_cast<absl::uint128>(static_cast<std::uint64_t>(ratio.raw()));
+        if (factor != 0 && price.value() > absl::Uint128Max() / factor) {
+            throw std::overflow_error("st_price: multiplication overflow");
+        }
+        return st_price{details::divide_rounded<absl::uint128>(price.value() * factor, st_spread::scale, mode)};
+    }
+
+    st_price divide(const st_price &price, const st_spread &ratio, rounding mode)
+    {
+        if (ratio.raw() <= 0) {
+            throw std::domain_error("st_price: division by a ratio lower or equal to zero");
+        }
+        const absl::uint128 scale = st_spread::scale;
+        if (price.value() > absl::Uint128Max() / scale) {
+            throw std::overflow_error("st_price: division overflow");
+        }
+        const auto divisor = static_cast<absl::uint128>(static_cast<std::uint64_t>(ratio.raw()));
+        return st_price{details::divide_rounded<absl::uint128>(price.value() * scale, divisor, mode)};
+    }
+
     st_price operator*(const st_price &price, const st_spread &spread)
     {
-        // This means that spreads are accurate to 0.001 or 0.1%
-        // Necessary for the conversion from double to uint128
-        const int dp = 1000;
-        return st_price{(price.value() * absl::uint128(spread.value() * dp)) / dp};
+        return multiply(price, spread, rounding::half_up);
+    }
+
+    st_spread ratio_of(const st_price &price, const st_price &other, rounding mode)
+    {
+        if (other.value() == 0) {
+            throw std::domain_error("st_price: ratio to a zero price");
+        }
+        const absl::uint128 scale = st_spread::scale;
+        if (price.value() > absl::Uint128Max() / scale) {
+            throw std::overflow_error("st_price: ratio overflow");
+        }
+        auto raw = details::divide_rounded<absl::uint128>(price.value() * scale, other.value(), mode);
+        if (raw > static_cast<absl::uint128>(std::numeric_limits<st_spread::rep>::max())) {
+            throw std::overflow_error("st_price: ratio overflow");
+        }
+        return st_spread::from_raw(static_cast<st_spread::rep>(static_cast<std::uint64_t>(raw)));
+    }
+
+    st_price rescale(const st_price &price, std::size_t from_decimals, std::size_t to_decimals, rounding mode)
+    {
+        if (from_decimals >= to_decimals) {
+            return st_price{details::divide_rounded<absl::uint128>(price.value(),
+                                                                  pow10_u128(from_decimals - to_decimals), mode)};
+        }
+        const auto factor = pow10_u128(to_decimals - from_decimals);
+        if (price.value() > absl::Uint128Max() / factor) {
+            throw std::overflow_error("st_price: rescale overflow");
+        }
+        return st_price{price.value() * factor};
+    }
+
+    absl::uint128 pow10_u128(std::size_t exponent)
+    {
+        static const auto table = []() {
+            std::array<absl::uint128, 39> powers{};
+            absl::uint128 value = 1;
+            for (auto &&current : powers) {
+                current = value;
+                value *= 10;
+            }
+            return powers;
+        }();
+        //! the exponents come from the configured coin decimals.
+        if (exponent >= table.size()) {
+            throw std::out_of_range("pow10_u128: 10^" + std::to_string(exponent) + " doesn't fit in 128 bits");
+        }
+        return table[exponent];
     }
 
     bool operator==(const st_price &price, const st_price &other)
@@ -41,4 +130,19 @@ namespace antara
     {
         return price.value() < other.value();
     }
+
+    bool operator<=(const st_price &price, const st_price &other)
+    {
+        return !(other < price);
+    }
+
+    bool operator>(const st_price &price, const st_price &other)
+    {
+        return other < price;
+    }
+
+    bool operator>=(const st_price &price, const st_price &other)
+    {
+        return !(price < other);
+    }
 }
@@ -20,6 +20,7 @@
 #include <absl/numeric/int128.h>
 #include <st/type.hpp>
 #include <st/traits.hpp>
+#include "utils/antara.fixed.decimal.hpp"
 
 namespace antara
 {
@@ -44,23 +45,34 @@ namespace antara
             st::addable_with<char *>,
             st::addable_with<const char *>>;
 
-    using st_spread = st::type<
-            double,
-            struct spread_tag,
-            st::arithmetic,
-            st::addable_with<double>
-    >;
+    //! exact to 1e-6, i.e. 0.01 bps.
+    using st_spread = fixed_decimal<6>;
 
+    //! an integer amount of the smallest unit of the coin, see coin_scale_table for the number of decimals.
     using st_price = st::type<
             absl::uint128,
-            struct price_tag //,
-            // st::arithmetic
+            struct price_tag
     >;
 
+    //! the price arithmetic is checked: std::overflow_error above 2^128, std::underflow_error below 0.
+    st_price operator+(const st_price &price, const st_price &other);
+    st_price operator-(const st_price &price, const st_price &other);
+    st_price multiply(const st_price &price, const st_spread &ratio, rounding mode);
+    st_price divide(const st_price &price, const st_spread &ratio, rounding mode);
+    //! rounded half up.
     st_price operator*(const st_price &price, const st_spread &spread);
+    //! price / other as a ratio, e.g. the relative distance between two prices.
+    st_spread ratio_of(const st_price &price, const st_price &other, rounding mode);
+    //! convert a price between two numbers of decimals, e.g. from the coin decimals to the ones of another coin.
+    st_price rescale(const st_price &price, std::size_t from_decimals, std::size_t to_decimals, rounding mode);
+    //! 10^exponent, throws std::out_of_range if exponent is greater than 38.
+    absl::uint128 pow10_u128(std::size_t exponent);
     bool operator==(const st_price &price, const st_price &other);
     bool operator!=(const st_price &price, const st_price &other);
     bool operator<(const st_price &price, const st_price &other);
+    bool operator<=(const st_price &price, const st_price &other);
+    bool operator>(const st_price &price, const st_price &other);
+    bool operator>=(const st_price &price, const st_price &other);
 
     using st_order_id = std::string;
 
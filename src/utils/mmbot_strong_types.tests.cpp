@@ -14,6 +14,7 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <stdexcept>
 #include <doctest/doctest.h>
 
 #include <utils/mmbot_strong_types.hpp>
@@ -49,4 +50,49 @@ namespace antara::mmbot::tests
 
         CHECK_EQ(expected.value(), (price * spread).value());
     }
+
+    TEST_CASE ("st_price arithmetic is checked")
+    {
+        CHECK_EQ(st_price{30}, st_price{10} + st_price{20});
+        CHECK_EQ(st_price{10}, st_price{30} - st_price{20});
+        CHECK_THROWS_AS(st_price{10} - st_price{20}, std::underflow_error);
+        CHECK_THROWS_AS(st_price{absl::Uint128Max()} + st_price{1}, std::overflow_error);
+        CHECK_THROWS_AS(st_price{absl::Uint128Max()} * st_spread{2.0}, std::overflow_error);
+        CHECK(st_price{1} <= st_price{1});
+        CHECK(st_price{2} > st_price{1});
+    }
+
+    TEST_CASE ("st_price multiplication rounds with the given mode")
+    {
+        auto price = st_price{999};
+        auto spread = st_spread{0.0001};
+        CHECK_EQ(st_price{99}, multiply(price, spread * st_spread{1000.0}, rounding::down));
+        CHECK_EQ(st_price{100}, multiply(price, spread * st_spread{1000.0}, rounding::up));
+        CHECK_EQ(st_price{100}, price * st_spread{0.1});
+        CHECK_EQ(st_price{1000123000}, st_price{1000000000} * st_spread::from_string("1.000123"));
+        CHECK_EQ(st_price{1000001000}, st_price{1000000000} * st_spread::from_raw(1000001));
+        CHECK_EQ(st_price{1000}, divide(st_price{1100}, st_spread{1.1}, rounding::half_up));
+        CHECK_EQ(st_spread{1.1}, ratio_of(st_price{1100}, st_price{1000}, rounding::half_up));
+        CHECK_THROWS_AS(divide(st_price{1}, st_spread{}, rounding::down), std::domain_error);
+    }
+
+    TEST_CASE ("st_price can be rescaled between coin decimals")
+    {
+        auto eth_price = st_price{absl::uint128(5427638512030834ull) * 10000};
+        CHECK_EQ(st_price{5427638512}, rescale(eth_price, 18, 8, rounding::down));
+        CHECK_EQ(st_price{5427638513}, rescale(eth_price, 18, 8, rounding::up));
+        CHECK_EQ(st_price{absl::uint128(5427638512ull) * 10000000000ull},
+                 rescale(st_price{5427638512}, 8, 18, rounding::down));
+        CHECK_EQ(st_price{12}, rescale(st_price{12}, 8, 8, rounding::half_up));
+        CHECK_THROWS_AS(rescale(st_price{12}, 0, 39, rounding::down), std::out_of_range);
+        CHECK_THROWS_AS(rescale(st_price{12}, 40, 0, rounding::down), std::out_of_range);
+    }
+
+    TEST_CASE ("pow10_u128 covers the powers of ten of 128 bits")
+    {
+        CHECK_EQ(absl::uint128(1), pow10_u128(0));
+        CHECK_EQ(absl::uint128(100000000), pow10_u128(8));
+        CHECK_EQ(pow10_u128(37) * 10, pow10_u128(38));
+        CHECK_THROWS_AS(pow10_u128(39), std::out_of_range);
+    }
 }